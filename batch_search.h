@@ -0,0 +1,74 @@
+/* ************************************************************************
+> File Name:     batch_search.h
+> Description:   批量查找 - 多个 key 交错遍历 + 软件预取
+>                一组查找按轮次同步推进，每轮每个 key 只前进一步，
+>                并预取它下一步要访问的节点，使各个 key 的 cache miss 相互重叠
+ ************************************************************************/
+
+#ifndef BATCH_SEARCH_H
+#define BATCH_SEARCH_H
+
+#include <cstddef>
+
+// 同时推进的查找数量：太小无法掩盖内存延迟，太大会挤占 L1 和填充缓冲区
+static const int BATCH_SEARCH_GROUP = 16;
+
+/**
+ * @brief 批量 lower_bound：对每个 key 求第 0 层第一个 >= key 的节点
+ *
+ * 单个 key 的查找是一条串行依赖链（读节点 -> 得到下一个指针 -> 读下一个节点），
+ * 每一步都可能 cache miss。这里让一组 key 轮流各走一步，走完后立即
+ * __builtin_prefetch 该 key 下一步要比较的节点；等轮到它时数据通常已在缓存中。
+ *
+ * 只读遍历，调用方负责加锁/进入纪元临界区，并保证遍历期间 top_level 有效。
+ * forward[] 为原子指针（NodeOpt）时按隐式的 seq_cst 读取，与写者的 release 链接配对。
+ *
+ * @tparam NodeType 节点类型，需提供 forward[] 和 get_key_ref()
+ * @param header 头节点
+ * @param top_level 当前跳表最高层
+ * @param keys 待查找的 key 数组
+ * @param count key 数量（可以超过 BATCH_SEARCH_GROUP，内部按组处理）
+ * @param results 输出：每个 key 对应的 lower_bound 节点，不存在时为 nullptr
+ */
+template<typename NodeType, typename K>
+void batch_lower_bound(NodeType* header, int top_level, const K* keys, size_t count, NodeType** results) {
+    NodeType* current[BATCH_SEARCH_GROUP];
+    int level[BATCH_SEARCH_GROUP];
+
+    for (size_t base = 0; base < count; base += BATCH_SEARCH_GROUP) {
+        int group = (count - base < (size_t)BATCH_SEARCH_GROUP) ? (int)(count - base) : BATCH_SEARCH_GROUP;
+        for (int j = 0; j < group; j++) {
+            current[j] = header;
+            level[j] = top_level;
+        }
+
+        int pending = group;
+        while (pending > 0) {
+            for (int j = 0; j < group; j++) {
+                if (level[j] < 0) {
+                    continue;
+                }
+
+                NodeType* next = current[j]->forward[level[j]];
+                if (next != nullptr && next->get_key_ref() < keys[base + j]) {
+                    current[j] = next;
+                } else if (level[j] == 0) {
+                    results[base + j] = next;
+                    level[j] = -1;
+                    pending--;
+                    continue;
+                } else {
+                    level[j]--;
+                }
+
+                // 预取下一轮要比较的节点，本轮剩余 key 的访问期间完成加载
+                NodeType* peek = current[j]->forward[level[j]];
+                if (peek != nullptr) {
+                    __builtin_prefetch(peek);
+                }
+            }
+        }
+    }
+}
+
+#endif // BATCH_SEARCH_H
@@ -0,0 +1,347 @@
+/* ************************************************************************
+> File Name:     epoch_reclaim.h
+> Description:   基于纪元的内存回收（Epoch-Based Reclamation, EBR）
+>                读线程进入临界区时登记当前纪元，写线程摘除节点后
+>                将其放入本线程的待回收列表，待所有线程都离开旧纪元
+>                后再真正释放，避免无锁读路径上的 use-after-free
+ ************************************************************************/
+
+#ifndef EPOCH_RECLAIM_H
+#define EPOCH_RECLAIM_H
+
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include <thread>
+
+/**
+ * @brief 纪元回收管理器
+ *
+ * 经典三纪元方案：
+ * - 全局纪元 G 单调递增
+ * - 线程进入读临界区（pin）时记录 G，离开时清除
+ * - 在纪元 e 退休的对象，待全局纪元推进到 e + 2 后可安全释放
+ *   （推进要求所有活跃线程都已观察到当前纪元）
+ *
+ * 每个线程拥有独立的纪元记录和三个待回收桶，退休和回收都不加锁。
+ * 除每退休 RECLAIM_THRESHOLD 个对象回收一次外，持有待回收对象的线程每离开
+ * EXIT_COLLECT_INTERVAL 次临界区也尝试推进并回收，退休很少的线程不会把对象一直留到管理器析构。
+ *
+ * 在临界区内退休（如跳表在持有写锁时摘除节点）不会调用任何回收函数：
+ * 达到阈值时只做标记，需要复用的过期桶移到本线程的就绪列表，
+ * 推进纪元和回收都推迟到最外层守卫离开时进行。调用方在加锁前 pin，回收就不会发生在锁内。
+ */
+class EpochManager {
+public:
+    // 回收回调：ctx 为使用方上下文（如跳表、内存池），ptr 为待释放对象
+    typedef void (*ReclaimFunc)(void* ctx, void* ptr);
+
+    // 每个线程累计退休多少个对象后尝试推进纪元并回收
+    static const int RECLAIM_THRESHOLD = 64;
+
+    // 本线程有待回收对象时，每离开多少次临界区尝试推进纪元并回收
+    static const int EXIT_COLLECT_INTERVAL = 16;
+
+private:
+    static const uint64_t ACTIVE_FLAG = 1ULL << 63;
+    static const int BUCKET_COUNT = 3;
+
+    struct RetiredObject {
+        void* ptr;
+        ReclaimFunc reclaim;
+        void* ctx;
+    };
+
+    struct LimboBucket {
+        uint64_t epoch;
+        std::vector<RetiredObject> objects;
+    };
+
+    // 线程纪元记录，注册后由所属线程独占写入，随管理器一起销毁
+    struct alignas(64) ThreadRecord {
+        std::atomic<uint64_t> local_epoch;   // 最高位为活跃标记
+        int pin_depth;                       // 嵌套 pin 深度
+        int retire_since_reclaim;
+        int exit_since_collect;
+        bool collect_requested;              // 临界区内达到退休阈值，离开时回收
+        std::atomic<size_t> pending;         // 桶和就绪列表中的对象总数，只由所属线程写入，供其他线程统计
+        LimboBucket limbo[BUCKET_COUNT];
+        std::vector<RetiredObject> ready;    // 已过宽限期、等待离开临界区后回收的对象
+        std::thread::id owner;               // 所属线程
+        ThreadRecord* next;
+
+        ThreadRecord() : local_epoch(0), pin_depth(0), retire_since_reclaim(0), exit_since_collect(0),
+                         collect_requested(false), pending(0), owner(std::this_thread::get_id()), next(nullptr) {
+            for (int i = 0; i < BUCKET_COUNT; i++) {
+                limbo[i].epoch = 0;
+            }
+        }
+    };
+
+public:
+    /**
+     * @brief 读临界区守卫，析构时自动离开临界区
+     */
+    class Guard {
+    public:
+        explicit Guard(EpochManager* manager) : _manager(manager) {
+            _manager->enter();
+        }
+        ~Guard() {
+            if (_manager != nullptr) {
+                _manager->exit();
+            }
+        }
+        Guard(Guard&& other) : _manager(other._manager) {
+            other._manager = nullptr;
+        }
+
+    private:
+        EpochManager* _manager;
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+    };
+
+    EpochManager()
+        : _global_epoch(BUCKET_COUNT),
+          _records(nullptr),
+          _manager_id(next_manager_id()) {}
+
+    /**
+     * @brief 析构函数 - 此时不应再有并发访问，回收所有待释放对象
+     */
+    ~EpochManager() {
+        drain();
+        ThreadRecord* record = _records.load(std::memory_order_acquire);
+        while (record != nullptr) {
+            ThreadRecord* next = record->next;
+            delete record;
+            record = next;
+        }
+    }
+
+    /**
+     * @brief 进入读临界区，返回 RAII 守卫
+     */
+    Guard pin() {
+        return Guard(this);
+    }
+
+    /**
+     * @brief 退休一个已从数据结构中摘除的对象
+     * @param ptr 待释放对象
+     * @param reclaim 宽限期结束后调用的回收函数
+     * @param ctx 回收函数的上下文参数
+     */
+    void retire(void* ptr, ReclaimFunc reclaim, void* ctx) {
+        ThreadRecord* record = local_record();
+        uint64_t epoch = _global_epoch.load(std::memory_order_seq_cst);
+        LimboBucket& bucket = record->limbo[epoch % BUCKET_COUNT];
+
+        // 桶中残留的是 epoch - 3 及更早退休的对象，已过宽限期；临界区内只移入就绪列表
+        if (bucket.epoch != epoch) {
+            if (record->pin_depth > 0) {
+                defer_bucket(record, &bucket);
+            } else {
+                free_objects(record, &bucket.objects);
+            }
+            bucket.epoch = epoch;
+        }
+        bucket.objects.push_back(RetiredObject{ptr, reclaim, ctx});
+        record->pending.store(record->pending.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+        if (++record->retire_since_reclaim >= RECLAIM_THRESHOLD) {
+            record->retire_since_reclaim = 0;
+            if (record->pin_depth > 0) {
+                record->collect_requested = true;
+            } else {
+                try_advance();
+                collect(record);
+            }
+        }
+    }
+
+    /**
+     * @brief 退休一个通过 new 分配的对象，宽限期后 delete
+     */
+    template<typename T>
+    void retire(T* ptr) {
+        retire(ptr, &EpochManager::delete_object<T>, nullptr);
+    }
+
+    /**
+     * @brief 尝试推进全局纪元：所有活跃线程都已观察到当前纪元时才推进
+     * @return 是否推进成功
+     */
+    bool try_advance() {
+        uint64_t epoch = _global_epoch.load(std::memory_order_seq_cst);
+        for (ThreadRecord* record = _records.load(std::memory_order_acquire);
+             record != nullptr; record = record->next) {
+            uint64_t local = record->local_epoch.load(std::memory_order_seq_cst);
+            if ((local & ACTIVE_FLAG) && (local & ~ACTIVE_FLAG) != epoch) {
+                return false;
+            }
+        }
+        return _global_epoch.compare_exchange_strong(epoch, epoch + 1, std::memory_order_seq_cst);
+    }
+
+    /**
+     * @brief 立即回收所有待释放对象（仅在确认没有并发读者时调用，如析构、clear）
+     */
+    void drain() {
+        for (ThreadRecord* record = _records.load(std::memory_order_acquire);
+             record != nullptr; record = record->next) {
+            free_objects(record, &record->ready);
+            for (int i = 0; i < BUCKET_COUNT; i++) {
+                free_objects(record, &record->limbo[i].objects);
+            }
+        }
+    }
+
+    /**
+     * @brief 获取当前全局纪元
+     */
+    uint64_t get_global_epoch() const {
+        return _global_epoch.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 统计信息 - 当前待回收对象数量（非精确快照）
+     *
+     * 只读取各线程记录的原子计数，不访问其他线程正在修改的桶，可与退休、回收并发调用
+     */
+    size_t get_pending_count() const {
+        size_t count = 0;
+        for (ThreadRecord* record = _records.load(std::memory_order_acquire);
+             record != nullptr; record = record->next) {
+            count += record->pending.load(std::memory_order_relaxed);
+        }
+        return count;
+    }
+
+private:
+    std::atomic<uint64_t> _global_epoch;         // 全局纪元
+    std::atomic<ThreadRecord*> _records;         // 线程记录链表（只增不删）
+    uint64_t _manager_id;                        // 管理器唯一编号，用于线程局部缓存查找
+
+    template<typename T>
+    static void delete_object(void*, void* ptr) {
+        delete static_cast<T*>(ptr);
+    }
+
+    static uint64_t next_manager_id() {
+        static std::atomic<uint64_t> id(1);
+        return id.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void enter() {
+        ThreadRecord* record = local_record();
+        if (record->pin_depth++ == 0) {
+            // 发布本地纪元后复查全局纪元，确保推进者一定能看到本线程
+            uint64_t epoch = _global_epoch.load(std::memory_order_seq_cst);
+            while (true) {
+                record->local_epoch.store(epoch | ACTIVE_FLAG, std::memory_order_seq_cst);
+                uint64_t current = _global_epoch.load(std::memory_order_seq_cst);
+                if (current == epoch) {
+                    break;
+                }
+                epoch = current;
+            }
+        }
+    }
+
+    void exit() {
+        ThreadRecord* record = local_record();
+        if (--record->pin_depth == 0) {
+            record->local_epoch.store(0, std::memory_order_release);
+
+            // 临界区内推迟的回收在这里进行，此时已离开临界区，不会阻塞自己的推进；
+            // 退休不足 RECLAIM_THRESHOLD 个对象的线程也每 EXIT_COLLECT_INTERVAL 次在这里回收一次
+            free_objects(record, &record->ready);
+            if (record->collect_requested ||
+                (record->pending.load(std::memory_order_relaxed) > 0 &&
+                 ++record->exit_since_collect >= EXIT_COLLECT_INTERVAL)) {
+                record->collect_requested = false;
+                record->exit_since_collect = 0;
+                try_advance();
+                collect(record);
+            }
+        }
+    }
+
+    // 回收本线程中已过宽限期（退休纪元 + 2 <= 全局纪元）的桶
+    void collect(ThreadRecord* record) {
+        uint64_t epoch = _global_epoch.load(std::memory_order_seq_cst);
+        for (int i = 0; i < BUCKET_COUNT; i++) {
+            LimboBucket& bucket = record->limbo[i];
+            if (!bucket.objects.empty() && bucket.epoch + 2 <= epoch) {
+                free_objects(record, &bucket.objects);
+            }
+        }
+    }
+
+    // 把过期桶中的对象移入就绪列表（仍计入 pending），桶腾出给当前纪元使用
+    static void defer_bucket(ThreadRecord* record, LimboBucket* bucket) {
+        if (record->ready.empty()) {
+            record->ready.swap(bucket->objects);
+        } else {
+            record->ready.insert(record->ready.end(), bucket->objects.begin(), bucket->objects.end());
+            bucket->objects.clear();
+        }
+    }
+
+    static void free_objects(ThreadRecord* record, std::vector<RetiredObject>* objects) {
+        if (objects->empty()) {
+            return;
+        }
+        for (auto& object : *objects) {
+            object.reclaim(object.ctx, object.ptr);
+        }
+        record->pending.store(record->pending.load(std::memory_order_relaxed) - objects->size(),
+                              std::memory_order_relaxed);
+        objects->clear();
+    }
+
+    // 查找（必要时注册）当前线程在本管理器中的记录
+    ThreadRecord* local_record() {
+        struct CacheEntry {
+            uint64_t manager_id;
+            ThreadRecord* record;
+        };
+        // 按编号直接映射：编号连续分配，同时存活的管理器（如各分片各自的纪元回收）不超过 CACHE_SIZE 个时互不挤占
+        static const int CACHE_SIZE = 64;
+        static thread_local CacheEntry cache[CACHE_SIZE] = {};
+
+        CacheEntry& entry = cache[_manager_id % CACHE_SIZE];
+        if (entry.manager_id == _manager_id) {
+            return entry.record;
+        }
+
+        // 缓存未命中：先在已注册记录中查找（缓存条目可能已被挤出），找不到再注册
+        std::thread::id self = std::this_thread::get_id();
+        ThreadRecord* record = nullptr;
+        for (ThreadRecord* r = _records.load(std::memory_order_acquire); r != nullptr; r = r->next) {
+            if (r->owner == self) {
+                record = r;
+                break;
+            }
+        }
+        if (record == nullptr) {
+            record = new ThreadRecord();
+            ThreadRecord* head = _records.load(std::memory_order_acquire);
+            do {
+                record->next = head;
+            } while (!_records.compare_exchange_weak(head, record, std::memory_order_acq_rel));
+        }
+
+        entry = CacheEntry{_manager_id, record};
+        return record;
+    }
+
+    // 禁止拷贝和赋值
+    EpochManager(const EpochManager&) = delete;
+    EpochManager& operator=(const EpochManager&) = delete;
+};
+
+#endif // EPOCH_RECLAIM_H
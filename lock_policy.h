@@ -0,0 +1,177 @@
+/* ************************************************************************
+> File Name:     lock_policy.h
+> Description:   锁策略 - 作为跳表的模板参数在编译期选择加锁方式
+>                1. NullLock        - 空实现，单线程独占的实例不付任何加锁开销
+>                2. SpinLock        - TTAS 自旋锁，临界区极短时避免线程挂起
+>                3. TicketLock      - 排号自旋锁，按到达顺序获得锁，不会饿死
+>                4. MutexLock       - std::mutex（默认）
+>                5. SharedMutexLock - std::shared_mutex，读操作之间可以并行
+ ************************************************************************/
+
+#ifndef LOCK_POLICY_H
+#define LOCK_POLICY_H
+
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief 锁策略接口
+ *
+ * 每个策略提供 lock / unlock / try_lock（写锁）和 lock_shared / unlock_shared（读锁），
+ * 可直接用于 std::lock_guard 和 std::shared_lock。
+ * 只有 SharedMutexLock 的读锁是真正共享的，其余策略的读锁与写锁相同。
+ */
+
+// 自旋等待中的 CPU 提示，降低忙等对超线程兄弟核和功耗的影响
+inline void lock_cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#else
+    std::this_thread::yield();
+#endif
+}
+
+// 自旋 LOCK_SPIN_LIMIT 次后改为让出 CPU：线程数超过核数时，
+// 持锁（或下一个被叫号的）线程可能正等待调度，继续空转只会拖满整个时间片
+const int LOCK_SPIN_LIMIT = 64;
+
+inline void lock_spin_wait(int& spins) {
+    if (spins < LOCK_SPIN_LIMIT) {
+        spins++;
+        lock_cpu_relax();
+    } else {
+        std::this_thread::yield();
+    }
+}
+
+/**
+ * @brief 空锁：所有操作为空，用于只在单个线程中使用的实例
+ */
+struct NullLock {
+    void lock() {}
+    void unlock() {}
+    bool try_lock() { return true; }
+    void lock_shared() {}
+    void unlock_shared() {}
+};
+
+/**
+ * @brief TTAS 自旋锁
+ *
+ * 先以只读方式等待锁空闲（test），再尝试交换（test-and-set），
+ * 等待期间只读本地缓存行，不产生缓存一致性流量。独占一个缓存行，避免伪共享。
+ */
+class alignas(64) SpinLock {
+public:
+    SpinLock() : _locked(false) {}
+
+    void lock() {
+        int spins = 0;
+        while (true) {
+            if (!_locked.exchange(true, std::memory_order_acquire)) {
+                return;
+            }
+            while (_locked.load(std::memory_order_relaxed)) {
+                lock_spin_wait(spins);
+            }
+        }
+    }
+
+    void unlock() {
+        _locked.store(false, std::memory_order_release);
+    }
+
+    bool try_lock() {
+        return !_locked.load(std::memory_order_relaxed) &&
+               !_locked.exchange(true, std::memory_order_acquire);
+    }
+
+    void lock_shared() { lock(); }
+    void unlock_shared() { unlock(); }
+
+private:
+    std::atomic<bool> _locked;
+
+    SpinLock(const SpinLock&) = delete;
+    SpinLock& operator=(const SpinLock&) = delete;
+};
+
+/**
+ * @brief 排号自旋锁
+ *
+ * 每个线程取一个号（_next），等待叫号（_serving）等于自己的号。
+ * 先到先得，竞争激烈时不会出现某个线程长期抢不到锁。
+ */
+class alignas(64) TicketLock {
+public:
+    TicketLock() : _next(0), _serving(0) {}
+
+    void lock() {
+        uint32_t ticket = _next.fetch_add(1, std::memory_order_relaxed);
+        int spins = 0;
+        while (_serving.load(std::memory_order_acquire) != ticket) {
+            lock_spin_wait(spins);
+        }
+    }
+
+    void unlock() {
+        // 只有持锁线程修改 _serving，读-加-写无需原子 RMW
+        _serving.store(_serving.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    bool try_lock() {
+        uint32_t serving = _serving.load(std::memory_order_acquire);
+        uint32_t expected = serving;
+        return _next.compare_exchange_strong(expected, serving + 1, std::memory_order_acquire,
+                                             std::memory_order_relaxed);
+    }
+
+    void lock_shared() { lock(); }
+    void unlock_shared() { unlock(); }
+
+private:
+    std::atomic<uint32_t> _next;
+    std::atomic<uint32_t> _serving;
+
+    TicketLock(const TicketLock&) = delete;
+    TicketLock& operator=(const TicketLock&) = delete;
+};
+
+/**
+ * @brief 互斥锁：std::mutex，读写都是独占
+ */
+class MutexLock {
+public:
+    void lock() { _mutex.lock(); }
+    void unlock() { _mutex.unlock(); }
+    bool try_lock() { return _mutex.try_lock(); }
+    void lock_shared() { _mutex.lock(); }
+    void unlock_shared() { _mutex.unlock(); }
+
+private:
+    std::mutex _mutex;
+};
+
+/**
+ * @brief 读写锁：std::shared_mutex，读锁共享、写锁独占
+ */
+class SharedMutexLock {
+public:
+    void lock() { _mutex.lock(); }
+    void unlock() { _mutex.unlock(); }
+    bool try_lock() { return _mutex.try_lock(); }
+    void lock_shared() { _mutex.lock_shared(); }
+    void unlock_shared() { _mutex.unlock_shared(); }
+
+private:
+    std::shared_mutex _mutex;
+};
+
+#endif // LOCK_POLICY_H
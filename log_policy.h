@@ -0,0 +1,210 @@
+/* ************************************************************************
+> File Name:     log_policy.h
+> Description:   日志策略 - 作为跳表的模板参数在编译期选择日志实现
+>                1. NullLogger     - 空实现，关键路径上不生成任何日志指令
+>                2. StdoutLogger   - 直接写 std::cout（默认，与原有行为一致）
+>                3. BufferedLogger - 写入内存缓冲区，满后批量输出
+>                4. AsyncLogger    - 写入环形缓冲区，由后台线程输出
+ ************************************************************************/
+
+#ifndef LOG_POLICY_H
+#define LOG_POLICY_H
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <cstddef>
+
+/**
+ * @brief 日志策略接口
+ *
+ * 每个策略提供：
+ * - static constexpr bool enabled：是否输出日志
+ * - template<typename... Args> void log(const Args&... args)：依次输出 args 并换行
+ * - void flush()：把尚未输出的日志写出
+ *
+ * 跳表以 LogPolicy _logger 成员持有策略对象，通过 logger() 访问。
+ */
+
+/**
+ * @brief 空日志：log 为空的内联函数，编译后调用点不留下任何指令
+ */
+struct NullLogger {
+    static constexpr bool enabled = false;
+
+    template<typename... Args>
+    void log(const Args&...) {}
+
+    void flush() {}
+};
+
+/**
+ * @brief 标准输出日志：每条日志直接写 std::cout 并 endl
+ */
+struct StdoutLogger {
+    static constexpr bool enabled = true;
+
+    template<typename... Args>
+    void log(const Args&... args) {
+        (std::cout << ... << args) << std::endl;
+    }
+
+    void flush() {
+        std::cout.flush();
+    }
+};
+
+/**
+ * @brief 缓冲日志：格式化到内存缓冲区，累计超过 capacity 字节后一次性写出
+ *
+ * 仍在调用线程中格式化，但省去每条日志的 endl 刷新和系统调用。
+ * 多线程写入由内部互斥锁保护，析构时写出剩余内容。
+ */
+class BufferedLogger {
+public:
+    static constexpr bool enabled = true;
+
+    explicit BufferedLogger(size_t capacity = 64 * 1024, std::ostream& sink = std::cout)
+        : _capacity(capacity), _sink(sink) {}
+
+    ~BufferedLogger() {
+        flush();
+    }
+
+    template<typename... Args>
+    void log(const Args&... args) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        (_buffer << ... << args) << '\n';
+        if ((size_t)_buffer.tellp() >= _capacity) {
+            flush_locked();
+        }
+    }
+
+    void flush() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        flush_locked();
+    }
+
+private:
+    void flush_locked() {
+        _sink << _buffer.str();
+        _sink.flush();
+        _buffer.str("");
+        _buffer.clear();
+    }
+
+    size_t _capacity;
+    std::ostream& _sink;
+    std::ostringstream _buffer;
+    std::mutex _mutex;
+
+    BufferedLogger(const BufferedLogger&) = delete;
+    BufferedLogger& operator=(const BufferedLogger&) = delete;
+};
+
+/**
+ * @brief 异步日志：调用线程格式化后放入定长环形缓冲区，后台线程负责输出
+ *
+ * 调用线程只做格式化和一次短临界区内的入队，不做 I/O。
+ * 环形缓冲区满时丢弃新日志并计数（不阻塞跳表的写路径），dropped() 返回丢弃条数。
+ */
+class AsyncLogger {
+public:
+    static constexpr bool enabled = true;
+
+    explicit AsyncLogger(size_t capacity = 4096, std::ostream& sink = std::cout)
+        : _slots(capacity), _head(0), _tail(0), _written(0), _dropped(0), _stop(false), _sink(sink) {
+        _worker = std::thread(&AsyncLogger::run, this);
+    }
+
+    ~AsyncLogger() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _not_empty.notify_one();
+        _worker.join();
+    }
+
+    template<typename... Args>
+    void log(const Args&... args) {
+        // 每个线程复用同一个格式化流，避免每条日志构造 ostringstream
+        thread_local std::ostringstream line;
+        line.str("");
+        line.clear();
+        (line << ... << args) << '\n';
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_tail - _head == _slots.size()) {
+            _dropped++;
+            return;
+        }
+        bool was_empty = (_head == _tail);
+        _slots[_tail % _slots.size()] = line.str();
+        _tail++;
+        // 后台线程只会在队列为空时等待，非空时无需唤醒
+        if (was_empty) {
+            _not_empty.notify_one();
+        }
+    }
+
+    // 等待后台线程输出完当前已入队的日志
+    void flush() {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _drained.wait(lock, [this]() { return _written == _tail; });
+        _sink.flush();
+    }
+
+    size_t dropped() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _dropped;
+    }
+
+private:
+    // 后台线程：每次取出当前全部日志，在锁外写出
+    void run() {
+        std::vector<std::string> batch;
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (true) {
+            _not_empty.wait(lock, [this]() { return _stop || _head != _tail; });
+            if (_head == _tail && _stop) {
+                break;
+            }
+            while (_head != _tail) {
+                batch.push_back(std::move(_slots[_head % _slots.size()]));
+                _head++;
+            }
+
+            lock.unlock();
+            for (const auto& line : batch) {
+                _sink << line;
+            }
+            _sink.flush();
+            batch.clear();
+            lock.lock();
+            _written = _head;
+            _drained.notify_all();
+        }
+    }
+
+    std::vector<std::string> _slots;   // 环形缓冲区
+    size_t _head;                      // 下一条待输出的位置
+    size_t _tail;                      // 下一条写入的位置
+    size_t _written;                   // 已由后台线程写出的位置
+    size_t _dropped;                   // 缓冲区满时丢弃的条数
+    bool _stop;
+    std::ostream& _sink;
+    std::mutex _mutex;
+    std::condition_variable _not_empty;
+    std::condition_variable _drained;
+    std::thread _worker;
+
+    AsyncLogger(const AsyncLogger&) = delete;
+    AsyncLogger& operator=(const AsyncLogger&) = delete;
+};
+
+#endif // LOG_POLICY_H
@@ -3,6 +3,11 @@
 > Description:   内存池实现 - 减少频繁new/delete操作
 >                通过对象复用减少内存分配开销和内存碎片
 >                提升高并发场景下的性能
+>                每个线程持有按层级分类的本地弹匣，快速路径不加锁，
+>                弹匣空/满时与共享空闲列表批量交换
+>                新节点从 slab 中切分，析构时整块归还
+>                空闲内存超过预算时把完全空闲的 slab 归还系统，部分使用的 slab 归还其中的空闲页面
+>                超出预算时唤醒后台收缩线程，也可显式调用 trim() 收缩，归还节点的线程从不自己收缩
  ************************************************************************/
 
 #ifndef MEMORY_POOL_H
@@ -10,13 +15,51 @@
 
 #include <vector>
 #include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <limits>
+#include <atomic>
+#include <thread>
 #include <cstring>
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <type_traits>
+#include "sharded_counter.h"
+#include "slab_arena.h"
 
 /**
  * @brief 跳表节点内存池
  * 
  * 管理跳表节点的内存分配和回收
  * 通过对象池模式减少频繁的new/delete操作
+ * 节点与 forward 塔为单次分配，空闲节点按层级分类保存，复用时大小恰好匹配
+ *
+ * 两级结构：
+ * - 线程弹匣（magazine）：每个线程每个层级一个小栈，最多 magazine_size 个节点，
+ *   分配和归还先走本线程弹匣，不加锁
+ * - 共享空闲列表：弹匣为空时在 _pool_mutex 下一次取回 magazine_size / 2 个节点，
+ *   弹匣满时一次归还一半，加锁次数约为操作次数的 2 / magazine_size
+ * 弹匣由内存池持有并随内存池销毁，线程退出后其弹匣中的节点留到内存池析构时释放
+ * （同一线程 id 被复用时新线程会接管该弹匣）。magazine_size 为 0 时不使用弹匣。
+ *
+ * 没有可复用节点时从 SlabArena 切分新节点，节点内存不单独释放：
+ * 回收的节点按层级复用，大小恰好匹配；内存池析构时先析构各节点的 key/value，再整块释放 slab。
+ * 因此内存池分配的节点只能用 destroy(node) 析构，不能用 NodeOpt::destroy。
+ *
+ * 保留内存预算（set_memory_budget）限制共享空闲列表中节点的总字节数。
+ * 每个 slab 头部记录其在共享空闲列表中的节点数，节点进出共享空闲列表时顺带维护，
+ * 节点全部空闲的 slab 在变为全空闲的那一刻登记为候选，不需要扫描。
+ * trim() 超出预算时：
+ * 1. 在 _pool_mutex 下只交换出整个空闲列表和候选列表（O(层数)），扫描都在锁外进行
+ * 2. 候选 slab 整块归还系统，直到回到预算以内
+ * 3. 仍超出时按地址排序剩余空闲节点，把部分使用的 slab 中被空闲节点完全覆盖的页面
+ *    madvise(MADV_DONTNEED) 交还系统；覆盖这些页面的节点析构后转入冷列表，复用时重新构造
+ * 4. 重新加锁，把剩余节点放回空闲列表
+ * 缓存在线程弹匣中的节点不参与收缩。
+ * 共享空闲列表比上次收缩后多出一个 slab 的字节数且超出预算时，归还节点的线程只发出收缩请求并唤醒
+ * 后台收缩线程，自己从不收缩（归还可能发生在调用方的锁内）。没有后台线程时请求保留到
+ * start_background_trim 启动后立即处理，或由显式 trim() 收缩；后台线程另按 interval 定期收缩。
  * 
  * @tparam K 键的类型
  * @tparam V 值的类型
@@ -24,29 +67,59 @@
 template<typename K, typename V>
 class NodeOpt;  // 前向声明
 
+/**
+ * @brief 单个线程弹匣的统计
+ */
+struct MagazineStats {
+    std::thread::id owner;          // 所属线程
+    uint64_t hits;                  // 分配时本线程弹匣非空、未加锁的次数
+    uint64_t misses;                // 分配时弹匣为空、需访问共享空闲列表的次数
+    size_t cached;                  // 弹匣中当前缓存的节点数
+};
+
 template<typename K, typename V>
 class NodeMemoryPool {
 public:
+    // 每个线程每个层级默认最多缓存的节点数
+    static const int DEFAULT_MAGAZINE_SIZE = 32;
+
+    // deallocate_chain 每次加锁最多归还的节点数
+    static const size_t CHAIN_BATCH = 256;
+
     /**
      * @brief 构造函数
      * @param initial_capacity 初始容量（预分配节点数量）
+     * @param magazine_size 每个线程每个层级最多缓存的节点数，0 表示不使用线程弹匣
+     * @param huge_pages slab 是否使用透明大页（mmap + MADV_HUGEPAGE）
      */
-    explicit NodeMemoryPool(int initial_capacity = 100) 
-        : _allocated_count(0), _reused_count(0) {
-        _free_list.reserve(initial_capacity);
+    explicit NodeMemoryPool(int initial_capacity = 100, int magazine_size = DEFAULT_MAGAZINE_SIZE,
+                            bool huge_pages = false) 
+        : _arena(SlabArena::DEFAULT_SLAB_SIZE, huge_pages),
+          _cold_count(0),
+          _initial_capacity(initial_capacity),
+          _magazine_size(magazine_size),
+          _magazines(nullptr),
+          _pool_id(next_pool_id()),
+          _shared_free_bytes(0),
+          _memory_budget(std::numeric_limits<size_t>::max()),
+          _released_bytes(0),
+          _trim_floor(0),
+          _trim_stop(false),
+          _trim_requested(false) {
     }
     
     /**
-     * @brief 析构函数 - 释放所有缓存的节点
+     * @brief 析构函数 - 析构所有缓存的节点，slab 随 _arena 整块释放
      */
     ~NodeMemoryPool() {
-        std::lock_guard<std::mutex> lock(_pool_mutex);
-        for (auto* node : _free_list) {
-            // 真正释放内存
-            delete[] node->forward;
-            delete node;
+        stop_background_trim();
+        clear();
+        Magazine* magazine = _magazines.load(std::memory_order_acquire);
+        while (magazine != nullptr) {
+            Magazine* next = magazine->next;
+            delete magazine;
+            magazine = next;
         }
-        _free_list.clear();
     }
     
     /**
@@ -57,22 +130,34 @@ public:
      * @return 分配的节点指针
      */
     NodeOpt<K, V>* allocate(const K& key, const V& value, int level) {
-        std::lock_guard<std::mutex> lock(_pool_mutex);
-        
-        NodeOpt<K, V>* node = nullptr;
+        return emplace(level, key, value);
+    }
+
+    /**
+     * @brief 从内存池分配一个节点，key 与 value 的构造参数按值类别转发
+     * @param level 节点层级
+     * @param key 键
+     * @param args V 的构造参数
+     * @return 分配的节点指针
+     */
+    template<typename KArg, typename... Args>
+    NodeOpt<K, V>* emplace(int level, KArg&& key, Args&&... args) {
+        NodeOpt<K, V>* node = (_magazine_size > 0) ? take_from_magazine(level) : take_from_shared(level);
         
-        // 尝试从空闲列表中获取可复用的节点
-        if (!_free_list.empty()) {
-            node = _free_list.back();
-            _free_list.pop_back();
-            
-            // 重新初始化节点
-            reinitialize_node(node, key, value, level);
-            _reused_count++;
+        void* cold = nullptr;
+        if (node != nullptr) {
+            // 重新初始化节点（在锁外进行，value 的构造不占用共享空闲列表）
+            reinitialize_node(node, level, std::forward<KArg>(key), std::forward<Args>(args)...);
+            _reused_count.increment();
+        } else if ((cold = take_cold(level)) != nullptr) {
+            // 冷节点的页面已交还系统、key/value 已析构，在原地址重新构造
+            node = NodeOpt<K, V>::construct(cold, level, std::forward<KArg>(key), std::forward<Args>(args)...);
+            _reused_count.increment();
         } else {
-            // 空闲列表为空，创建新节点
-            node = new NodeOpt<K, V>(key, value, level);
-            _allocated_count++;
+            // 没有可复用的节点，从 slab 切分新节点
+            void* memory = _arena.allocate(NodeOpt<K, V>::allocation_size(level));
+            node = NodeOpt<K, V>::construct(memory, level, std::forward<KArg>(key), std::forward<Args>(args)...);
+            _allocated_count.increment();
         }
         
         return node;
@@ -87,74 +172,679 @@ public:
             return;
         }
         
-        std::lock_guard<std::mutex> lock(_pool_mutex);
+        int level = node->node_level;
+        if (_magazine_size == 0) {
+            bool over_budget;
+            {
+                std::lock_guard<std::mutex> lock(_pool_mutex);
+                shared_list(level).push_back(node);
+                _shared_free_bytes += node_bytes(level);
+                mark_free(node);
+                over_budget = should_trim();
+            }
+            if (over_budget) {
+                request_trim();
+            }
+            return;
+        }
         
-        // 将节点放回空闲列表，而不是直接delete
-        // 注意：不释放forward数组，保留以便复用
-        _free_list.push_back(node);
+        // 先放回本线程弹匣，弹匣满时把一半归还共享空闲列表
+        Magazine* magazine = local_magazine();
+        std::vector<NodeOpt<K, V>*>& stack = magazine->stack(level);
+        bool over_budget = false;
+        if ((int)stack.size() >= _magazine_size) {
+            size_t keep = stack.size() - transfer_batch();
+            {
+                std::lock_guard<std::mutex> lock(_pool_mutex);
+                std::vector<NodeOpt<K, V>*>& free_list = shared_list(level);
+                free_list.insert(free_list.end(), stack.begin() + keep, stack.end());
+                _shared_free_bytes += (stack.size() - keep) * node_bytes(level);
+                for (size_t i = keep; i < stack.size(); i++) {
+                    mark_free(stack[i]);
+                }
+                over_budget = should_trim();
+            }
+            magazine->add_cached(-(int64_t)(stack.size() - keep), level);
+            stack.resize(keep);
+        }
+        stack.push_back(node);
+        magazine->add_cached(1, level);
+        if (over_budget) {
+            request_trim();
+        }
     }
     
+    /**
+     * @brief 批量归还沿第 0 层相连的 count 个节点（如范围删除摘下的一段）
+     *
+     * 只读取 first 起 count - 1 个 forward[0]，不要求链表以空指针结尾。
+     * 直接放入共享空闲列表，不经过本线程弹匣；每加锁一次最多放入 CHAIN_BATCH 个，
+     * 归还百万级的一段时其他线程的弹匣补充和溢出不会被长时间阻塞。
+     */
+    void deallocate_chain(NodeOpt<K, V>* first, size_t count) {
+        bool over_budget = false;
+        NodeOpt<K, V>* node = first;
+        while (count > 0) {
+            size_t batch = count < CHAIN_BATCH ? count : CHAIN_BATCH;
+            std::lock_guard<std::mutex> lock(_pool_mutex);
+            for (size_t i = 0; i < batch; i++) {
+                // 先读后继再放入空闲列表：解锁后节点可能被其他线程取走并重置
+                NodeOpt<K, V>* next = node->forward[0].load(std::memory_order_relaxed);
+                shared_list(node->node_level).push_back(node);
+                _shared_free_bytes += node_bytes(node->node_level);
+                mark_free(node);
+                node = next;
+            }
+            over_budget = should_trim() || over_budget;
+            count -= batch;
+        }
+        if (over_budget) {
+            request_trim();
+        }
+    }
+
     /**
      * @brief 获取统计信息 - 总分配次数
      */
     int get_allocated_count() const {
-        return _allocated_count;
+        return (int)_allocated_count.load();
     }
     
     /**
      * @brief 获取统计信息 - 复用次数
      */
     int get_reused_count() const {
-        return _reused_count;
+        return (int)_reused_count.load();
     }
     
     /**
-     * @brief 获取当前空闲列表大小
+     * @brief 获取当前空闲节点数（共享空闲列表 + 各线程弹匣）
      */
     size_t get_free_list_size() const {
+        size_t total = 0;
+        {
+            std::lock_guard<std::mutex> lock(_pool_mutex);
+            for (const auto& free_list : _free_lists) {
+                total += free_list.size();
+            }
+        }
+        for (Magazine* m = _magazines.load(std::memory_order_acquire); m != nullptr; m = m->next) {
+            total += m->cached.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    /**
+     * @brief 空闲节点占用的字节数（共享空闲列表 + 各线程弹匣，非精确快照）
+     */
+    size_t get_free_bytes() const {
+        size_t total;
+        {
+            std::lock_guard<std::mutex> lock(_pool_mutex);
+            total = _shared_free_bytes;
+        }
+        for (Magazine* m = _magazines.load(std::memory_order_acquire); m != nullptr; m = m->next) {
+            total += m->cached_bytes.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    /**
+     * @brief 设置共享空闲列表的保留内存预算（字节），默认不限
+     */
+    void set_memory_budget(size_t bytes) {
+        std::lock_guard<std::mutex> lock(_pool_mutex);
+        _memory_budget = bytes;
+    }
+
+    size_t get_memory_budget() const {
+        std::lock_guard<std::mutex> lock(_pool_mutex);
+        return _memory_budget;
+    }
+
+    /**
+     * @brief 累计通过 trim() 归还系统的字节数（整块 slab + 页面）
+     */
+    size_t get_released_bytes() const {
         std::lock_guard<std::mutex> lock(_pool_mutex);
-        return _free_list.size();
+        return _released_bytes;
+    }
+
+    /**
+     * @brief 收缩：共享空闲列表超出预算时，归还全部空闲的 slab 和部分使用的 slab 中的空闲页面
+     * @return 本次归还系统的字节数（整块 slab + 页面）
+     *
+     * 可与分配、归还并发调用；_pool_mutex 只在交换列表时短暂持有，扫描期间弹匣补充和溢出不受影响
+     * （补充时共享空闲列表暂时为空，会从 slab 切分新节点）。多个 trim 串行执行。
+     */
+    size_t trim() {
+        std::lock_guard<std::mutex> exclusive(_trim_exclusive);
+        return trim_locked();
+    }
+
+    /**
+     * @brief 启动后台收缩线程，每隔 interval 调用一次 trim()，超出预算时也会被归还节点的线程提前唤醒
+     */
+    void start_background_trim(std::chrono::milliseconds interval) {
+        stop_background_trim();
+        _trim_stop = false;
+        _trim_thread = std::thread([this, interval]() {
+            std::unique_lock<std::mutex> lock(_trim_mutex);
+            while (true) {
+                _trim_cv.wait_for(lock, interval, [this]() { return _trim_stop || _trim_requested; });
+                if (_trim_stop) {
+                    break;
+                }
+                _trim_requested = false;
+                lock.unlock();
+                trim();
+                lock.lock();
+            }
+        });
+    }
+
+    /**
+     * @brief 停止后台收缩线程（未启动时为空操作）
+     */
+    void stop_background_trim() {
+        if (!_trim_thread.joinable()) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(_trim_mutex);
+            _trim_stop = true;
+        }
+        _trim_cv.notify_one();
+        _trim_thread.join();
+    }
+
+    /**
+     * @brief 获取每个线程弹匣的统计（非精确快照），用于调整 magazine_size
+     */
+    std::vector<MagazineStats> get_magazine_stats() const {
+        std::vector<MagazineStats> stats;
+        for (Magazine* m = _magazines.load(std::memory_order_acquire); m != nullptr; m = m->next) {
+            stats.push_back(MagazineStats{m->owner, m->hits.load(std::memory_order_relaxed),
+                                          m->misses.load(std::memory_order_relaxed),
+                                          (size_t)m->cached.load(std::memory_order_relaxed)});
+        }
+        return stats;
+    }
+
+    /**
+     * @brief 每个线程每个层级最多缓存的节点数
+     */
+    int get_magazine_size() const {
+        return _magazine_size;
+    }
+    
+    /**
+     * @brief 析构一个由本内存池分配、不再归还的节点（如跳表析构时的存活节点）
+     *
+     * 只析构 key/value，内存随 slab 整块释放
+     */
+    void destroy(NodeOpt<K, V>* node) {
+        NodeOpt<K, V>::destruct(node);
+    }
+
+    /**
+     * @brief 获取 slab 分配器，用于查看申请的 slab 数量和字节数
+     */
+    const SlabArena& get_arena() const {
+        return _arena;
     }
     
     /**
-     * @brief 清空内存池（释放所有缓存节点）
+     * @brief 清空内存池（析构所有缓存节点，包括各线程弹匣）
+     *
+     * 节点内存留在 slab 中，内存池析构时整块释放。
+     * 弹匣由各线程无锁访问，调用时不能有其他线程在使用内存池（如析构时）
      */
     void clear() {
+        // key/value 无需析构时不逐个访问节点，只清空列表
+        const bool destruct_nodes = !(std::is_trivially_destructible<K>::value &&
+                                      std::is_trivially_destructible<V>::value);
         std::lock_guard<std::mutex> lock(_pool_mutex);
-        for (auto* node : _free_list) {
-            delete[] node->forward;
-            delete node;
+        for (auto& free_list : _free_lists) {
+            if (destruct_nodes) {
+                for (auto* node : free_list) {
+                    NodeOpt<K, V>::destruct(node);
+                }
+            }
+            free_list.clear();
+        }
+        // 冷节点的 key/value 在转入冷列表时已析构
+        for (auto& cold_list : _cold_lists) {
+            cold_list.clear();
+        }
+        _cold_count.store(0, std::memory_order_relaxed);
+        _empty_slabs.clear();
+        _shared_free_bytes = 0;
+        for (Magazine* m = _magazines.load(std::memory_order_acquire); m != nullptr; m = m->next) {
+            for (auto& stack : m->stacks) {
+                if (destruct_nodes) {
+                    for (auto* node : stack) {
+                        NodeOpt<K, V>::destruct(node);
+                    }
+                }
+                stack.clear();
+            }
+            m->cached.store(0, std::memory_order_relaxed);
+            m->cached_bytes.store(0, std::memory_order_relaxed);
         }
-        _free_list.clear();
     }
     
 private:
-    std::vector<NodeOpt<K, V>*> _free_list;      // 空闲节点列表
-    mutable std::mutex _pool_mutex;              // 保护内存池的互斥锁
-    int _allocated_count;                         // 总分配次数统计
-    int _reused_count;                            // 复用次数统计
+    /**
+     * @brief 线程弹匣：按层级分类的本地节点栈，注册后由所属线程独占访问
+     */
+    struct alignas(64) Magazine {
+        std::vector<std::vector<NodeOpt<K, V>*>> stacks;   // 按层级分类的本地栈
+        std::atomic<uint64_t> hits;                      // 以下三项只由所属线程写入
+        std::atomic<uint64_t> misses;
+        std::atomic<int64_t> cached;
+        std::atomic<int64_t> cached_bytes;
+        std::thread::id owner;                           // 所属线程
+        Magazine* next;
+
+        Magazine() : hits(0), misses(0), cached(0), cached_bytes(0), owner(std::this_thread::get_id()), next(nullptr) {}
+
+        std::vector<NodeOpt<K, V>*>& stack(int level) {
+            if (level >= (int)stacks.size()) {
+                stacks.resize(level + 1);
+            }
+            return stacks[level];
+        }
+
+        // 单写者计数，读-改-写无需原子 RMW
+        static void bump(std::atomic<uint64_t>& counter) {
+            counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+
+        void add_cached(int64_t nodes, int level) {
+            cached.store(cached.load(std::memory_order_relaxed) + nodes, std::memory_order_relaxed);
+            cached_bytes.store(cached_bytes.load(std::memory_order_relaxed) + nodes * (int64_t)node_bytes(level),
+                               std::memory_order_relaxed);
+        }
+    };
+
+    SlabArena _arena;                             // 节点内存来源（最先声明、最后析构）
+    std::vector<std::vector<NodeOpt<K, V>*>> _free_lists;  // 按层级分类的共享空闲节点列表
+    std::vector<std::vector<void*>> _cold_lists;  // 按层级分类的冷节点：页面已交还系统，key/value 已析构
+    std::atomic<size_t> _cold_count;              // 冷节点总数，分配时据此跳过加锁
+    std::vector<void*> _empty_slabs;              // 节点全部空闲的候选 slab（_pool_mutex 保护）
+    int _initial_capacity;                        // 每个层级空闲列表的初始容量
+    int _magazine_size;                           // 每个线程每个层级最多缓存的节点数
+    mutable std::mutex _pool_mutex;              // 保护共享空闲列表的互斥锁
+    std::atomic<Magazine*> _magazines;            // 线程弹匣链表（只增不删）
+    uint64_t _pool_id;                            // 内存池唯一编号，用于线程局部缓存查找
+    ShardedCounter _allocated_count;              // 总分配次数统计，读取时无需加锁
+    ShardedCounter _reused_count;                 // 复用次数统计，读取时无需加锁
+    size_t _shared_free_bytes;                    // 共享空闲列表中节点的总字节数（_pool_mutex 保护）
+    size_t _memory_budget;                        // 共享空闲列表的保留内存预算
+    size_t _released_bytes;                       // 累计归还系统的字节数
+    size_t _trim_floor;                           // 上次收缩（或请求）后共享空闲列表的字节数，请求收缩的基准
+
+    // 收缩：_trim_exclusive 串行化 trim；后台线程由 _trim_mutex / _trim_cv 控制
+    std::mutex _trim_exclusive;
+    std::thread _trim_thread;
+    std::mutex _trim_mutex;
+    std::condition_variable _trim_cv;
+    bool _trim_stop;
+    bool _trim_requested;
+
+    static size_t node_bytes(int level) {
+        return NodeOpt<K, V>::allocation_size(level);
+    }
+
+    static uint64_t next_pool_id() {
+        static std::atomic<uint64_t> id(1);
+        return id.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // 弹匣与共享空闲列表之间每次交换的节点数
+    size_t transfer_batch() const {
+        return _magazine_size > 1 ? _magazine_size / 2 : 1;
+    }
+
+    // 调用方需持有 _pool_mutex
+    std::vector<NodeOpt<K, V>*>& shared_list(int level) {
+        if (level >= (int)_free_lists.size()) {
+            _free_lists.resize(level + 1);
+        }
+        if (_free_lists[level].capacity() == 0) {
+            _free_lists[level].reserve(_initial_capacity);
+        }
+        return _free_lists[level];
+    }
+
+    // 节点进入共享空闲列表或冷列表，调用方需持有 _pool_mutex
+    // 所在 slab 的节点因此全部空闲时登记为收缩候选
+    void mark_free(const void* node) {
+        void* slab = _arena.slab_of(node);
+        SlabArena::FreeState& state = _arena.free_state(slab);
+        if (++state.free_objects == _arena.object_count(slab) && !state.queued) {
+            state.queued = true;
+            _empty_slabs.push_back(slab);
+        }
+    }
+
+    // 节点离开共享空闲列表或冷列表，调用方需持有 _pool_mutex
+    void mark_used(const void* node) {
+        _arena.free_state(_arena.slab_of(node)).free_objects--;
+    }
+
+    // 超出预算且比上次收缩（或上次请求）多出一个 slab 的空闲字节时请求收缩，调用方需持有 _pool_mutex
+    bool should_trim() {
+        if (_shared_free_bytes <= _memory_budget || _shared_free_bytes < _trim_floor + _arena.get_slab_size()) {
+            return false;
+        }
+        _trim_floor = _shared_free_bytes;
+        return true;
+    }
+
+    // 只登记请求并唤醒后台线程（没有后台线程时请求保留到其启动），不在归还节点的线程上收缩
+    void request_trim() {
+        {
+            std::lock_guard<std::mutex> lock(_trim_mutex);
+            _trim_requested = true;
+        }
+        _trim_cv.notify_one();
+    }
+
+    // 取一个冷节点的内存，没有时返回 nullptr
+    void* take_cold(int level) {
+        if (_cold_count.load(std::memory_order_relaxed) == 0) {
+            return nullptr;
+        }
+        std::lock_guard<std::mutex> lock(_pool_mutex);
+        if (level >= (int)_cold_lists.size() || _cold_lists[level].empty()) {
+            return nullptr;
+        }
+        void* memory = _cold_lists[level].back();
+        _cold_lists[level].pop_back();
+        _cold_count.store(_cold_count.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+        mark_used(memory);
+        return memory;
+    }
+
+    // 收缩时的一个空闲节点：warm 为 true 时 key/value 仍有效
+    struct FreeEntry {
+        char* begin;
+        int level;
+        bool warm;
+
+        bool operator<(const FreeEntry& other) const {
+            return begin < other.begin;
+        }
+    };
+
+    // trim() 的实现，调用方需持有 _trim_exclusive
+    size_t trim_locked() {
+        std::vector<std::vector<NodeOpt<K, V>*>> warm;
+        std::vector<std::vector<void*>> cold;
+        std::vector<std::pair<void*, size_t>> empty;    // 全部空闲的 slab 及其对象数
+        size_t budget;
+        size_t warm_bytes;
+
+        // 1. 加锁：只交换出空闲列表和候选列表，O(层数 + 候选数)
+        {
+            std::lock_guard<std::mutex> lock(_pool_mutex);
+            if (_shared_free_bytes <= _memory_budget) {
+                return 0;
+            }
+            budget = _memory_budget;
+            warm.swap(_free_lists);
+            cold.swap(_cold_lists);
+            warm_bytes = _shared_free_bytes;
+            _shared_free_bytes = 0;
+            _cold_count.store(0, std::memory_order_relaxed);
+            for (void* slab : _empty_slabs) {
+                SlabArena::FreeState& state = _arena.free_state(slab);
+                state.queued = false;
+                if (state.free_objects == _arena.object_count(slab)) {
+                    empty.push_back(std::make_pair(slab, state.free_objects));
+                }
+            }
+            _empty_slabs.clear();
+        }
+
+        // 以下在锁外进行：交换出的节点都是空闲的，其他线程取不到；全空闲 slab 的节点全部在这里
+        std::vector<FreeEntry> entries;
+        for (size_t level = 0; level < warm.size(); level++) {
+            for (NodeOpt<K, V>* node : warm[level]) {
+                entries.push_back(FreeEntry{reinterpret_cast<char*>(node), (int)level, true});
+            }
+        }
+        for (size_t level = 0; level < cold.size(); level++) {
+            for (void* memory : cold[level]) {
+                entries.push_back(FreeEntry{static_cast<char*>(memory), (int)level, false});
+            }
+        }
+        std::sort(entries.begin(), entries.end());
+
+        // 2. 整块归还全部空闲的 slab，直到回到预算以内；只含冷节点的 slab 总是归还
+        std::sort(empty.begin(), empty.end());
+        std::vector<size_t> slab_warm_bytes(empty.size(), 0);
+        std::vector<char> releasing(empty.size(), 0);
+        auto slab_index = [this, &empty](const void* node) -> long {
+            void* slab = _arena.slab_of(node);
+            auto it = std::lower_bound(empty.begin(), empty.end(), std::make_pair(slab, (size_t)0));
+            return (it != empty.end() && it->first == slab) ? it - empty.begin() : -1;
+        };
+        for (const FreeEntry& entry : entries) {
+            long index = slab_index(entry.begin);
+            if (index >= 0 && entry.warm) {
+                slab_warm_bytes[index] += node_bytes(entry.level);
+            }
+        }
+        size_t remaining = warm_bytes;
+        for (size_t i = 0; i < empty.size(); i++) {
+            if (remaining > budget || slab_warm_bytes[i] == 0) {
+                releasing[i] = 1;
+                remaining -= slab_warm_bytes[i];
+            }
+        }
+        // 先析构将随 slab 释放的热节点；release_if 失败（该 slab 仍在切分新节点）时它们转为冷节点
+        for (FreeEntry& entry : entries) {
+            long index = slab_index(entry.begin);
+            if (index >= 0 && releasing[index] && entry.warm) {
+                NodeOpt<K, V>::destruct(reinterpret_cast<NodeOpt<K, V>*>(entry.begin));
+                entry.warm = false;
+            }
+        }
+        size_t released = 0;
+        for (size_t i = 0; i < empty.size(); i++) {
+            if (releasing[i]) {
+                size_t bytes = _arena.release_if(empty[i].first, empty[i].second, []() {});
+                released += bytes;
+                releasing[i] = bytes > 0;
+            }
+        }
+        size_t kept = 0;
+        for (const FreeEntry& entry : entries) {
+            long index = slab_index(entry.begin);
+            if (index < 0 || !releasing[index]) {
+                entries[kept++] = entry;
+            }
+        }
+        entries.resize(kept);
+
+        // 3. 仍超出预算：相邻空闲节点连成的区间内，被完全覆盖的页面交还系统
+        // 只归还与热节点重叠的页面（只被冷节点覆盖的页面此前已归还），覆盖这些页面的热节点析构后转为冷节点
+        const size_t page = SlabArena::page_size();
+        size_t run_begin = 0;
+        while (remaining > budget && run_begin < entries.size()) {
+            size_t run_end = run_begin + 1;
+            while (run_end < entries.size() && entries[run_end].begin == entry_end(entries[run_end - 1])) {
+                run_end++;
+            }
+            uintptr_t first_page = align_up((uintptr_t)entries[run_begin].begin, page);
+            uintptr_t last_page = align_down((uintptr_t)entry_end(entries[run_end - 1]), page);
+            uintptr_t pending_begin = 0;
+            uintptr_t pending_end = 0;
+            for (size_t i = run_begin; first_page < last_page && i < run_end; i++) {
+                FreeEntry& entry = entries[i];
+                uintptr_t begin = std::max(align_down((uintptr_t)entry.begin, page), first_page);
+                uintptr_t end = std::min(align_up((uintptr_t)entry_end(entry), page), last_page);
+                if (begin >= end || !entry.warm) {
+                    continue;
+                }
+                NodeOpt<K, V>::destruct(reinterpret_cast<NodeOpt<K, V>*>(entry.begin));
+                entry.warm = false;
+                remaining -= node_bytes(entry.level);
+                // 与上一段页面相接时合并，减少 madvise 次数
+                if (begin > pending_end) {
+                    released += _arena.release_pages((void*)pending_begin, pending_end - pending_begin);
+                    pending_begin = begin;
+                }
+                pending_end = std::max(pending_end, end);
+            }
+            released += _arena.release_pages((void*)pending_begin, pending_end - pending_begin);
+            run_begin = run_end;
+        }
+
+        // 4. 加锁：剩余节点放回空闲列表，未释放的全空闲 slab 重新登记为候选
+        {
+            std::lock_guard<std::mutex> lock(_pool_mutex);
+            size_t cold_total = 0;
+            for (const FreeEntry& entry : entries) {
+                if (entry.warm) {
+                    shared_list(entry.level).push_back(reinterpret_cast<NodeOpt<K, V>*>(entry.begin));
+                } else {
+                    if (entry.level >= (int)_cold_lists.size()) {
+                        _cold_lists.resize(entry.level + 1);
+                    }
+                    _cold_lists[entry.level].push_back(entry.begin);
+                    cold_total++;
+                }
+            }
+            _shared_free_bytes += remaining;
+            _cold_count.store(_cold_count.load(std::memory_order_relaxed) + cold_total, std::memory_order_relaxed);
+            _released_bytes += released;
+            _trim_floor = _shared_free_bytes;
+            for (size_t i = 0; i < empty.size(); i++) {
+                if (releasing[i]) {
+                    continue;
+                }
+                SlabArena::FreeState& state = _arena.free_state(empty[i].first);
+                if (!state.queued && state.free_objects == _arena.object_count(empty[i].first)) {
+                    state.queued = true;
+                    _empty_slabs.push_back(empty[i].first);
+                }
+            }
+        }
+        return released;
+    }
+
+    static char* entry_end(const FreeEntry& entry) {
+        return entry.begin + SlabArena::carved_size(node_bytes(entry.level));
+    }
+
+    static uintptr_t align_up(uintptr_t value, size_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    static uintptr_t align_down(uintptr_t value, size_t alignment) {
+        return value / alignment * alignment;
+    }
+
+    // 不使用弹匣时直接从共享空闲列表取一个节点
+    NodeOpt<K, V>* take_from_shared(int level) {
+        std::lock_guard<std::mutex> lock(_pool_mutex);
+        if (level < (int)_free_lists.size() && !_free_lists[level].empty()) {
+            NodeOpt<K, V>* node = _free_lists[level].back();
+            _free_lists[level].pop_back();
+            _shared_free_bytes -= node_bytes(level);
+            mark_used(node);
+            return node;
+        }
+        return nullptr;
+    }
+
+    // 从本线程弹匣取一个节点，弹匣为空时先从共享空闲列表批量补充
+    NodeOpt<K, V>* take_from_magazine(int level) {
+        Magazine* magazine = local_magazine();
+        std::vector<NodeOpt<K, V>*>& stack = magazine->stack(level);
+        if (!stack.empty()) {
+            Magazine::bump(magazine->hits);
+        } else {
+            Magazine::bump(magazine->misses);
+            std::lock_guard<std::mutex> lock(_pool_mutex);
+            if (level < (int)_free_lists.size()) {
+                std::vector<NodeOpt<K, V>*>& free_list = _free_lists[level];
+                size_t count = std::min(transfer_batch(), free_list.size());
+                stack.insert(stack.end(), free_list.end() - count, free_list.end());
+                free_list.resize(free_list.size() - count);
+                for (size_t i = stack.size() - count; i < stack.size(); i++) {
+                    mark_used(stack[i]);
+                }
+                _shared_free_bytes -= count * node_bytes(level);
+                magazine->add_cached((int64_t)count, level);
+            }
+            if (stack.empty()) {
+                return nullptr;
+            }
+        }
+        NodeOpt<K, V>* node = stack.back();
+        stack.pop_back();
+        magazine->add_cached(-1, level);
+        return node;
+    }
+
+    // 查找（必要时注册）当前线程在本内存池中的弹匣
+    Magazine* local_magazine() {
+        struct CacheEntry {
+            uint64_t pool_id;
+            Magazine* magazine;
+        };
+        // 按编号直接映射：编号连续分配，同时存活的内存池（如各分片各自的内存池）不超过 CACHE_SIZE 个时互不挤占
+        static const int CACHE_SIZE = 64;
+        static thread_local CacheEntry cache[CACHE_SIZE] = {};
+
+        CacheEntry& entry = cache[_pool_id % CACHE_SIZE];
+        if (entry.pool_id == _pool_id) {
+            return entry.magazine;
+        }
+
+        // 缓存未命中：先在已注册弹匣中查找（缓存条目可能已被挤出），找不到再注册
+        std::thread::id self = std::this_thread::get_id();
+        Magazine* magazine = nullptr;
+        for (Magazine* m = _magazines.load(std::memory_order_acquire); m != nullptr; m = m->next) {
+            if (m->owner == self) {
+                magazine = m;
+                break;
+            }
+        }
+        if (magazine == nullptr) {
+            magazine = new Magazine();
+            Magazine* head = _magazines.load(std::memory_order_acquire);
+            do {
+                magazine->next = head;
+            } while (!_magazines.compare_exchange_weak(head, magazine, std::memory_order_acq_rel));
+        }
+
+        entry = CacheEntry{_pool_id, magazine};
+        return magazine;
+    }
     
     /**
      * @brief 重新初始化节点
-     * @param node 要初始化的节点
-     * @param key 新的键
-     * @param value 新的值
+     * @param node 要初始化的节点（层级与请求层级一致）
      * @param level 新的层级
+     * @param key 新的键
+     * @param args 新 value 的构造参数
      */
-    void reinitialize_node(NodeOpt<K, V>* node, const K& key, const V& value, int level) {
-        // 如果新层级与旧层级不同，需要重新分配forward数组
-        if (node->node_level != level) {
-            delete[] node->forward;
-            node->forward = new NodeOpt<K, V>*[level + 1];
-            node->node_level = level;
+    template<typename KArg, typename... Args>
+    void reinitialize_node(NodeOpt<K, V>* node, int level, KArg&& key, Args&&... args) {
+        // 重置forward数组（节点尚未链接，relaxed 即可，链接时的 release 一并发布）
+        for (int i = 0; i <= level; i++) {
+            node->forward[i].store(nullptr, std::memory_order_relaxed);
         }
-        
-        // 重置forward数组
-        memset(node->forward, 0, sizeof(NodeOpt<K, V>*) * (level + 1));
+        memset(node->span(), 0, sizeof(int) * (level + 1));
         
         // 设置新的键值（通过友元或公共方法）
-        // 注意：这里需要NodeOpt类提供设置key的方法
-        node->set_key_value(key, value);
+        node->set_key_value(std::forward<KArg>(key), std::forward<Args>(args)...);
     }
     
     // 禁止拷贝和赋值
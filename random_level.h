@@ -0,0 +1,171 @@
+/* ************************************************************************
+> File Name:     random_level.h
+> Description:   随机层级生成器
+>                1. 每个线程独立的 xorshift64* 状态，不经过 rand() 的全局锁
+>                2. p = 1/2、1/4 时一次前导零计数得到层级，不按层循环取随机数
+>                3. 可由预期容量推导 max_level
+>                4. 有序批量导入时按位置给出完全平衡的层级
+ ************************************************************************/
+
+#ifndef RANDOM_LEVEL_H
+#define RANDOM_LEVEL_H
+
+#include <atomic>
+#include <thread>
+#include <functional>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief 分支因子：节点出现在上一层的概率 p
+ *
+ * 节点层级为 k 的概率为 p^k (1 - p)，平均每个节点有 1 / (1 - p) 个 forward 指针：
+ * - Half:     p = 1/2，平均 2 个指针
+ * - Quarter:  p = 1/4，平均 4/3 个指针，比 1/2 少约 1/3；每层比较次数略多
+ * - InverseE: p = 1/e，理论上期望查找代价最小
+ */
+enum class LevelProbability {
+    Half,
+    Quarter,
+    InverseE
+};
+
+/**
+ * @brief 随机层级生成器
+ *
+ * next() 返回 [0, max_level] 内的层级，层级 0 表示节点只在第 0 层。
+ * 随机数来自线程局部的 xorshift64*，所有生成器共享同一线程的状态，多线程插入互不干扰。
+ * xorshift64* 的高位质量最好，p = 1/2 时层级为随机数的前导零个数，p = 1/4 时为前导零个数的一半；
+ * p = 1/e 时与预先算好的阈值表 p^k * 2^64 比较，仍只取一次随机数。
+ */
+class LevelGenerator {
+public:
+    explicit LevelGenerator(int max_level, LevelProbability probability = LevelProbability::Half)
+        : _max_level(max_level), _probability(probability), _threshold_count(0) {
+        if (probability == LevelProbability::InverseE) {
+            // _thresholds[k] = p^(k+1) * 2^64，随机数小于它的概率即层级 > k 的概率
+            long double bound = 18446744073709551616.0L * probability_value(probability);
+            while (_threshold_count < MAX_THRESHOLDS && bound >= 1.0L) {
+                _thresholds[_threshold_count++] = (uint64_t)bound;
+                bound *= probability_value(probability);
+            }
+        }
+    }
+
+    /**
+     * @brief 生成一个层级，范围 [0, max_level]
+     */
+    int next() const {
+        uint64_t r = next_random();
+        int level = 0;
+        switch (_probability) {
+        case LevelProbability::Half:
+            level = __builtin_clzll(r | 1);
+            break;
+        case LevelProbability::Quarter:
+            level = __builtin_clzll(r | 1) / 2;
+            break;
+        case LevelProbability::InverseE:
+            while (level < _threshold_count && r < _thresholds[level]) {
+                level++;
+            }
+            break;
+        }
+        return level < _max_level ? level : _max_level;
+    }
+
+    /**
+     * @brief 完全平衡跳表中第 position 个元素（1 基）的层级，范围 [0, max_level]
+     *
+     * 以 b = 1/p 为底（1/e 取最接近的整数 3），层级为 position 中因子 b 的个数：
+     * 每 b 个元素有一个至少 1 层的节点，每 b^2 个有一个至少 2 层的节点，各层节点等距分布。
+     * 用于有序批量导入，不消耗随机数。
+     */
+    int balanced_level(uint64_t position) const {
+        int level = 0;
+        if (position == 0) {
+            return 0;
+        }
+        switch (_probability) {
+        case LevelProbability::Half:
+            level = __builtin_ctzll(position);
+            break;
+        case LevelProbability::Quarter:
+            level = __builtin_ctzll(position) / 2;
+            break;
+        case LevelProbability::InverseE:
+            while (position % 3 == 0) {
+                position /= 3;
+                level++;
+            }
+            break;
+        }
+        return level < _max_level ? level : _max_level;
+    }
+
+    int max_level() const {
+        return _max_level;
+    }
+
+    LevelProbability probability() const {
+        return _probability;
+    }
+
+    static double probability_value(LevelProbability probability) {
+        switch (probability) {
+        case LevelProbability::Quarter:
+            return 0.25;
+        case LevelProbability::InverseE:
+            return 0.36787944117144233;
+        default:
+            return 0.5;
+        }
+    }
+
+    /**
+     * @brief 由预期元素个数推导 max_level：log_{1/p}(expected_capacity)，向上取整，至少为 1
+     *
+     * 层级 k 上的期望节点数为 n * p^k，取到该值约为 1 的层即可，更高的层几乎总是空的。
+     */
+    static int max_level_for(size_t expected_capacity, LevelProbability probability = LevelProbability::Half) {
+        if (expected_capacity < 2) {
+            return 1;
+        }
+        double levels = std::log((double)expected_capacity) / -std::log(probability_value(probability));
+        int max_level = (int)std::ceil(levels - 1e-9);
+        return max_level > 1 ? max_level : 1;
+    }
+
+    /**
+     * @brief 线程局部 xorshift64*，首次调用时用线程 id 和全局计数器播种
+     */
+    static uint64_t next_random() {
+        thread_local uint64_t state = seed();
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 2685821657736338717ULL;
+    }
+
+private:
+    static const int MAX_THRESHOLDS = 64;
+
+    // splitmix64 混合线程 id 与全局计数器，保证各线程的初始状态不同且非零
+    static uint64_t seed() {
+        static std::atomic<uint64_t> counter(0);
+        uint64_t z = std::hash<std::thread::id>{}(std::this_thread::get_id()) ^
+                     (counter.fetch_add(1, std::memory_order_relaxed) + 1) * 0x9E3779B97F4A7C15ULL;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        z ^= z >> 31;
+        return z != 0 ? z : 0x9E3779B97F4A7C15ULL;
+    }
+
+    int _max_level;
+    LevelProbability _probability;
+    int _threshold_count;
+    uint64_t _thresholds[MAX_THRESHOLDS];
+};
+
+#endif // RANDOM_LEVEL_H
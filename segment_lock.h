@@ -3,21 +3,151 @@
 > Description:   细粒度锁实现 - 分段锁机制
 >                类似ConcurrentHashMap的设计，将跳表分成多个段
 >                每个段有独立的读写锁，提升并发性能
+>                1. 读锁共享、写锁独占，同段的读操作可以并行
+>                2. 每个段独占一个 cache line，避免相邻段的锁伪共享
+>                3. 先自旋后挂起的自适应锁，并统计每段的加锁与竞争次数
  ************************************************************************/
 
 #ifndef SEGMENT_LOCK_H
 #define SEGMENT_LOCK_H
 
 #include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <atomic>
 #include <functional>
 #include <vector>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief 自适应读写锁 - 先自旋，自旋失败后挂起
+ *
+ * 状态字 _state 的最高位表示写者持锁，低位为读者计数；读写的快速路径都是一次 CAS。
+ * 临界区很短时锁通常在自旋期间就被释放，不必进出内核；
+ * 自旋 SPIN_LIMIT 次仍失败则在条件变量上挂起，避免长时间空转占用 CPU。
+ * 有写者等待时新读者不再进入，写者不会被源源不断的读者饿死。
+ * 满足 Lockable / SharedLockable，可配合 std::unique_lock / std::shared_lock 使用。
+ * acquire / acquire_shared 与 lock / lock_shared 相同，额外返回本次是否发生竞争。
+ */
+class AdaptiveSharedMutex {
+public:
+    static const int SPIN_LIMIT = 64;
+
+    AdaptiveSharedMutex() : _state(0), _writers_waiting(0), _parked(0) {}
+
+    bool try_lock() {
+        uint32_t expected = 0;
+        return _state.compare_exchange_strong(expected, WRITER, std::memory_order_acquire,
+                                              std::memory_order_relaxed);
+    }
+
+    bool try_lock_shared() {
+        uint32_t state = _state.load(std::memory_order_relaxed);
+        if ((state & WRITER) || _writers_waiting.load(std::memory_order_relaxed) > 0) {
+            return false;
+        }
+        return _state.compare_exchange_strong(state, state + 1, std::memory_order_acquire,
+                                              std::memory_order_relaxed);
+    }
+
+    void lock() { acquire(); }
+    void lock_shared() { acquire_shared(); }
+
+    // 加锁并返回本次是否发生竞争（快速路径失败），供段锁统计使用
+    bool acquire() {
+        if (try_lock()) {
+            return false;
+        }
+        _writers_waiting.fetch_add(1);
+        if (!spin([this]() { return try_lock(); })) {
+            park([this]() { return try_lock(); });
+        }
+        _writers_waiting.fetch_sub(1);
+        return true;
+    }
+
+    bool acquire_shared() {
+        if (try_lock_shared()) {
+            return false;
+        }
+        if (!spin([this]() { return try_lock_shared(); })) {
+            park([this]() { return try_lock_shared(); });
+        }
+        return true;
+    }
+
+    void unlock() {
+        _state.fetch_and(~WRITER);
+        wake();
+    }
+
+    void unlock_shared() {
+        if (_state.fetch_sub(1) == 1) {
+            wake();
+        }
+    }
+
+private:
+    static const uint32_t WRITER = 1u << 31;
+
+    template<typename TryAcquire>
+    bool spin(TryAcquire try_acquire) {
+        for (int i = 0; i < SPIN_LIMIT; i++) {
+#if defined(__x86_64__) || defined(__i386__)
+            _mm_pause();
+#endif
+            if (try_acquire()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // 登记为挂起线程后再检查一次，释放方先改状态再读 _parked（均为顺序一致），不会丢失唤醒
+    template<typename TryAcquire>
+    void park(TryAcquire try_acquire) {
+        std::unique_lock<std::mutex> lock(_park_mutex);
+        _parked.fetch_add(1);
+        _park_cv.wait(lock, try_acquire);
+        _parked.fetch_sub(1);
+    }
+
+    void wake() {
+        if (_parked.load() > 0) {
+            std::lock_guard<std::mutex> lock(_park_mutex);
+            _park_cv.notify_all();
+        }
+    }
+
+    std::atomic<uint32_t> _state;            // 最高位：写者持锁；低位：读者数
+    std::atomic<uint32_t> _writers_waiting;  // 等待中的写者数
+    std::atomic<uint32_t> _parked;           // 挂起在条件变量上的线程数
+    std::mutex _park_mutex;
+    std::condition_variable _park_cv;
+
+    AdaptiveSharedMutex(const AdaptiveSharedMutex&) = delete;
+    AdaptiveSharedMutex& operator=(const AdaptiveSharedMutex&) = delete;
+};
+
+/**
+ * @brief 单个段的加锁统计
+ */
+struct SegmentLockStats {
+    uint64_t read_acquisitions;     // 读锁加锁次数
+    uint64_t write_acquisitions;    // 写锁加锁次数
+    uint64_t contended;             // 快速路径失败、进入自旋或挂起的次数
+};
 
 /**
  * @brief 分段锁管理器
- * 
+ *
  * 将数据空间分成多个段，每个段有独立的读写锁
  * 不同段的操作可以并发执行，提升并发性能
- * 
+ *
  * @tparam K 键的类型
  */
 template<typename K>
@@ -25,23 +155,69 @@ class SegmentLockManager {
 public:
     // 默认分段数量，可根据CPU核心数调整
     static const int DEFAULT_SEGMENT_COUNT = 16;
-    
+
+    /**
+     * @brief 段锁：std::unique_lock / std::shared_lock 通过它加锁并累计统计
+     */
+    class alignas(64) Segment {
+    public:
+        Segment() : _read_acquisitions(0), _write_acquisitions(0), _contended(0) {}
+
+        void lock() {
+            count(_mutex.acquire(), _write_acquisitions);
+        }
+        void unlock() { _mutex.unlock(); }
+        bool try_lock() { return _mutex.try_lock(); }
+
+        void lock_shared() {
+            count(_mutex.acquire_shared(), _read_acquisitions);
+        }
+        void unlock_shared() { _mutex.unlock_shared(); }
+        bool try_lock_shared() { return _mutex.try_lock_shared(); }
+
+        SegmentLockStats stats() const {
+            return {_read_acquisitions.load(std::memory_order_relaxed),
+                    _write_acquisitions.load(std::memory_order_relaxed),
+                    _contended.load(std::memory_order_relaxed)};
+        }
+
+        void reset_stats() {
+            _read_acquisitions.store(0, std::memory_order_relaxed);
+            _write_acquisitions.store(0, std::memory_order_relaxed);
+            _contended.store(0, std::memory_order_relaxed);
+        }
+
+    private:
+        void count(bool contended, std::atomic<uint64_t>& acquisitions) {
+            acquisitions.fetch_add(1, std::memory_order_relaxed);
+            if (contended) {
+                _contended.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        AdaptiveSharedMutex _mutex;
+        std::atomic<uint64_t> _read_acquisitions;
+        std::atomic<uint64_t> _write_acquisitions;
+        std::atomic<uint64_t> _contended;
+    };
+
     /**
      * @brief 构造函数
      * @param segment_count 分段数量，建议设置为2的幂次方
      */
-    explicit SegmentLockManager(int segment_count = DEFAULT_SEGMENT_COUNT) 
+    explicit SegmentLockManager(int segment_count = DEFAULT_SEGMENT_COUNT)
         : _segment_count(segment_count) {
-        _segment_locks = new std::mutex[segment_count];
+        // Segment 按 64 字节对齐，new[] 使用对齐分配，相邻段不共享 cache line
+        _segment_locks = new Segment[segment_count];
     }
-    
+
     /**
      * @brief 析构函数
      */
     ~SegmentLockManager() {
         delete[] _segment_locks;
     }
-    
+
     /**
      * @brief 根据key计算所属的段索引
      * @param key 键值
@@ -52,55 +228,84 @@ public:
         size_t hash_value = std::hash<K>{}(key);
         return hash_value % _segment_count;
     }
-    
+
     /**
      * @brief 获取指定段的读锁（共享锁）
      * @param segment_index 段索引
-     * @return 独占锁对象（注意：使用mutex代替shared_mutex，读写都是独占）
+     * @return 共享锁对象，同段的多个读者可同时持有
      */
-    std::unique_lock<std::mutex> get_read_lock(int segment_index) {
-        return std::unique_lock<std::mutex>(_segment_locks[segment_index]);
+    std::shared_lock<Segment> get_read_lock(int segment_index) {
+        return std::shared_lock<Segment>(_segment_locks[segment_index]);
     }
-    
+
     /**
      * @brief 获取指定段的写锁（独占锁）
      * @param segment_index 段索引
      * @return 独占锁对象
      */
-    std::unique_lock<std::mutex> get_write_lock(int segment_index) {
-        return std::unique_lock<std::mutex>(_segment_locks[segment_index]);
+    std::unique_lock<Segment> get_write_lock(int segment_index) {
+        return std::unique_lock<Segment>(_segment_locks[segment_index]);
     }
-    
+
     /**
      * @brief 获取所有段的写锁（用于全局操作，如dump_file）
      * @return 所有段的独占锁对象向量
      */
-    std::vector<std::unique_lock<std::mutex>> get_all_write_locks() {
-        std::vector<std::unique_lock<std::mutex>> locks;
+    std::vector<std::unique_lock<Segment>> get_all_write_locks() {
+        std::vector<std::unique_lock<Segment>> locks;
         locks.reserve(_segment_count);
-        
+
         // 按顺序获取所有锁，避免死锁
         for (int i = 0; i < _segment_count; i++) {
             locks.emplace_back(_segment_locks[i]);
         }
         return locks;
     }
-    
+
     /**
      * @brief 获取分段数量
      */
     int get_segment_count() const {
         return _segment_count;
     }
-    
+
+    /**
+     * @brief 获取指定段的加锁统计
+     */
+    SegmentLockStats get_segment_stats(int segment_index) const {
+        return _segment_locks[segment_index].stats();
+    }
+
+    /**
+     * @brief 所有段的统计之和
+     */
+    SegmentLockStats get_total_stats() const {
+        SegmentLockStats total = {0, 0, 0};
+        for (int i = 0; i < _segment_count; i++) {
+            SegmentLockStats stats = _segment_locks[i].stats();
+            total.read_acquisitions += stats.read_acquisitions;
+            total.write_acquisitions += stats.write_acquisitions;
+            total.contended += stats.contended;
+        }
+        return total;
+    }
+
+    /**
+     * @brief 清零所有段的统计
+     */
+    void reset_stats() {
+        for (int i = 0; i < _segment_count; i++) {
+            _segment_locks[i].reset_stats();
+        }
+    }
+
 private:
     int _segment_count;                      // 分段数量
-    std::mutex* _segment_locks;              // 分段锁数组
-    
+    Segment* _segment_locks;                 // 分段锁数组，每段独占一个 cache line
+
     // 禁止拷贝和赋值
     SegmentLockManager(const SegmentLockManager&) = delete;
     SegmentLockManager& operator=(const SegmentLockManager&) = delete;
 };
 
 #endif // SEGMENT_LOCK_H
-
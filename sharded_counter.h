@@ -0,0 +1,91 @@
+/* ************************************************************************
+> File Name:     sharded_counter.h
+> Description:   分片计数器 - 写多读少的统计量
+>                1. 计数拆成多个独占 cache line 的槽，每个线程固定写其中一个
+>                2. 写入只做一次本地槽上的 relaxed fetch_add，不与其他线程争抢同一 cache line
+>                3. 读取时把所有槽相加，结果是近似快照；写入方已串行化时为精确值
+ ************************************************************************/
+
+#ifndef SHARDED_COUNTER_H
+#define SHARDED_COUNTER_H
+
+#include <atomic>
+#include <thread>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief 分片计数器
+ *
+ * 元素计数、内存池的分配次数这类统计每次写操作都要更新，却很少读取。
+ * 用单个 std::atomic 时所有写线程都在同一 cache line 上做 RMW，该行在核间来回迁移；
+ * 这里每个线程第一次写入时按轮转分配一个槽，此后只写自己的槽。
+ * 槽数取不小于硬件线程数的 2 的幂，线程数不超过槽数时各线程的槽互不相同。
+ *
+ * load() 对各槽做 relaxed 读取求和：并发写入时只保证最终一致，不是某一时刻的精确值；
+ * 调用方若已用锁串行化了所有写入，在同一把锁下 load() 得到的就是精确值。
+ */
+class ShardedCounter {
+public:
+    ShardedCounter() : _mask(cell_count() - 1) {
+        _cells = new Cell[_mask + 1];
+    }
+
+    ~ShardedCounter() {
+        delete[] _cells;
+    }
+
+    void add(int64_t delta) {
+        _cells[thread_slot() & _mask].value.fetch_add(delta, std::memory_order_relaxed);
+    }
+
+    void increment() { add(1); }
+    void decrement() { add(-1); }
+
+    int64_t load() const {
+        int64_t total = 0;
+        for (size_t i = 0; i <= _mask; i++) {
+            total += _cells[i].value.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    // 清零；与并发的 add 同时进行时，这些 add 可能被部分抹去
+    void reset() {
+        for (size_t i = 0; i <= _mask; i++) {
+            _cells[i].value.store(0, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    struct alignas(64) Cell {
+        Cell() : value(0) {}
+        std::atomic<int64_t> value;
+    };
+
+    // 不小于硬件线程数的 2 的幂，至少 4 个槽
+    static size_t cell_count() {
+        size_t threads = std::thread::hardware_concurrency();
+        size_t count = 4;
+        while (count < threads) {
+            count <<= 1;
+        }
+        return count;
+    }
+
+    // 线程首次写入任意计数器时分配的编号，所有计数器共用
+    static size_t thread_slot() {
+        static std::atomic<size_t> next_slot(0);
+        thread_local size_t slot = next_slot.fetch_add(1, std::memory_order_relaxed);
+        return slot;
+    }
+
+    Cell* _cells;
+    size_t _mask;
+
+    // 禁止拷贝和赋值
+    ShardedCounter(const ShardedCounter&) = delete;
+    ShardedCounter& operator=(const ShardedCounter&) = delete;
+};
+
+#endif // SHARDED_COUNTER_H
@@ -0,0 +1,139 @@
+/* ************************************************************************
+> File Name:     simd_search.h
+> Description:   有序 key 数组的 SIMD 查找内核
+>                1. int32 / int64 键使用 SSE / AVX2 整块比较，无分支
+>                2. 其他键类型回退到标量顺序扫描
+>                3. 通过 if constexpr 在编译期选择实现
+ ************************************************************************/
+
+#ifndef SIMD_SEARCH_H
+#define SIMD_SEARCH_H
+
+#include <type_traits>
+#include <cstdint>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// 当前编译目标可用的向量宽度（未开启 -mavx2 / -msse4.2 时自动降级）
+#if defined(__AVX2__) || defined(__SSE2__)
+#define SIMD_SEARCH_INT32 1
+#else
+#define SIMD_SEARCH_INT32 0
+#endif
+
+#if defined(__AVX2__) || defined(__SSE4_2__)
+#define SIMD_SEARCH_INT64 1
+#else
+#define SIMD_SEARCH_INT64 0
+#endif
+
+/**
+ * @brief 键类型的 SIMD 能力描述
+ *
+ * 只有有符号 32 / 64 位整数能直接映射到 SIMD 的有符号比较指令，
+ * 其他类型（无符号、字符串、自定义类型）走标量路径。
+ *
+ * @tparam K 键的类型
+ */
+template<typename K>
+struct KeySearchTraits {
+    static constexpr bool is_int32 = std::is_integral<K>::value && std::is_signed<K>::value && sizeof(K) == 4;
+    static constexpr bool is_int64 = std::is_integral<K>::value && std::is_signed<K>::value && sizeof(K) == 8;
+
+    // 是否走向量化路径
+    static constexpr bool vectorized = (is_int32 && SIMD_SEARCH_INT32) || (is_int64 && SIMD_SEARCH_INT64);
+
+    // 是否可用无分支标量计数（整数比较代价低，不需要提前退出）
+    static constexpr bool branchless = std::is_arithmetic<K>::value;
+};
+
+/**
+ * @brief 统计 keys[0, count) 中小于 key 的元素个数（int32，向量化）
+ */
+inline int simd_count_less_int32(const int32_t* keys, int count, int32_t key) {
+    int i = 0;
+    int less = 0;
+#if SIMD_SEARCH_INT32
+#if defined(__AVX2__)
+    const __m256i probe8 = _mm256_set1_epi32(key);
+    for (; i + 8 <= count; i += 8) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i));
+        __m256i mask = _mm256_cmpgt_epi32(probe8, block);
+        less += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(mask)));
+    }
+#endif
+    const __m128i probe4 = _mm_set1_epi32(key);
+    for (; i + 4 <= count; i += 4) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i));
+        __m128i mask = _mm_cmpgt_epi32(probe4, block);
+        less += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(mask)));
+    }
+#endif
+    for (; i < count; i++) {
+        less += keys[i] < key;
+    }
+    return less;
+}
+
+/**
+ * @brief 统计 keys[0, count) 中小于 key 的元素个数（int64，向量化）
+ */
+inline int simd_count_less_int64(const int64_t* keys, int count, int64_t key) {
+    int i = 0;
+    int less = 0;
+#if SIMD_SEARCH_INT64
+#if defined(__AVX2__)
+    const __m256i probe4 = _mm256_set1_epi64x(key);
+    for (; i + 4 <= count; i += 4) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i));
+        __m256i mask = _mm256_cmpgt_epi64(probe4, block);
+        less += __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(mask)));
+    }
+#endif
+    const __m128i probe2 = _mm_set1_epi64x(key);
+    for (; i + 2 <= count; i += 2) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i));
+        __m128i mask = _mm_cmpgt_epi64(probe2, block);
+        less += __builtin_popcount(_mm_movemask_pd(_mm_castsi128_pd(mask)));
+    }
+#endif
+    for (; i < count; i++) {
+        less += keys[i] < key;
+    }
+    return less;
+}
+
+/**
+ * @brief 有序数组中第一个 >= key 的位置，不存在时返回 count
+ *
+ * 数组有序时"小于 key 的元素个数"即为 lower_bound，
+ * 向量化路径一次比较整块 key 并用 popcount 计数，整个过程没有数据相关分支。
+ *
+ * @param keys 升序排列的 key 数组
+ * @param count 数组长度
+ * @param key 待查找的 key
+ */
+template<typename K>
+inline int key_lower_bound(const K* keys, int count, const K& key) {
+    if constexpr (KeySearchTraits<K>::vectorized && KeySearchTraits<K>::is_int32) {
+        return simd_count_less_int32(reinterpret_cast<const int32_t*>(keys), count, static_cast<int32_t>(key));
+    } else if constexpr (KeySearchTraits<K>::vectorized && KeySearchTraits<K>::is_int64) {
+        return simd_count_less_int64(reinterpret_cast<const int64_t*>(keys), count, static_cast<int64_t>(key));
+    } else if constexpr (KeySearchTraits<K>::branchless) {
+        int less = 0;
+        for (int i = 0; i < count; i++) {
+            less += keys[i] < key;
+        }
+        return less;
+    } else {
+        int i = 0;
+        while (i < count && keys[i] < key) {
+            i++;
+        }
+        return i;
+    }
+}
+
+#endif // SIMD_SEARCH_H
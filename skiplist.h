@@ -12,60 +12,134 @@
 #include <cmath>
 #include <cstring>
 #include <mutex>
+#include <shared_mutex>
 #include <fstream>
 #include <memory>
 #include <vector>
+#include <iterator>
+#include <algorithm>
+#include <limits>
+#include <new>
+#include "batch_search.h"
+#include "log_policy.h"
+#include "lock_policy.h"
+#include "random_level.h"
 
 #define STORE_FILE "store/dumpFile"
 
-std::mutex mtx;     // mutex for critical section
 std::string delimiter = ":";
 
 //Class template to implement node
+// 节点头、forward 塔、跨度数组和 value 在同一块内存中（单次分配）：
+// [key | node_level | forward[0..level] | span[0..level] | value]
+// key 与 forward[0] 位于首个 cache line，查找路径上无需额外的指针跳转
 template<typename K, typename V> 
 class Node {
 
 public:
-    
-    Node() {} 
 
-    Node(K k, V v, int); 
+    // 单次分配创建节点，level + 1 个 forward 指针内联在节点尾部
+    static Node<K, V>* create(const K& k, const V& v, int level);
+
+    // 原地构造：key 按值类别转发，args 直接转发给 V 的构造函数，不产生临时 value
+    template<typename KArg, typename... Args>
+    static Node<K, V>* emplace(int level, KArg&& k, Args&&... args);
+
+    // 析构 key/value 并释放整块内存
+    static void destroy(Node<K, V>* node);
 
-    ~Node();
+    // 指定层级节点所需的字节数
+    static size_t allocation_size(int level);
 
     K get_key() const;
 
     V get_value() const;
 
+    // 引用访问，供游标直接读取节点内的 key/value
+    const K& get_key_ref() const;
+
+    const V& get_value_ref() const;
+
+    // 按值接收，传入右值时整个过程只有移动
     void set_value(V);
-    
-    // 使用原始指针数组（因为跳表的特殊结构，节点间共享所有权不适合shared_ptr）
-    // 内存管理由SkipList统一负责
-    Node<K, V> **forward;
 
+private:
+    K key;
+
+public:
     int node_level;
 
+    // 内联的 forward 塔，实际长度为 node_level + 1，必须是最后一个成员
+    Node<K, V> *forward[1];
+
+    // 第 i 层跨度：从本节点沿第 i 层走到 forward[i] 跨过的第 0 层节点数
+    // forward[i] 为空时为本节点之后剩余的元素个数
+    int* span() const;
+
 private:
-    K key;
-    V value;
+    template<typename KArg>
+    Node(KArg&& k, int level);
+    ~Node() {}
+
+    // 跨度数组紧跟在 forward 塔之后，value 在跨度数组之后
+    static size_t span_offset(int level);
+    static size_t value_offset(int level);
+    V* value_ptr() const;
 };
 
 template<typename K, typename V> 
-Node<K, V>::Node(const K k, const V v, int level) {
-    this->key = k;
-    this->value = v;
-    this->node_level = level; 
-
-    // level + 1, because array index is from 0 - level
-    this->forward = new Node<K, V>*[level+1];
-    
+template<typename KArg>
+Node<K, V>::Node(KArg&& k, int level) : key(std::forward<KArg>(k)), node_level(level) {
 	// Fill forward array with 0(NULL) 
     memset(this->forward, 0, sizeof(Node<K, V>*)*(level+1));
+    memset(this->span(), 0, sizeof(int)*(level+1));
+};
+
+template<typename K, typename V> 
+size_t Node<K, V>::span_offset(int level) {
+    return sizeof(Node<K, V>) + sizeof(Node<K, V>*) * level;
+};
+
+template<typename K, typename V> 
+size_t Node<K, V>::value_offset(int level) {
+    size_t offset = span_offset(level) + sizeof(int) * (level + 1);
+    return (offset + alignof(V) - 1) / alignof(V) * alignof(V);
+};
+
+template<typename K, typename V> 
+int* Node<K, V>::span() const {
+    return reinterpret_cast<int*>(const_cast<char*>(reinterpret_cast<const char*>(this)) + span_offset(node_level));
+};
+
+template<typename K, typename V> 
+size_t Node<K, V>::allocation_size(int level) {
+    return value_offset(level) + sizeof(V);
+};
+
+template<typename K, typename V> 
+V* Node<K, V>::value_ptr() const {
+    return reinterpret_cast<V*>(const_cast<char*>(reinterpret_cast<const char*>(this)) + value_offset(node_level));
 };
 
 template<typename K, typename V> 
-Node<K, V>::~Node() {
-    delete []forward;
+Node<K, V>* Node<K, V>::create(const K& k, const V& v, int level) {
+    return emplace(level, k, v);
+};
+
+template<typename K, typename V> 
+template<typename KArg, typename... Args>
+Node<K, V>* Node<K, V>::emplace(int level, KArg&& k, Args&&... args) {
+    void* memory = ::operator new(allocation_size(level));
+    Node<K, V>* node = new (memory) Node<K, V>(std::forward<KArg>(k), level);
+    new (node->value_ptr()) V(std::forward<Args>(args)...);
+    return node;
+};
+
+template<typename K, typename V> 
+void Node<K, V>::destroy(Node<K, V>* node) {
+    node->value_ptr()->~V();
+    node->~Node<K, V>();
+    ::operator delete(static_cast<void*>(node));
 };
 
 template<typename K, typename V> 
@@ -75,61 +149,225 @@ K Node<K, V>::get_key() const {
 
 template<typename K, typename V> 
 V Node<K, V>::get_value() const {
-    return value;
+    return *value_ptr();
+};
+template<typename K, typename V> 
+const K& Node<K, V>::get_key_ref() const {
+    return key;
+};
+
+template<typename K, typename V> 
+const V& Node<K, V>::get_value_ref() const {
+    return *value_ptr();
 };
+
 template<typename K, typename V> 
 void Node<K, V>::set_value(V value) {
-    this->value=value;
+    *value_ptr() = std::move(value);
 };
 
 // Class template for Skip list
-template <typename K, typename V> 
+// LogPolicy 见 log_policy.h，默认 StdoutLogger 与原有输出一致
+// LockPolicy 见 lock_policy.h，每个实例持有自己的锁，默认 MutexLock
+template <typename K, typename V, typename LogPolicy = StdoutLogger, typename LockPolicy = MutexLock>
 class SkipList {
 
 public: 
     SkipList(int);
+    // 按预期元素个数构造：max_level 取 LevelGenerator::max_level_for(expected_capacity, probability)
+    SkipList(size_t expected_capacity, LevelProbability probability);
     ~SkipList();
-    int get_random_level();
-    Node<K, V>* create_node(K, V, int);
+    int get_random_level();                                            // [0, max_level]，线程局部随机源
+    // 设置分支因子（默认 1/2），只影响之后插入的节点，须在并发写入开始前调用
+    void set_level_probability(LevelProbability probability);
+    LevelProbability get_level_probability() const;
+    int get_max_level() const { return _max_level; }
+    Node<K, V>* create_node(const K&, const V&, int);
     int insert_element(K, V);
+
+    // 单次下降的写接口（不输出日志）
+    int put(const K& key, const V& value);                             // 插入或原地覆盖
+    int put(const K& key, V&& value);                                  // 同上，value 移动进节点
+    template<typename... Args>
+    int emplace(const K& key, Args&&... args);                         // 不存在时用 args 原地构造 value
+    int put_if_absent(const K& key, const V& value);                   // 仅在不存在时插入
+    bool compare_and_swap(const K& key, const V& expected, const V& desired);
+    template<typename MergeOp>
+    int merge(const K& key, const V& operand, MergeOp op);             // 读-改-写合并
+
     void display_list();
     bool search_element(K);
+
+    // 原地读取 value，不复制
+    // find 返回节点内 value 的指针，不存在时为 nullptr；指针在该 key 被删除或覆盖前有效
+    const V* find(const K& key);
+    // get 在锁内以 visitor(const V&) 访问 value，返回 key 是否存在
+    template<typename Visitor>
+    bool get(const K& key, Visitor visitor);
+    // 批量查找：found[i] 表示 keys[i] 是否存在，存在时写入 values[i]，返回命中个数
+    int multi_get(const K* keys, size_t count, V* values, bool* found);
     void delete_element(K);
+    // 删除 [lo, hi] 内的所有元素，返回删除个数；写锁内只做 O(log n) 的整段摘除，节点在释放写锁后批量释放
+    int delete_range(const K& lo, const K& hi);
     void dump_file();
+    // 逐行解析快照，每满 LOAD_CHUNK 个元素调用一次 bulk_load，峰值内存与快照大小无关
     void load_file();
+    static const size_t LOAD_CHUNK = 4096;
     //递归删除节点
     void clear(Node<K,V>*);
     int size();
+
+    // 日志策略对象，用于 flush 或读取策略自身的统计
+    LogPolicy& logger() { return _logger; }
     
     // 新增：范围查询功能
     std::vector<std::pair<K, V>> range_query(K start_key, K end_key);
 
+    // 批量导入：[first, last) 为按 key 升序的 (key, value) 序列，整批只加一次写锁、不输出日志
+    // key 大于表尾时直接接到各层尾部，整体 O(n)；乱序或与已有 key 重叠的部分按普通插入处理，已存在的 key 跳过
+    // balanced 为 true 时追加节点的层级由其位置决定（LevelGenerator::balanced_level），塔完全平衡
+    // 迭代器为 std::move_iterator 时 value 移动进节点；返回插入的元素个数
+    template<typename InputIt>
+    int bulk_load(InputIt first, InputIt last, bool balanced = false);
+
+    // 排名查询（基于每层跨度，均为 O(log n)）
+    int rank(const K& key);                              // 小于 key 的元素个数，key 存在时即其 0 基排名
+    bool select(int k, K* key, V* value);                // 第 k 个元素（0 基），越界返回 false
+    int count_range(const K& start_key, const K& end_key);   // [start_key, end_key] 内的元素个数
+    std::vector<std::pair<K, V>> page(int offset, int limit); // 按位置分页，返回第 offset 起最多 limit 个元素
+
+    // 降序范围查询：[lo, hi] 内最大的至多 limit 个元素，按 key 降序，O(log n + m)
+    std::vector<std::pair<K, V>> range_query_desc(const K& hi, const K& lo,
+                                                  int limit = std::numeric_limits<int>::max());
+
+    /**
+     * @brief 流式游标 - 沿第 0 层逐个访问元素，不复制 value、不分配内存
+     *
+     * 游标不加锁，遍历期间不能有并发写入。
+     * 向后 seek 从游标当前节点出发（finger 查找），按 key 递增顺序 seek 时每次摊还 O(1)。
+     */
+    class Cursor {
+    public:
+        void seek(const K& key);        // 定位到第一个 >= key 的元素
+        void seek_to_first();
+        void seek_to_rank(int k);       // 定位到第 k 个元素（0 基），O(log n)
+        bool valid() const;
+        void next();
+        const K& key() const;
+        const V& value() const;
+
+    private:
+        friend class SkipList<K, V, LogPolicy, LockPolicy>;
+        explicit Cursor(SkipList<K, V, LogPolicy, LockPolicy>* list) : _list(list), _node(nullptr) {}
+
+        SkipList<K, V, LogPolicy, LockPolicy>* _list;
+        Node<K, V>* _node;
+    };
+
+    // 创建游标，初始状态无效，需先 seek
+    Cursor cursor();
+
+    /**
+     * @brief 反向游标 - 按 key 降序逐个访问元素
+     *
+     * 节点只有前向指针，不额外存放反向指针：借助每层跨度按排名定位到当前块之前第 BLOCK 个节点（O(log n)），
+     * 再沿第 0 层正向读入一块节点指针，逆序返回。每个元素摊还 O(1 + log n / BLOCK)。
+     * 与 Cursor 相同，不加锁，遍历期间不能有并发写入。
+     */
+    class ReverseCursor {
+    public:
+        void seek(const K& key);        // 定位到最后一个 <= key 的元素
+        void seek_to_last();
+        bool valid() const;
+        void next();                    // 移到前一个（key 更小的）元素
+        const K& key() const;
+        const V& value() const;
+
+    private:
+        friend class SkipList<K, V, LogPolicy, LockPolicy>;
+        explicit ReverseCursor(SkipList<K, V, LogPolicy, LockPolicy>* list) : _list(list), _start(0), _pos(-1) {}
+
+        // 读入排名在 [end - BLOCK, end) 内的节点，定位到其中最后一个
+        void load_block(int end);
+
+        static const int BLOCK = 64;
+        SkipList<K, V, LogPolicy, LockPolicy>* _list;
+        std::vector<Node<K, V>*> _block;
+        int _start;                     // _block[0] 的排名
+        int _pos;                       // 当前元素在 _block 中的下标，-1 表示无效
+    };
+
+    // 创建反向游标，初始状态无效，需先 seek
+    ReverseCursor reverse_cursor();
+
 private:
     void get_key_value_from_string(const std::string& str, std::string* key, std::string* value);
     bool is_valid_string(const std::string& str);
 
+    // 小于（inclusive 时为小于等于）key 的元素个数
+    int count_less(const K& key, bool inclusive);
+
+    // 第 k 个节点（0 基），越界返回 nullptr
+    Node<K, V>* select_node(int k);
+
+    // 一次下降查找或插入，调用方需持有写锁
+    // 仅在插入时用 args 原地构造 value，key 已存在时 args 不被使用
+    template<typename... Args>
+    Node<K, V>* find_or_insert(const K& key, bool* inserted, Args&&... args);
+
+    // put 的左值/右值两个重载共用的实现
+    template<typename VArg>
+    int put_value(const K& key, VArg&& value);
+
+    // 第 0 层 key 对应的节点，不存在时返回 nullptr
+    Node<K, V>* find_node(const K& key) const;
+
+    // 下降到 key 在第 0 层的前驱（最后一个 < key 的节点），以 finger 为起点
+    // update/rank 非空时记录每层的前驱及其排名；写操作传入 _finger/_finger_rank，下降即完成 finger 的更新
+    // 调用方需持有读锁（只读 finger）或写锁
+    Node<K, V>* descend(const K& key, Node<K, V>** update, int* rank) const;
+
+    // 批量导入的尾部追加：find_tail 把各层最后一个节点及其排名写入 finger（+∞ 的前驱路径），
+    // 追加期间尾节点的跨度只算到新节点为止，seal_tail 补齐为“之后剩余的元素个数”
+    void find_tail();
+    void seal_tail();
+
 private:    
     // Maximum level of the skip list 
     int _max_level;
 
+    // random level generator
+    LevelGenerator _level_generator;
+
     // current level of skip list 
     int _skip_list_level;
 
     // pointer to header node 
     Node<K, V> *_header;
 
+    // finger：上一次写操作在各层的前驱及其排名，只在写锁下修改
+    // 所有结构修改都经过 descend 并把路径写回这里，路径在两次写操作之间始终有效
+    std::vector<Node<K, V>*> _finger;
+    std::vector<int> _finger_rank;
+
     // file operator
     std::ofstream _file_writer;
     std::ifstream _file_reader;
 
     // skiplist current element count
     int _element_count;
+
+    // 编译期选择的日志策略，NullLogger 时插入/查找/删除路径上没有日志代码
+    LogPolicy _logger;
+
+    // 实例级锁：写操作持写锁，查询持读锁（仅 SharedMutexLock 的读锁可并行）
+    LockPolicy _lock;
 };
 
 // create new node 
-template<typename K, typename V>
-Node<K, V>* SkipList<K, V>::create_node(const K k, const V v, int level) {
-    Node<K, V> *n = new Node<K, V>(k, v, level);
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+Node<K, V>* SkipList<K, V, LogPolicy, LockPolicy>::create_node(const K& k, const V& v, int level) {
+    Node<K, V> *n = Node<K, V>::create(k, v, level);
     return n;
 }
 
@@ -156,75 +394,179 @@ level 0         1    4   9 10         30   40  | 50 |  60      70       100
                                                +----+
 
 */
-template<typename K, typename V>
-int SkipList<K, V>::insert_element(const K key, const V value) {
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+int SkipList<K, V, LogPolicy, LockPolicy>::insert_element(const K key, V value) {
     
-    mtx.lock();
-    Node<K, V> *current = this->_header;
+    _lock.lock();
+    bool inserted = false;
+    Node<K, V>* node = find_or_insert(key, &inserted, std::move(value));
+
+    // if current node have key equal to searched key, we get it
+    if (!inserted) {
+        _logger.log("key: ", key, ", exists");
+        _lock.unlock();
+        return 1;
+    }
+
+    _logger.log("Successfully inserted key:", key, ", value:", node->get_value_ref());
+    _lock.unlock();
+    return 0;
+}
 
-    // create update array and initialize it 
+// 一次下降定位 key：已存在时返回该节点；不存在时以 V(args...) 插入并返回新节点
+// 调用方需持有写锁
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+template<typename... Args>
+Node<K, V>* SkipList<K, V, LogPolicy, LockPolicy>::find_or_insert(const K& key, bool* inserted, Args&&... args) {
+    
     // update is array which put node that the node->forward[i] should be operated later
-    Node<K, V> *update[_max_level+1];
-    memset(update, 0, sizeof(Node<K, V>*)*(_max_level+1));  
+    // update 与 rank 就是 finger：本次下降的路径留给下一次写操作作为起点
+    Node<K, V> **update = _finger.data();
 
-    // start form highest level of skip list 
-    for(int i = _skip_list_level; i >= 0; i--) {
-        while(current->forward[i] != NULL && current->forward[i]->get_key() < key) {
-            current = current->forward[i]; 
-        }
-        update[i] = current;
-    }
+    // rank[i] 为 update[i] 之前的元素个数，用于计算新节点各层的跨度
+    int *rank = _finger_rank.data();
+
+    // 从 finger 开始下降，key 紧随上次写入的 key 时只需检查最低的几层
+    Node<K, V> *current = descend(key, update, rank);
 
     // reached level 0 and forward pointer to right node, which is desired to insert key.
     current = current->forward[0];
 
     // if current node have key equal to searched key, we get it
-    if (current != NULL && current->get_key() == key) {
-        std::cout << "key: " << key << ", exists" << std::endl;
-        mtx.unlock();
-        return 1;
+    if (current != NULL && current->get_key_ref() == key) {
+        *inserted = false;
+        return current;
     }
 
     // if current is NULL that means we have reached to end of the level 
     // if current's key is not equal to key that means we have to insert node between update[0] and current node 
-    if (current == NULL || current->get_key() != key ) {
-        
-        // Generate a random level for node
-        int random_level = get_random_level();
-
-        // If random level is greater thar skip list's current level, initialize update value with pointer to header
-        if (random_level > _skip_list_level) {
-            for (int i = _skip_list_level+1; i < random_level+1; i++) {
-                update[i] = _header;
-            }
-            _skip_list_level = random_level;
+    // Generate a random level for node
+    int random_level = get_random_level();
+
+    // If random level is greater thar skip list's current level, initialize update value with pointer to header
+    if (random_level > _skip_list_level) {
+        for (int i = _skip_list_level+1; i < random_level+1; i++) {
+            rank[i] = 0;
+            update[i] = _header;
+            update[i]->span()[i] = _element_count;
         }
+        _skip_list_level = random_level;
+    }
+
+    // create new node with random level generated，value 在节点内原地构造
+    Node<K, V>* inserted_node = Node<K, V>::emplace(random_level, key, std::forward<Args>(args)...);
+    
+    // insert node，新节点拆分前驱原有的跨度
+    for (int i = 0; i <= random_level; i++) {
+        inserted_node->forward[i] = update[i]->forward[i];
+        update[i]->forward[i] = inserted_node;
+
+        inserted_node->span()[i] = update[i]->span()[i] - (rank[0] - rank[i]);
+        update[i]->span()[i] = (rank[0] - rank[i]) + 1;
+    }
+
+    // 新节点没有到达的层，前驱跨度加一
+    for (int i = random_level + 1; i <= _skip_list_level; i++) {
+        update[i]->span()[i]++;
+    }
+    _element_count ++;
+    *inserted = true;
+    return inserted_node;
+}
 
-        // create new node with random level generated 
-        Node<K, V>* inserted_node = create_node(key, value, random_level);
-        
-        // insert node 
-        for (int i = 0; i <= random_level; i++) {
-            inserted_node->forward[i] = update[i]->forward[i];
-            update[i]->forward[i] = inserted_node;
+// 写入并覆盖：key 不存在时插入，存在时原地更新 value
+// return 0 means inserted, return 1 means overwritten
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+int SkipList<K, V, LogPolicy, LockPolicy>::put(const K& key, const V& value) {
+    return put_value(key, value);
+}
+
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+int SkipList<K, V, LogPolicy, LockPolicy>::put(const K& key, V&& value) {
+    return put_value(key, std::move(value));
+}
+
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+template<typename VArg>
+int SkipList<K, V, LogPolicy, LockPolicy>::put_value(const K& key, VArg&& value) {
+    std::lock_guard<LockPolicy> lock(_lock);
+    bool inserted = false;
+    // 插入时 value 被转发进新节点，此后不再使用
+    Node<K, V>* node = find_or_insert(key, &inserted, std::forward<VArg>(value));
+    if (!inserted) {
+        node->set_value(std::forward<VArg>(value));
+    }
+    return inserted ? 0 : 1;
+}
+
+// 原地构造：key 不存在时以 V(args...) 插入，存在时不构造 value
+// return 0 means inserted, return 1 means element exists
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+template<typename... Args>
+int SkipList<K, V, LogPolicy, LockPolicy>::emplace(const K& key, Args&&... args) {
+    std::lock_guard<LockPolicy> lock(_lock);
+    bool inserted = false;
+    find_or_insert(key, &inserted, std::forward<Args>(args)...);
+    return inserted ? 0 : 1;
+}
+
+// 仅在 key 不存在时插入，与 insert_element 语义相同但不输出日志
+// return 0 means inserted, return 1 means element exists
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+int SkipList<K, V, LogPolicy, LockPolicy>::put_if_absent(const K& key, const V& value) {
+    std::lock_guard<LockPolicy> lock(_lock);
+    bool inserted = false;
+    find_or_insert(key, &inserted, value);
+    return inserted ? 0 : 1;
+}
+
+// 比较并交换：key 存在且当前 value 等于 expected 时替换为 desired
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+bool SkipList<K, V, LogPolicy, LockPolicy>::compare_and_swap(const K& key, const V& expected, const V& desired) {
+    std::lock_guard<LockPolicy> lock(_lock);
+    Node<K, V>* current = _header;
+    for (int i = _skip_list_level; i >= 0; i--) {
+        while (current->forward[i] != NULL && current->forward[i]->get_key_ref() < key) {
+            current = current->forward[i];
         }
-        std::cout << "Successfully inserted key:" << key << ", value:" << value << std::endl;
-        _element_count ++;
     }
-    mtx.unlock();
-    return 0;
+    current = current->forward[0];
+    if (current == NULL || !(current->get_key_ref() == key) || !(current->get_value_ref() == expected)) {
+        return false;
+    }
+    current->set_value(desired);
+    return true;
+}
+
+/**
+ * @brief 合并写入：key 不存在时插入 operand，存在时 value = op(value, operand)
+ * 
+ * op 需满足结合律（如计数器累加），在写锁内一次下降完成读-改-写。
+ * return 0 means inserted, return 1 means merged
+ */
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+template<typename MergeOp>
+int SkipList<K, V, LogPolicy, LockPolicy>::merge(const K& key, const V& operand, MergeOp op) {
+    std::lock_guard<LockPolicy> lock(_lock);
+    bool inserted = false;
+    Node<K, V>* node = find_or_insert(key, &inserted, operand);
+    if (!inserted) {
+        node->set_value(op(node->get_value_ref(), operand));
+    }
+    return inserted ? 0 : 1;
 }
 
 // Display skip list 
-template<typename K, typename V> 
-void SkipList<K, V>::display_list() {
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+void SkipList<K, V, LogPolicy, LockPolicy>::display_list() {
+    std::shared_lock<LockPolicy> lock(_lock);
 
     std::cout << "\n*****Skip List*****"<<"\n"; 
     for (int i = 0; i <= _skip_list_level; i++) {
         Node<K, V> *node = this->_header->forward[i]; 
         std::cout << "Level " << i << ": ";
         while (node != NULL) {
-            std::cout << node->get_key() << ":" << node->get_value() << ";";
+            std::cout << node->get_key_ref() << ":" << node->get_value_ref() << ";";
             node = node->forward[i];
         }
         std::cout << std::endl;
@@ -232,16 +574,17 @@ void SkipList<K, V>::display_list() {
 }
 
 // Dump data in memory to file 
-template<typename K, typename V> 
-void SkipList<K, V>::dump_file() {
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+void SkipList<K, V, LogPolicy, LockPolicy>::dump_file() {
+    std::shared_lock<LockPolicy> lock(_lock);
 
     std::cout << "dump_file-----------------" << std::endl;
     _file_writer.open(STORE_FILE);
     Node<K, V> *node = this->_header->forward[0]; 
 
     while (node != NULL) {
-        _file_writer << node->get_key() << ":" << node->get_value() << "\n";
-        std::cout << node->get_key() << ":" << node->get_value() << ";\n";
+        _file_writer << node->get_key_ref() << ":" << node->get_value_ref() << "\n";
+        std::cout << node->get_key_ref() << ":" << node->get_value_ref() << ";\n";
         node = node->forward[0];
     }
 
@@ -251,8 +594,8 @@ void SkipList<K, V>::dump_file() {
 }
 
 // Load data from disk
-template<typename K, typename V> 
-void SkipList<K, V>::load_file() {
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+void SkipList<K, V, LogPolicy, LockPolicy>::load_file() {
 
     _file_reader.open(STORE_FILE);
     std::cout << "load_file-----------------" << std::endl;
@@ -260,27 +603,117 @@ void SkipList<K, V>::load_file() {
     // 使用智能指针自动管理内存
     std::unique_ptr<std::string> key(new std::string());
     std::unique_ptr<std::string> value(new std::string());
+    // dump_file 按 key 升序写出，按块批量导入：各块依次接到表尾，整体仍为追加模式
+    std::vector<std::pair<K, V>> entries;
+    entries.reserve(LOAD_CHUNK);
     while (getline(_file_reader, line)) {
         get_key_value_from_string(line, key.get(), value.get());
         if (key->empty() || value->empty()) {
             continue;
         }
         // Define key as int type
-        insert_element(stoi(*key), *value);
-        std::cout << "key:" << *key << "value:" << *value << std::endl;
+        entries.emplace_back(stoi(*key), *value);
+        _logger.log("key:", *key, "value:", *value);
+        if (entries.size() == LOAD_CHUNK) {
+            bulk_load(std::make_move_iterator(entries.begin()), std::make_move_iterator(entries.end()));
+            entries.clear();
+        }
     }
     // 智能指针自动释放，无需手动delete
     _file_reader.close();
+    bulk_load(std::make_move_iterator(entries.begin()), std::make_move_iterator(entries.end()));
+}
+
+/**
+ * @brief 有序批量导入
+ *
+ * 追加模式下 finger 即各层的尾节点：新节点接到 0..level 层的尾部并成为新的尾节点，
+ * 每个元素只做一次比较和 level + 1 次指针赋值，不从头节点下降，也不逐层更新更高层的跨度。
+ * 遇到不大于表尾的 key 时先补齐尾部跨度，再按普通插入处理；普通插入落在表尾后重新进入追加模式。
+ */
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+template<typename InputIt>
+int SkipList<K, V, LogPolicy, LockPolicy>::bulk_load(InputIt first, InputIt last, bool balanced) {
+    std::lock_guard<LockPolicy> lock(_lock);
+    Node<K, V>** tail = _finger.data();
+    int* tail_rank = _finger_rank.data();
+    int loaded = 0;
+
+    find_tail();
+    bool appending = true;
+    for (; first != last; ++first) {
+        const K& key = (*first).first;
+        if (appending && tail[0] != _header && !(tail[0]->get_key_ref() < key)) {
+            seal_tail();
+            appending = false;
+        }
+
+        if (!appending) {
+            bool inserted = false;
+            Node<K, V>* node = find_or_insert(key, &inserted, (*first).second);
+            loaded += inserted ? 1 : 0;
+            if (node->forward[0] == nullptr) {
+                find_tail();
+                appending = true;
+            }
+            continue;
+        }
+
+        int position = _element_count + 1;
+        int level = balanced ? _level_generator.balanced_level(position) : get_random_level();
+        if (level > _skip_list_level) {
+            for (int i = _skip_list_level + 1; i <= level; i++) {
+                tail[i] = _header;
+                tail_rank[i] = 0;
+            }
+            _skip_list_level = level;
+        }
+
+        Node<K, V>* node = Node<K, V>::emplace(level, key, (*first).second);
+        for (int i = 0; i <= level; i++) {
+            tail[i]->forward[i] = node;
+            tail[i]->span()[i] = position - tail_rank[i];
+            tail[i] = node;
+            tail_rank[i] = position;
+        }
+        _element_count++;
+        loaded++;
+    }
+    if (appending) {
+        seal_tail();
+    }
+    return loaded;
+}
+
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+void SkipList<K, V, LogPolicy, LockPolicy>::find_tail() {
+    Node<K, V>* current = _header;
+    int traversed = 0;
+    for (int i = _skip_list_level; i >= 0; i--) {
+        while (current->forward[i] != nullptr) {
+            traversed += current->span()[i];
+            current = current->forward[i];
+        }
+        _finger[i] = current;
+        _finger_rank[i] = traversed;
+    }
+}
+
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+void SkipList<K, V, LogPolicy, LockPolicy>::seal_tail() {
+    for (int i = 0; i <= _skip_list_level; i++) {
+        _finger[i]->span()[i] = _element_count - _finger_rank[i];
+    }
 }
 
 // Get current SkipList size
-template<typename K, typename V> 
-int SkipList<K, V>::size() { 
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+int SkipList<K, V, LogPolicy, LockPolicy>::size() { 
     return _element_count;
 }
 
-template<typename K, typename V>
-void SkipList<K, V>::get_key_value_from_string(const std::string& str, std::string* key, std::string* value) {
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+void SkipList<K, V, LogPolicy, LockPolicy>::get_key_value_from_string(const std::string& str, std::string* key, std::string* value) {
 
     if(!is_valid_string(str)) {
         return;
@@ -289,8 +722,8 @@ void SkipList<K, V>::get_key_value_from_string(const std::string& str, std::stri
     *value = str.substr(str.find(delimiter)+1, str.length());
 }
 
-template<typename K, typename V>
-bool SkipList<K, V>::is_valid_string(const std::string& str) {
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+bool SkipList<K, V, LogPolicy, LockPolicy>::is_valid_string(const std::string& str) {
 
     if (str.empty()) {
         return false;
@@ -301,34 +734,99 @@ bool SkipList<K, V>::is_valid_string(const std::string& str) {
     return true;
 }
 
-// Delete element from skip list 
-template<typename K, typename V> 
-void SkipList<K, V>::delete_element(K key) {
+/**
+ * @brief 范围删除
+ *
+ * 两次下降得到 lo 和 hi 两侧的路径：update[i] 为第 i 层最后一个 < lo 的节点，last[i] 为最后一个 <= hi 的节点。
+ * 区间在第 i 层有节点时令 update[i] 直接指向 last[i] 的后继，整段摘除；跨度按两侧排名之差一次算出。
+ * 写锁内的工作与区间大小无关；被摘下的第 0 层链表在释放写锁后逐个释放。
+ */
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+int SkipList<K, V, LogPolicy, LockPolicy>::delete_range(const K& lo, const K& hi) {
+    if (hi < lo) {
+        return 0;
+    }
 
-    mtx.lock();
-    Node<K, V> *current = this->_header; 
-    Node<K, V> *update[_max_level+1];
-    memset(update, 0, sizeof(Node<K, V>*)*(_max_level+1));
+    Node<K, V>* detached = nullptr;
+    int removed = 0;
+    {
+        std::lock_guard<LockPolicy> lock(_lock);
+        // lo 一侧的路径写入 finger：摘除后各层前驱及其排名不变
+        Node<K, V>** update = _finger.data();
+        int* rank = _finger_rank.data();
+        descend(lo, update, rank);
+
+        // hi 一侧从 lo 的路径继续向后找，不必从头节点下降
+        std::vector<Node<K, V>*> last(_skip_list_level + 1);
+        std::vector<int> last_rank(_skip_list_level + 1);
+        Node<K, V>* current = update[_skip_list_level];
+        int traversed = rank[_skip_list_level];
+        for (int i = _skip_list_level; i >= 0; i--) {
+            if (rank[i] > traversed) {
+                current = update[i];
+                traversed = rank[i];
+            }
+            while (current->forward[i] != nullptr && !(hi < current->forward[i]->get_key_ref())) {
+                traversed += current->span()[i];
+                current = current->forward[i];
+            }
+            last[i] = current;
+            last_rank[i] = traversed;
+        }
 
-    // start from highest level of skip list
-    for (int i = _skip_list_level; i >= 0; i--) {
-        while (current->forward[i] !=NULL && current->forward[i]->get_key() < key) {
-            current = current->forward[i];
+        removed = last_rank[0] - rank[0];
+        if (removed == 0) {
+            return 0;
         }
-        update[i] = current;
+        detached = update[0]->forward[0];
+
+        for (int i = 0; i <= _skip_list_level; i++) {
+            if (last[i] != update[i]) {
+                // 新跨度 = update[i] 到 last[i] 后继的距离减去删除个数
+                update[i]->span()[i] = last_rank[i] + last[i]->span()[i] - rank[i] - removed;
+                update[i]->forward[i] = last[i]->forward[i];
+            } else {
+                update[i]->span()[i] -= removed;
+            }
+        }
+
+        while (_skip_list_level > 0 && _header->forward[_skip_list_level] == 0) {
+            _skip_list_level --;
+        }
+        _element_count -= removed;
+        _logger.log("Successfully deleted ", removed, " keys in [", lo, ", ", hi, "]");
     }
 
+    // 摘下的节点已不可达，释放时不持锁
+    for (int i = 0; i < removed; i++) {
+        Node<K, V>* next = detached->forward[0];
+        Node<K, V>::destroy(detached);
+        detached = next;
+    }
+    return removed;
+}
+
+// Delete element from skip list 
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+void SkipList<K, V, LogPolicy, LockPolicy>::delete_element(K key) {
+
+    _lock.lock();
+    // 删除后各层前驱及其排名不变，路径仍可作为 finger
+    Node<K, V> **update = _finger.data();
+    Node<K, V> *current = descend(key, update, _finger_rank.data());
+
     current = current->forward[0];
-    if (current != NULL && current->get_key() == key) {
+    if (current != NULL && current->get_key_ref() == key) {
        
         // start for lowest level and delete the current node of each level
+        // 被删节点所在层合并跨度，其余层前驱跨度减一
         for (int i = 0; i <= _skip_list_level; i++) {
-
-            // if at level i, next node is not target node, break the loop.
-            if (update[i]->forward[i] != current) 
-                break;
-
-            update[i]->forward[i] = current->forward[i];
+            if (update[i]->forward[i] == current) {
+                update[i]->span()[i] += current->span()[i] - 1;
+                update[i]->forward[i] = current->forward[i];
+            } else {
+                update[i]->span()[i]--;
+            }
         }
 
         // Remove levels which have no elements
@@ -336,11 +834,11 @@ void SkipList<K, V>::delete_element(K key) {
             _skip_list_level --; 
         }
 
-        std::cout << "Successfully deleted key "<< key << std::endl;
-        delete current;
+        _logger.log("Successfully deleted key ", key);
+        Node<K, V>::destroy(current);
         _element_count --;
     }
-    mtx.unlock();
+    _lock.unlock();
     return;
 }
 
@@ -363,48 +861,403 @@ level 1         1    4     10         30         50|           70       100
                                                    |
 level 0         1    4   9 10         30   40    50+-->60      70       100
 */
-template<typename K, typename V> 
-bool SkipList<K, V>::search_element(K key) {
-
-    std::cout << "search_element-----------------" << std::endl;
-    Node<K, V> *current = _header;
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+bool SkipList<K, V, LogPolicy, LockPolicy>::search_element(K key) {
+    std::shared_lock<LockPolicy> lock(_lock);
 
-    // start from highest level of skip list
-    for (int i = _skip_list_level; i >= 0; i--) {
-        while (current->forward[i] && current->forward[i]->get_key() < key) {
-            current = current->forward[i];
-        }
-    }
+    _logger.log("search_element-----------------");
+    // 读锁下 finger 不会被修改，查询只读使用
+    Node<K, V> *current = descend(key, nullptr, nullptr);
 
     //reached level 0 and advance pointer to right node, which we search
     current = current->forward[0];
 
     // if current node have key equal to searched key, we get it
-    if (current and current->get_key() == key) {
-        std::cout << "Found key: " << key << ", value: " << current->get_value() << std::endl;
+    if (current and current->get_key_ref() == key) {
+        _logger.log("Found key: ", key, ", value: ", current->get_value_ref());
         return true;
     }
 
-    std::cout << "Not Found Key:" << key << std::endl;
+    _logger.log("Not Found Key:", key);
     return false;
 }
 
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+Node<K, V>* SkipList<K, V, LogPolicy, LockPolicy>::find_node(const K& key) const {
+    Node<K, V>* current = descend(key, nullptr, nullptr)->forward[0];
+    if (current != nullptr && current->get_key_ref() == key) {
+        return current;
+    }
+    return nullptr;
+}
+
+/**
+ * @brief finger 查找：从上一次写操作的路径出发，而不是每次从 _header 的最高层出发
+ *
+ * finger 中各层前驱的 key 都小于上次写入的 key。新 key 比它大时自底向上检查 finger，
+ * 找到第一层 top，使 finger[top] 在该层的后继不小于 key：此时 finger[top..] 都是 key 在对应层的前驱，
+ * 只需从 top 层向下查找；更低层若 finger 中的前驱更靠后则直接跳过去。
+ * 顺序递增写入时 top 通常为 0 或 1，每次操作摊还 O(1)；与上次 key 距离为 d 时期望 O(log d)。
+ * 新 key 不大于上次写入的 key 时退回从 _header 下降。
+ */
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+Node<K, V>* SkipList<K, V, LogPolicy, LockPolicy>::descend(const K& key, Node<K, V>** update, int* rank) const {
+    int level = _skip_list_level;
+    bool from_finger = _finger[0] == _header || _finger[0]->get_key_ref() < key;
+
+    int top = level;
+    if (from_finger) {
+        top = 0;
+        while (top < level && _finger[top]->forward[top] != nullptr &&
+               _finger[top]->forward[top]->get_key_ref() < key) {
+            top++;
+        }
+    }
+
+    Node<K, V>* current = from_finger ? _finger[top] : _header;
+    int traversed = from_finger ? _finger_rank[top] : 0;
+    for (int i = top; i >= 0; i--) {
+        if (from_finger && _finger_rank[i] > traversed) {
+            current = _finger[i];
+            traversed = _finger_rank[i];
+        }
+        while (current->forward[i] != nullptr && current->forward[i]->get_key_ref() < key) {
+            traversed += current->span()[i];
+            current = current->forward[i];
+        }
+        if (update != nullptr) {
+            update[i] = current;
+            rank[i] = traversed;
+        }
+    }
+    return current;
+}
+
+// 查找期间持读锁，返回的指针指向节点内的 value
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+const V* SkipList<K, V, LogPolicy, LockPolicy>::find(const K& key) {
+    std::shared_lock<LockPolicy> lock(_lock);
+    Node<K, V>* node = find_node(key);
+    return node != nullptr ? &node->get_value_ref() : nullptr;
+}
+
+/**
+ * @brief 在读锁内以 visitor(const V&) 访问 value，不复制
+ * 
+ * visitor 执行期间写入被阻塞，不能在 visitor 中再调用本跳表的写接口。
+ */
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+template<typename Visitor>
+bool SkipList<K, V, LogPolicy, LockPolicy>::get(const K& key, Visitor visitor) {
+    std::shared_lock<LockPolicy> lock(_lock);
+    Node<K, V>* node = find_node(key);
+    if (node == nullptr) {
+        return false;
+    }
+    visitor(node->get_value_ref());
+    return true;
+}
+
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+int SkipList<K, V, LogPolicy, LockPolicy>::count_less(const K& key, bool inclusive) {
+    Node<K, V>* current = _header;
+    int traversed = 0;
+    for (int i = _skip_list_level; i >= 0; i--) {
+        while (current->forward[i] != nullptr &&
+               (current->forward[i]->get_key_ref() < key ||
+                (inclusive && current->forward[i]->get_key_ref() == key))) {
+            traversed += current->span()[i];
+            current = current->forward[i];
+        }
+    }
+    return traversed;
+}
+
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+Node<K, V>* SkipList<K, V, LogPolicy, LockPolicy>::select_node(int k) {
+    if (k < 0 || k >= _element_count) {
+        return nullptr;
+    }
+
+    // 第 k 个节点即从头节点起跨过 k + 1 步的节点
+    Node<K, V>* current = _header;
+    int traversed = 0;
+    for (int i = _skip_list_level; i >= 0; i--) {
+        while (current->forward[i] != nullptr && traversed + current->span()[i] <= k + 1) {
+            traversed += current->span()[i];
+            current = current->forward[i];
+        }
+        if (traversed == k + 1) {
+            return current;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief 排名查询 - 小于 key 的元素个数
+ * 
+ * 沿查找路径累加每层跨度，时间复杂度 O(log n)。
+ * key 存在时返回值即为它的 0 基排名。
+ */
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+int SkipList<K, V, LogPolicy, LockPolicy>::rank(const K& key) {
+    std::shared_lock<LockPolicy> lock(_lock);
+    return count_less(key, false);
+}
+
+/**
+ * @brief 按位置查询第 k 个元素（0 基），O(log n)
+ */
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+bool SkipList<K, V, LogPolicy, LockPolicy>::select(int k, K* key, V* value) {
+    std::shared_lock<LockPolicy> lock(_lock);
+    Node<K, V>* node = select_node(k);
+    if (node == nullptr) {
+        return false;
+    }
+    *key = node->get_key_ref();
+    *value = node->get_value_ref();
+    return true;
+}
+
+/**
+ * @brief 区间计数 - [start_key, end_key] 内的元素个数
+ * 
+ * 两次 O(log n) 的排名查询相减，不遍历区间内的节点。
+ */
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+int SkipList<K, V, LogPolicy, LockPolicy>::count_range(const K& start_key, const K& end_key) {
+    if (start_key > end_key) {
+        return 0;
+    }
+    std::shared_lock<LockPolicy> lock(_lock);
+    return count_less(end_key, true) - count_less(start_key, false);
+}
+
+/**
+ * @brief 按位置分页 - 返回第 offset 个元素起最多 limit 个键值对
+ * 
+ * 先按跨度 O(log n) 定位起点，再在第 0 层顺序读取 limit 个元素。
+ */
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+std::vector<std::pair<K, V>> SkipList<K, V, LogPolicy, LockPolicy>::page(int offset, int limit) {
+    std::vector<std::pair<K, V>> result;
+    std::shared_lock<LockPolicy> lock(_lock);
+    Node<K, V>* current = select_node(offset);
+    while (current != nullptr && (int)result.size() < limit) {
+        result.push_back(std::make_pair(current->get_key_ref(), current->get_value_ref()));
+        current = current->forward[0];
+    }
+    return result;
+}
+
+/**
+ * @brief 降序范围查询
+ *
+ * [lo, hi] 内元素的排名为 [count_less(lo), count_less(hi, inclusive))，降序的前 limit 个即其中排名最大的 limit 个：
+ * 按排名定位到第一个要返回的节点（O(log n)），沿第 0 层正向读取 m 个后整体反转。
+ */
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+std::vector<std::pair<K, V>> SkipList<K, V, LogPolicy, LockPolicy>::range_query_desc(const K& hi, const K& lo, int limit) {
+    std::vector<std::pair<K, V>> result;
+    if (hi < lo || limit <= 0) {
+        return result;
+    }
+
+    std::shared_lock<LockPolicy> lock(_lock);
+    int end = count_less(hi, true);
+    int begin = std::max(count_less(lo, false), end - limit);
+    if (begin >= end) {
+        return result;
+    }
+    result.reserve(end - begin);
+    Node<K, V>* current = select_node(begin);
+    for (int i = begin; i < end; i++) {
+        result.push_back(std::make_pair(current->get_key_ref(), current->get_value_ref()));
+        current = current->forward[0];
+    }
+    std::reverse(result.begin(), result.end());
+    return result;
+}
+
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+typename SkipList<K, V, LogPolicy, LockPolicy>::Cursor SkipList<K, V, LogPolicy, LockPolicy>::cursor() {
+    return Cursor(this);
+}
+
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+void SkipList<K, V, LogPolicy, LockPolicy>::Cursor::seek(const K& key) {
+    // 向后 seek 时以当前节点为 finger：沿塔向上、向右走到后继不小于 key 的层，再向下
+    // 代价与移动距离的对数成正比，顺序 seek 不必每次从头节点下降
+    if (_node != nullptr && _node->get_key_ref() < key) {
+        Node<K, V>* current = _node;
+        int i = 0;
+        while (true) {
+            while (i < current->node_level && current->forward[i + 1] != nullptr &&
+                   current->forward[i + 1]->get_key_ref() < key) {
+                i++;
+            }
+            if (current->forward[i] == nullptr || !(current->forward[i]->get_key_ref() < key)) {
+                break;
+            }
+            current = current->forward[i];
+        }
+        for (; i >= 0; i--) {
+            while (current->forward[i] != nullptr && current->forward[i]->get_key_ref() < key) {
+                current = current->forward[i];
+            }
+        }
+        _node = current->forward[0];
+        return;
+    }
+
+    Node<K, V>* current = _list->_header;
+    for (int i = _list->_skip_list_level; i >= 0; i--) {
+        while (current->forward[i] != nullptr && current->forward[i]->get_key_ref() < key) {
+            current = current->forward[i];
+        }
+    }
+    _node = current->forward[0];
+}
+
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+void SkipList<K, V, LogPolicy, LockPolicy>::Cursor::seek_to_first() {
+    _node = _list->_header->forward[0];
+}
+
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+void SkipList<K, V, LogPolicy, LockPolicy>::Cursor::seek_to_rank(int k) {
+    _node = _list->select_node(k);
+}
+
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+bool SkipList<K, V, LogPolicy, LockPolicy>::Cursor::valid() const {
+    return _node != nullptr;
+}
+
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+void SkipList<K, V, LogPolicy, LockPolicy>::Cursor::next() {
+    _node = _node->forward[0];
+}
+
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+const K& SkipList<K, V, LogPolicy, LockPolicy>::Cursor::key() const {
+    return _node->get_key_ref();
+}
+
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+const V& SkipList<K, V, LogPolicy, LockPolicy>::Cursor::value() const {
+    return _node->get_value_ref();
+}
+
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+typename SkipList<K, V, LogPolicy, LockPolicy>::ReverseCursor SkipList<K, V, LogPolicy, LockPolicy>::reverse_cursor() {
+    return ReverseCursor(this);
+}
+
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+void SkipList<K, V, LogPolicy, LockPolicy>::ReverseCursor::load_block(int end) {
+    _block.clear();
+    _start = std::max(0, end - BLOCK);
+    Node<K, V>* current = _list->select_node(_start);
+    for (int i = _start; i < end && current != nullptr; i++) {
+        _block.push_back(current);
+        current = current->forward[0];
+    }
+    _pos = (int)_block.size() - 1;
+}
+
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+void SkipList<K, V, LogPolicy, LockPolicy>::ReverseCursor::seek(const K& key) {
+    load_block(_list->count_less(key, true));
+}
+
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+void SkipList<K, V, LogPolicy, LockPolicy>::ReverseCursor::seek_to_last() {
+    load_block(_list->_element_count);
+}
+
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+bool SkipList<K, V, LogPolicy, LockPolicy>::ReverseCursor::valid() const {
+    return _pos >= 0;
+}
+
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+void SkipList<K, V, LogPolicy, LockPolicy>::ReverseCursor::next() {
+    if (_pos > 0) {
+        _pos--;
+    } else if (_start > 0) {
+        load_block(_start);
+    } else {
+        _pos = -1;
+    }
+}
+
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+const K& SkipList<K, V, LogPolicy, LockPolicy>::ReverseCursor::key() const {
+    return _block[_pos]->get_key_ref();
+}
+
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+const V& SkipList<K, V, LogPolicy, LockPolicy>::ReverseCursor::value() const {
+    return _block[_pos]->get_value_ref();
+}
+
+/**
+ * @brief 批量查找 - 一组 key 交错遍历并预取下一跳节点
+ *
+ * 与逐个调用 search_element 的结果一致，但各 key 的 cache miss 相互重叠，
+ * 适合一次处理几十到几百个 key 的请求。不输出日志。
+ */
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+int SkipList<K, V, LogPolicy, LockPolicy>::multi_get(const K* keys, size_t count, V* values, bool* found) {
+    Node<K, V>* nodes[BATCH_SEARCH_GROUP];
+    int hits = 0;
+    std::shared_lock<LockPolicy> lock(_lock);
+
+    for (size_t base = 0; base < count; base += BATCH_SEARCH_GROUP) {
+        size_t group = (count - base < (size_t)BATCH_SEARCH_GROUP) ? count - base : BATCH_SEARCH_GROUP;
+        batch_lower_bound(_header, _skip_list_level, keys + base, group, nodes);
+
+        for (size_t j = 0; j < group; j++) {
+            Node<K, V>* node = nodes[j];
+            found[base + j] = (node != nullptr && node->get_key_ref() == keys[base + j]);
+            if (found[base + j]) {
+                values[base + j] = node->get_value_ref();
+                hits++;
+            }
+        }
+    }
+    return hits;
+}
+
 // construct skip list
-template<typename K, typename V> 
-SkipList<K, V>::SkipList(int max_level) {
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+SkipList<K, V, LogPolicy, LockPolicy>::SkipList(int max_level) : _level_generator(max_level) {
 
     this->_max_level = max_level;
     this->_skip_list_level = 0;
     this->_element_count = 0;
 
     // create header node and initialize key and value to null
-    K k;
-    V v;
-    this->_header = new Node<K, V>(k, v, _max_level);
+    K k{};
+    V v{};
+    this->_header = Node<K, V>::create(k, v, _max_level);
+
+    // 空表时 finger 各层都指向头节点
+    this->_finger.assign(_max_level + 1, _header);
+    this->_finger_rank.assign(_max_level + 1, 0);
 };
 
-template<typename K, typename V> 
-SkipList<K, V>::~SkipList() {
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+SkipList<K, V, LogPolicy, LockPolicy>::SkipList(size_t expected_capacity, LevelProbability probability)
+    : SkipList(LevelGenerator::max_level_for(expected_capacity, probability)) {
+    _level_generator = LevelGenerator(_max_level, probability);
+}
+
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+SkipList<K, V, LogPolicy, LockPolicy>::~SkipList() {
 
     if (_file_writer.is_open()) {
         _file_writer.close();
@@ -413,33 +1266,37 @@ SkipList<K, V>::~SkipList() {
         _file_reader.close();
     }
 
-    //递归删除跳表链条
-    if(_header->forward[0]!=nullptr){
-        clear(_header->forward[0]);
-    }
-    delete(_header);
+    //沿第 0 层逐个删除跳表链条
+    clear(_header->forward[0]);
+    Node<K, V>::destroy(_header);
     
 }
-template <typename K, typename V>
-void SkipList<K, V>::clear(Node<K, V> * cur)
+template <typename K, typename V, typename LogPolicy, typename LockPolicy>
+void SkipList<K, V, LogPolicy, LockPolicy>::clear(Node<K, V> * cur)
 {
-    if(cur->forward[0]!=nullptr){
-        clear(cur->forward[0]);
+    // 迭代释放 cur 及其后的所有节点，栈深度与元素个数无关
+    while (cur != nullptr) {
+        Node<K, V>* next = cur->forward[0];
+        Node<K, V>::destroy(cur);
+        cur = next;
     }
-    delete(cur);
 }
 
-template<typename K, typename V>
-int SkipList<K, V>::get_random_level(){
-
-    int k = 1;
-    while (rand() % 2) {
-        k++;
-    }
-    k = (k < _max_level) ? k : _max_level;
-    return k;
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+int SkipList<K, V, LogPolicy, LockPolicy>::get_random_level(){
+    return _level_generator.next();
 };
 
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+void SkipList<K, V, LogPolicy, LockPolicy>::set_level_probability(LevelProbability probability) {
+    _level_generator = LevelGenerator(_max_level, probability);
+}
+
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+LevelProbability SkipList<K, V, LogPolicy, LockPolicy>::get_level_probability() const {
+    return _level_generator.probability();
+}
+
 /**
  * @brief 范围查询功能 - 查询[start_key, end_key]范围内的所有键值对
  * 
@@ -455,25 +1312,26 @@ int SkipList<K, V>::get_random_level(){
  * 2. 如果范围内没有元素，返回空vector
  * 3. 支持start_key == end_key的情况（单点查询）
  */
-template<typename K, typename V>
-std::vector<std::pair<K, V>> SkipList<K, V>::range_query(K start_key, K end_key) {
+template<typename K, typename V, typename LogPolicy, typename LockPolicy>
+std::vector<std::pair<K, V>> SkipList<K, V, LogPolicy, LockPolicy>::range_query(K start_key, K end_key) {
     
     std::vector<std::pair<K, V>> result;
     
     // 边界条件检查：如果起始键大于结束键，返回空结果
     if (start_key > end_key) {
-        std::cout << "Invalid range: start_key > end_key" << std::endl;
+        _logger.log("Invalid range: start_key > end_key");
         return result;
     }
     
-    std::cout << "range_query: [" << start_key << ", " << end_key << "]" << std::endl;
+    _logger.log("range_query: [", start_key, ", ", end_key, "]");
     
+    std::shared_lock<LockPolicy> lock(_lock);
     Node<K, V> *current = _header;
     
     // 第一步：从最高层开始，找到start_key的前驱节点
     // 这一步的时间复杂度是O(log n)
     for (int i = _skip_list_level; i >= 0; i--) {
-        while (current->forward[i] != NULL && current->forward[i]->get_key() < start_key) {
+        while (current->forward[i] != NULL && current->forward[i]->get_key_ref() < start_key) {
             current = current->forward[i];
         }
     }
@@ -483,12 +1341,12 @@ std::vector<std::pair<K, V>> SkipList<K, V>::range_query(K start_key, K end_key)
     
     // 第二步：在第0层顺序遍历，收集[start_key, end_key]范围内的所有节点
     // 这一步的时间复杂度是O(m)，m是结果集大小
-    while (current != NULL && current->get_key() <= end_key) {
-        result.push_back(std::make_pair(current->get_key(), current->get_value()));
+    while (current != NULL && current->get_key_ref() <= end_key) {
+        result.push_back(std::make_pair(current->get_key_ref(), current->get_value_ref()));
         current = current->forward[0];
     }
     
-    std::cout << "Found " << result.size() << " elements in range" << std::endl;
+    _logger.log("Found ", result.size(), " elements in range");
     return result;
 }
 
@@ -0,0 +1,527 @@
+/* ************************************************************************
+> File Name:     skiplist_lazy.h
+> Description:   惰性跳表实现（Lazy Skip List，乐观并发）
+>                1. 遍历不加锁，写线程只锁定 update[] 中的前驱节点
+>                2. 加锁后校验前驱/后继关系，校验失败则重试
+>                3. marked / fully_linked 标记保证查找 wait-free
+>                4. 摘除的节点通过纪元回收延迟释放
+ ************************************************************************/
+
+#ifndef SKIPLIST_LAZY_H
+#define SKIPLIST_LAZY_H
+
+#include <iostream>
+#include <cstdint>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "epoch_reclaim.h"
+#include "sharded_counter.h"
+#include "random_level.h"
+
+// 惰性跳表节点
+template<typename K, typename V>
+class NodeLazy {
+public:
+    NodeLazy(const K& k, const V& v, int level);
+    ~NodeLazy();
+
+    K get_key() const;
+    V get_value() const;
+
+    // 引用访问，供游标直接读取节点内的 key/value
+    const K& get_key_ref() const;
+    const V& get_value_ref() const;
+
+    NodeLazy<K, V>* next(int i) const;
+
+    // Linear array to hold pointers to next node of different level
+    std::atomic<NodeLazy<K, V>*>* forward;
+
+    int node_level;
+
+    std::mutex node_mutex;                   // 写线程锁定前驱/被删节点时使用
+    std::atomic<bool> marked;                // 已被逻辑删除
+    std::atomic<bool> fully_linked;          // 所有层均已链接完成
+
+private:
+    K key;
+    V value;
+};
+
+template<typename K, typename V>
+NodeLazy<K, V>::NodeLazy(const K& k, const V& v, int level)
+    : node_level(level), marked(false), fully_linked(false), key(k), value(v) {
+    // level + 1, because array index is from 0 - level
+    this->forward = new std::atomic<NodeLazy<K, V>*>[level + 1];
+    for (int i = 0; i <= level; i++) {
+        forward[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+template<typename K, typename V>
+NodeLazy<K, V>::~NodeLazy() {
+    delete[] forward;
+}
+
+template<typename K, typename V>
+K NodeLazy<K, V>::get_key() const {
+    return key;
+}
+
+template<typename K, typename V>
+V NodeLazy<K, V>::get_value() const {
+    return value;
+}
+
+template<typename K, typename V>
+const K& NodeLazy<K, V>::get_key_ref() const {
+    return key;
+}
+
+template<typename K, typename V>
+const V& NodeLazy<K, V>::get_value_ref() const {
+    return value;
+}
+
+template<typename K, typename V>
+NodeLazy<K, V>* NodeLazy<K, V>::next(int i) const {
+    return forward[i].load(std::memory_order_acquire);
+}
+
+// Class template for lazy skip list
+template<typename K, typename V>
+class SkipListLazy {
+public:
+    SkipListLazy(int max_level);
+    ~SkipListLazy();
+
+    int get_random_level();                              // [0, max_level]
+    // 设置分支因子（默认 1/2），只影响之后插入的节点，须在并发写入开始前调用
+    void set_level_probability(LevelProbability probability);
+    LevelProbability get_level_probability() const;
+    NodeLazy<K, V>* create_node(const K&, const V&, int);
+    int insert_element(const K&, const V&);
+    void display_list();
+    bool search_element(const K&);
+    bool search_element_silent(const K&);  // 静默查询，wait-free
+    void delete_element(const K&);
+    int size();
+
+    // 范围查询：返回 [start_key, end_key] 内已完全链接且未删除的键值对
+    std::vector<std::pair<K, V>> range_query(const K& start_key, const K& end_key);
+
+    /**
+     * @brief 流式游标 - 沿第 0 层逐个访问已完全链接且未删除的元素
+     *
+     * 与 search_element_silent 一样不加锁；游标存活期间持有纪元守卫，
+     * 停留的节点即使被并发删除也不会被回收。长时间扫描会推迟回收。
+     */
+    class Cursor {
+    public:
+        void seek(const K& key);        // 定位到第一个 >= key 的元素
+        void seek_to_first();
+        bool valid() const;
+        void next();
+        const K& key() const;
+        const V& value() const;
+
+    private:
+        friend class SkipListLazy<K, V>;
+        explicit Cursor(SkipListLazy<K, V>* list)
+            : _list(list), _guard(list->_epoch_manager.pin()), _node(nullptr) {}
+
+        // 跳过不可见节点
+        void skip_invisible();
+
+        SkipListLazy<K, V>* _list;
+        EpochManager::Guard _guard;
+        NodeLazy<K, V>* _node;
+    };
+
+    // 创建游标，初始状态无效，需先 seek
+    Cursor cursor();
+
+private:
+    typedef NodeLazy<K, V> NodeType;
+
+    // 无锁遍历，填充每层前驱/后继，返回找到 key 的最高层，未找到返回 -1
+    int find(const K& key, NodeType** preds, NodeType** succs);
+
+    // wait-free 定位，返回已完全链接且未删除的目标节点，不存在时返回 nullptr
+    NodeType* locate(const K& key);
+
+    // 锁定 preds[0..top_level]（同一节点只锁一次），返回已加锁节点列表
+    void lock_preds(NodeType** preds, int top_level, std::vector<NodeType*>* locked);
+    void unlock_preds(std::vector<NodeType*>* locked);
+
+    // 节点完全脱离跳表后回收
+    void retire_node(NodeType* node);
+
+private:
+    int _max_level;                                      // 跳表最大层级
+    LevelGenerator _level_generator;                     // 随机层级生成器，随机源为线程局部
+    std::atomic<int> _skip_list_level;                   // 当前最高非空层级（仅作查找起点提示）
+    NodeType* _header;                                   // 头节点指针
+    ShardedCounter _element_count;                       // 元素计数，各线程写自己的计数槽
+
+    // 已摘除但可能仍被并发读者引用的节点，宽限期结束后释放
+    EpochManager _epoch_manager;
+};
+
+template<typename K, typename V>
+SkipListLazy<K, V>::SkipListLazy(int max_level)
+    : _max_level(max_level),
+      _level_generator(max_level),
+      _skip_list_level(0) {
+    K k{};
+    V v{};
+    this->_header = new NodeType(k, v, _max_level);
+    this->_header->fully_linked.store(true, std::memory_order_relaxed);
+}
+
+// 析构时不存在并发访问，直接沿第 0 层释放
+template<typename K, typename V>
+SkipListLazy<K, V>::~SkipListLazy() {
+    NodeType* current = _header->next(0);
+    while (current != nullptr) {
+        NodeType* next = current->next(0);
+        delete current;
+        current = next;
+    }
+    delete _header;
+
+    _epoch_manager.drain();
+}
+
+template<typename K, typename V>
+NodeLazy<K, V>* SkipListLazy<K, V>::create_node(const K& k, const V& v, int level) {
+    return new NodeType(k, v, level);
+}
+
+// 获取随机层级
+// 使用线程局部随机源，避免 rand() 内部锁在多写线程下成为串行点
+template<typename K, typename V>
+int SkipListLazy<K, V>::get_random_level() {
+    return _level_generator.next();
+}
+
+template<typename K, typename V>
+void SkipListLazy<K, V>::set_level_probability(LevelProbability probability) {
+    _level_generator = LevelGenerator(_max_level, probability);
+}
+
+template<typename K, typename V>
+LevelProbability SkipListLazy<K, V>::get_level_probability() const {
+    return _level_generator.probability();
+}
+
+template<typename K, typename V>
+int SkipListLazy<K, V>::find(const K& key, NodeType** preds, NodeType** succs) {
+    int found_level = -1;
+    NodeType* pred = _header;
+    for (int i = _max_level; i >= 0; i--) {
+        NodeType* curr = pred->next(i);
+        while (curr != nullptr && curr->get_key() < key) {
+            pred = curr;
+            curr = pred->next(i);
+        }
+        if (found_level == -1 && curr != nullptr && curr->get_key() == key) {
+            found_level = i;
+        }
+        preds[i] = pred;
+        succs[i] = curr;
+    }
+    return found_level;
+}
+
+// 自底向上加锁：低层前驱的 key 不小于高层前驱，所有线程按 key 降序加锁，不会死锁
+template<typename K, typename V>
+void SkipListLazy<K, V>::lock_preds(NodeType** preds, int top_level, std::vector<NodeType*>* locked) {
+    NodeType* prev_pred = nullptr;
+    for (int i = 0; i <= top_level; i++) {
+        if (preds[i] != prev_pred) {
+            preds[i]->node_mutex.lock();
+            locked->push_back(preds[i]);
+            prev_pred = preds[i];
+        }
+    }
+}
+
+template<typename K, typename V>
+void SkipListLazy<K, V>::unlock_preds(std::vector<NodeType*>* locked) {
+    for (auto* node : *locked) {
+        node->node_mutex.unlock();
+    }
+    locked->clear();
+}
+
+// 插入元素
+// return 1 means element exists
+// return 0 means insert successfully
+template<typename K, typename V>
+int SkipListLazy<K, V>::insert_element(const K& key, const V& value) {
+    auto guard = _epoch_manager.pin();
+    std::vector<NodeType*> preds(_max_level + 1, nullptr);
+    std::vector<NodeType*> succs(_max_level + 1, nullptr);
+    std::vector<NodeType*> locked;
+    locked.reserve(_max_level + 1);
+    int random_level = get_random_level();
+
+    while (true) {
+        int found_level = find(key, preds.data(), succs.data());
+        if (found_level != -1) {
+            NodeType* node_found = succs[found_level];
+            if (!node_found->marked.load(std::memory_order_acquire)) {
+                // 等待并发插入者完成链接，保证返回后该 key 可见
+                while (!node_found->fully_linked.load(std::memory_order_acquire)) {
+                    std::this_thread::yield();
+                }
+                return 1;
+            }
+            continue;  // 正在被删除，重试
+        }
+
+        // 锁定前驱并校验：前驱/后继均未删除且仍然相邻
+        lock_preds(preds.data(), random_level, &locked);
+        bool valid = true;
+        for (int i = 0; valid && i <= random_level; i++) {
+            NodeType* pred = preds[i];
+            NodeType* succ = succs[i];
+            valid = !pred->marked.load(std::memory_order_acquire) &&
+                    (succ == nullptr || !succ->marked.load(std::memory_order_acquire)) &&
+                    pred->next(i) == succ;
+        }
+        if (!valid) {
+            unlock_preds(&locked);
+            continue;
+        }
+
+        NodeType* inserted_node = create_node(key, value, random_level);
+        for (int i = 0; i <= random_level; i++) {
+            inserted_node->forward[i].store(succs[i], std::memory_order_relaxed);
+        }
+        for (int i = 0; i <= random_level; i++) {
+            preds[i]->forward[i].store(inserted_node, std::memory_order_release);
+        }
+        inserted_node->fully_linked.store(true, std::memory_order_release);
+        unlock_preds(&locked);
+
+        int level = _skip_list_level.load(std::memory_order_relaxed);
+        while (random_level > level &&
+               !_skip_list_level.compare_exchange_weak(level, random_level, std::memory_order_relaxed)) {
+        }
+        _element_count.increment();
+        return 0;
+    }
+}
+
+// 删除元素：先锁定并标记目标节点（逻辑删除），再锁定前驱逐层摘除
+template<typename K, typename V>
+void SkipListLazy<K, V>::delete_element(const K& key) {
+    auto guard = _epoch_manager.pin();
+    std::vector<NodeType*> preds(_max_level + 1, nullptr);
+    std::vector<NodeType*> succs(_max_level + 1, nullptr);
+    std::vector<NodeType*> locked;
+    locked.reserve(_max_level + 1);
+    NodeType* victim = nullptr;
+    bool is_marked = false;
+
+    while (true) {
+        int found_level = find(key, preds.data(), succs.data());
+        if (!is_marked) {
+            // 只有已完全链接、且在其最高层被找到的节点才能删除
+            if (found_level == -1) {
+                return;
+            }
+            victim = succs[found_level];
+            if (!victim->fully_linked.load(std::memory_order_acquire) ||
+                victim->node_level != found_level ||
+                victim->marked.load(std::memory_order_acquire)) {
+                return;
+            }
+            victim->node_mutex.lock();
+            if (victim->marked.load(std::memory_order_acquire)) {
+                victim->node_mutex.unlock();
+                return;
+            }
+            victim->marked.store(true, std::memory_order_release);
+            is_marked = true;
+        }
+
+        lock_preds(preds.data(), victim->node_level, &locked);
+        bool valid = true;
+        for (int i = 0; valid && i <= victim->node_level; i++) {
+            valid = !preds[i]->marked.load(std::memory_order_acquire) && preds[i]->next(i) == victim;
+        }
+        if (!valid) {
+            unlock_preds(&locked);
+            continue;
+        }
+
+        for (int i = victim->node_level; i >= 0; i--) {
+            preds[i]->forward[i].store(victim->next(i), std::memory_order_release);
+        }
+        victim->node_mutex.unlock();
+        unlock_preds(&locked);
+
+        _element_count.decrement();
+        retire_node(victim);
+        return;
+    }
+}
+
+// 查找元素 - wait-free：单次遍历，不加锁、不重试
+template<typename K, typename V>
+NodeLazy<K, V>* SkipListLazy<K, V>::locate(const K& key) {
+    auto guard = _epoch_manager.pin();
+    NodeType* pred = _header;
+    for (int i = _skip_list_level.load(std::memory_order_relaxed); i >= 0; i--) {
+        NodeType* curr = pred->next(i);
+        while (curr != nullptr && curr->get_key() < key) {
+            pred = curr;
+            curr = pred->next(i);
+        }
+        if (curr != nullptr && curr->get_key() == key) {
+            if (curr->fully_linked.load(std::memory_order_acquire) &&
+                !curr->marked.load(std::memory_order_acquire)) {
+                return curr;
+            }
+            return nullptr;
+        }
+    }
+    return nullptr;
+}
+
+template<typename K, typename V>
+bool SkipListLazy<K, V>::search_element_silent(const K& key) {
+    return locate(key) != nullptr;
+}
+
+template<typename K, typename V>
+bool SkipListLazy<K, V>::search_element(const K& key) {
+    auto guard = _epoch_manager.pin();
+    std::cout << "search_element-----------------" << std::endl;
+    NodeType* node = locate(key);
+    if (node != nullptr) {
+        std::cout << "Found key: " << key << ", value: " << node->get_value() << std::endl;
+        return true;
+    }
+    std::cout << "Not Found Key:" << key << std::endl;
+    return false;
+}
+
+// 范围查询
+template<typename K, typename V>
+std::vector<std::pair<K, V>> SkipListLazy<K, V>::range_query(const K& start_key, const K& end_key) {
+    auto guard = _epoch_manager.pin();
+    std::vector<std::pair<K, V>> result;
+    if (start_key > end_key) {
+        return result;
+    }
+
+    NodeType* pred = _header;
+    for (int i = _skip_list_level.load(std::memory_order_relaxed); i >= 0; i--) {
+        NodeType* curr = pred->next(i);
+        while (curr != nullptr && curr->get_key() < start_key) {
+            pred = curr;
+            curr = pred->next(i);
+        }
+    }
+
+    NodeType* current = pred->next(0);
+    while (current != nullptr && current->get_key() <= end_key) {
+        if (current->fully_linked.load(std::memory_order_acquire) &&
+            !current->marked.load(std::memory_order_acquire)) {
+            result.push_back(std::make_pair(current->get_key(), current->get_value()));
+        }
+        current = current->next(0);
+    }
+    return result;
+}
+
+template<typename K, typename V>
+typename SkipListLazy<K, V>::Cursor SkipListLazy<K, V>::cursor() {
+    return Cursor(this);
+}
+
+template<typename K, typename V>
+void SkipListLazy<K, V>::Cursor::seek(const K& key) {
+    NodeType* pred = _list->_header;
+    for (int i = _list->_skip_list_level.load(std::memory_order_relaxed); i >= 0; i--) {
+        NodeType* curr = pred->next(i);
+        while (curr != nullptr && curr->get_key_ref() < key) {
+            pred = curr;
+            curr = pred->next(i);
+        }
+    }
+    _node = pred->next(0);
+    skip_invisible();
+}
+
+template<typename K, typename V>
+void SkipListLazy<K, V>::Cursor::seek_to_first() {
+    _node = _list->_header->next(0);
+    skip_invisible();
+}
+
+template<typename K, typename V>
+bool SkipListLazy<K, V>::Cursor::valid() const {
+    return _node != nullptr;
+}
+
+template<typename K, typename V>
+void SkipListLazy<K, V>::Cursor::next() {
+    _node = _node->next(0);
+    skip_invisible();
+}
+
+template<typename K, typename V>
+void SkipListLazy<K, V>::Cursor::skip_invisible() {
+    while (_node != nullptr &&
+               (!_node->fully_linked.load(std::memory_order_acquire) ||
+                _node->marked.load(std::memory_order_acquire))) {
+        _node = _node->next(0);
+    }
+}
+
+template<typename K, typename V>
+const K& SkipListLazy<K, V>::Cursor::key() const {
+    return _node->get_key_ref();
+}
+
+template<typename K, typename V>
+const V& SkipListLazy<K, V>::Cursor::value() const {
+    return _node->get_value_ref();
+}
+
+// 显示跳表（快照视图，并发修改下仅供调试）
+template<typename K, typename V>
+void SkipListLazy<K, V>::display_list() {
+    auto guard = _epoch_manager.pin();
+    std::cout << "\n*****Skip List (Lazy)*****" << "\n";
+    for (int i = 0; i <= _skip_list_level.load(std::memory_order_relaxed); i++) {
+        NodeType* node = _header->next(i);
+        std::cout << "Level " << i << ": ";
+        while (node != nullptr) {
+            if (!node->marked.load(std::memory_order_acquire)) {
+                std::cout << node->get_key() << ":" << node->get_value() << ";";
+            }
+            node = node->next(i);
+        }
+        std::cout << std::endl;
+    }
+}
+
+template<typename K, typename V>
+int SkipListLazy<K, V>::size() {
+    return (int)_element_count.load();
+}
+
+template<typename K, typename V>
+void SkipListLazy<K, V>::retire_node(NodeType* node) {
+    _epoch_manager.retire(node);
+}
+
+#endif // SKIPLIST_LAZY_H
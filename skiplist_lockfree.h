@@ -0,0 +1,548 @@
+/* ************************************************************************
+> File Name:     skiplist_lockfree.h
+> Description:   无锁跳表实现（Fraser / Herlihy 风格）
+>                1. 每层 next 指针最低位作为删除标记（marked pointer）
+>                2. 插入、删除通过逐层 CAS 完成，写线程之间互不阻塞
+>                3. 查找不加锁、不修改结构，跳过已标记节点
+>                4. 摘除的节点通过纪元回收延迟释放
+ ************************************************************************/
+
+#ifndef SKIPLIST_LOCKFREE_H
+#define SKIPLIST_LOCKFREE_H
+
+#include <iostream>
+#include <cstdint>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "epoch_reclaim.h"
+#include "sharded_counter.h"
+#include "random_level.h"
+
+// 无锁跳表节点
+template<typename K, typename V>
+class NodeLockFree {
+public:
+    NodeLockFree(const K& k, const V& v, int level);
+    ~NodeLockFree();
+
+    K get_key() const;
+    V get_value() const;
+
+    // 引用访问，供游标直接读取节点内的 key/value
+    const K& get_key_ref() const;
+    const V& get_value_ref() const;
+
+    // 第 i 层后继（去掉标记位）
+    NodeLockFree<K, V>* next(int i) const;
+
+    // 第 i 层是否已被逻辑删除
+    bool is_marked(int i) const;
+
+    // 标记位打包/解包
+    static uintptr_t pack(NodeLockFree<K, V>* node, bool marked);
+    static NodeLockFree<K, V>* unpack(uintptr_t raw);
+    static bool marked_bit(uintptr_t raw);
+
+    // 每层的后继指针，最低位为删除标记
+    std::atomic<uintptr_t>* forward;
+
+    int node_level;
+
+    // 插入线程完成链接、删除线程完成摘除各计一次，第二个到达者负责回收
+    std::atomic<int> retire_votes;
+
+private:
+    K key;
+    V value;
+};
+
+template<typename K, typename V>
+NodeLockFree<K, V>::NodeLockFree(const K& k, const V& v, int level)
+    : node_level(level), retire_votes(0), key(k), value(v) {
+    // level + 1, because array index is from 0 - level
+    this->forward = new std::atomic<uintptr_t>[level + 1];
+    for (int i = 0; i <= level; i++) {
+        forward[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+template<typename K, typename V>
+NodeLockFree<K, V>::~NodeLockFree() {
+    delete[] forward;
+}
+
+template<typename K, typename V>
+K NodeLockFree<K, V>::get_key() const {
+    return key;
+}
+
+template<typename K, typename V>
+V NodeLockFree<K, V>::get_value() const {
+    return value;
+}
+
+template<typename K, typename V>
+const K& NodeLockFree<K, V>::get_key_ref() const {
+    return key;
+}
+
+template<typename K, typename V>
+const V& NodeLockFree<K, V>::get_value_ref() const {
+    return value;
+}
+
+template<typename K, typename V>
+NodeLockFree<K, V>* NodeLockFree<K, V>::next(int i) const {
+    return unpack(forward[i].load(std::memory_order_acquire));
+}
+
+template<typename K, typename V>
+bool NodeLockFree<K, V>::is_marked(int i) const {
+    return marked_bit(forward[i].load(std::memory_order_acquire));
+}
+
+template<typename K, typename V>
+uintptr_t NodeLockFree<K, V>::pack(NodeLockFree<K, V>* node, bool marked) {
+    return reinterpret_cast<uintptr_t>(node) | (marked ? 1 : 0);
+}
+
+template<typename K, typename V>
+NodeLockFree<K, V>* NodeLockFree<K, V>::unpack(uintptr_t raw) {
+    return reinterpret_cast<NodeLockFree<K, V>*>(raw & ~static_cast<uintptr_t>(1));
+}
+
+template<typename K, typename V>
+bool NodeLockFree<K, V>::marked_bit(uintptr_t raw) {
+    return (raw & 1) != 0;
+}
+
+// Class template for lock-free skip list
+template<typename K, typename V>
+class SkipListLockFree {
+public:
+    SkipListLockFree(int max_level);
+    ~SkipListLockFree();
+
+    int get_random_level();                              // [0, max_level]
+    // 设置分支因子（默认 1/2），只影响之后插入的节点，须在并发写入开始前调用
+    void set_level_probability(LevelProbability probability);
+    LevelProbability get_level_probability() const;
+    NodeLockFree<K, V>* create_node(const K&, const V&, int);
+    int insert_element(const K&, const V&);
+    void display_list();
+    bool search_element(const K&);
+    bool search_element_silent(const K&);  // 静默查询，不输出信息
+    void delete_element(const K&);
+    int size();
+
+    // 范围查询：返回 [start_key, end_key] 内未被删除的键值对
+    std::vector<std::pair<K, V>> range_query(const K& start_key, const K& end_key);
+
+    /**
+     * @brief 流式游标 - 沿第 0 层逐个访问未删除的元素，不复制 value、不分配内存
+     *
+     * 游标存活期间持有纪元守卫，停留的节点即使被并发删除也不会被回收，
+     * next() 从该节点继续前进并跳过已标记节点。长时间扫描会推迟回收。
+     */
+    class Cursor {
+    public:
+        void seek(const K& key);        // 定位到第一个 >= key 的元素
+        void seek_to_first();
+        bool valid() const;
+        void next();
+        const K& key() const;
+        const V& value() const;
+
+    private:
+        friend class SkipListLockFree<K, V>;
+        explicit Cursor(SkipListLockFree<K, V>* list)
+            : _list(list), _guard(list->_epoch_manager.pin()), _node(nullptr) {}
+
+        // 跳过不可见节点
+        void skip_invisible();
+
+        SkipListLockFree<K, V>* _list;
+        EpochManager::Guard _guard;
+        NodeLockFree<K, V>* _node;
+    };
+
+    // 创建游标，初始状态无效，需先 seek
+    Cursor cursor();
+
+private:
+    typedef NodeLockFree<K, V> NodeType;
+
+    // 定位 key 在每一层的前驱/后继，顺带摘除路径上已标记的节点
+    bool find(const K& key, NodeType** preds, NodeType** succs);
+
+    // 只读定位，返回未删除的目标节点，不存在时返回 nullptr
+    NodeType* locate(const K& key);
+
+    // 节点完全脱离跳表后回收
+    void retire_node(NodeType* node);
+
+private:
+    int _max_level;                                      // 跳表最大层级
+    LevelGenerator _level_generator;                     // 随机层级生成器，随机源为线程局部
+    std::atomic<int> _skip_list_level;                   // 当前最高非空层级（仅作查找起点提示）
+    NodeType* _header;                                   // 头节点指针
+    ShardedCounter _element_count;                       // 元素计数，各线程写自己的计数槽
+
+    // 已摘除但可能仍被并发读者引用的节点，宽限期结束后释放
+    EpochManager _epoch_manager;
+};
+
+template<typename K, typename V>
+SkipListLockFree<K, V>::SkipListLockFree(int max_level)
+    : _max_level(max_level),
+      _level_generator(max_level),
+      _skip_list_level(0) {
+    K k{};
+    V v{};
+    this->_header = new NodeType(k, v, _max_level);
+}
+
+// 析构时不存在并发访问，直接沿第 0 层释放
+template<typename K, typename V>
+SkipListLockFree<K, V>::~SkipListLockFree() {
+    NodeType* current = _header->next(0);
+    while (current != nullptr) {
+        NodeType* next = current->next(0);
+        delete current;
+        current = next;
+    }
+    delete _header;
+
+    _epoch_manager.drain();
+}
+
+template<typename K, typename V>
+NodeLockFree<K, V>* SkipListLockFree<K, V>::create_node(const K& k, const V& v, int level) {
+    return new NodeType(k, v, level);
+}
+
+// 获取随机层级
+// 使用线程局部随机源，避免 rand() 内部锁在多写线程下成为串行点
+template<typename K, typename V>
+int SkipListLockFree<K, V>::get_random_level() {
+    return _level_generator.next();
+}
+
+template<typename K, typename V>
+void SkipListLockFree<K, V>::set_level_probability(LevelProbability probability) {
+    _level_generator = LevelGenerator(_max_level, probability);
+}
+
+template<typename K, typename V>
+LevelProbability SkipListLockFree<K, V>::get_level_probability() const {
+    return _level_generator.probability();
+}
+
+// 从最高层开始查找，记录每层的前驱和后继
+// 遇到已标记节点时尝试将其从该层摘除，CAS 失败则从头重试
+template<typename K, typename V>
+bool SkipListLockFree<K, V>::find(const K& key, NodeType** preds, NodeType** succs) {
+retry:
+    NodeType* pred = _header;
+    for (int i = _max_level; i >= 0; i--) {
+        NodeType* curr = pred->next(i);
+        while (curr != nullptr) {
+            uintptr_t raw = curr->forward[i].load(std::memory_order_acquire);
+            NodeType* succ = NodeType::unpack(raw);
+
+            // curr 在该层已被删除，帮助摘除
+            if (NodeType::marked_bit(raw)) {
+                uintptr_t expected = NodeType::pack(curr, false);
+                if (!pred->forward[i].compare_exchange_strong(expected, NodeType::pack(succ, false),
+                                                              std::memory_order_acq_rel)) {
+                    goto retry;
+                }
+                curr = succ;
+                continue;
+            }
+
+            if (curr->get_key() < key) {
+                pred = curr;
+                curr = succ;
+            } else {
+                break;
+            }
+        }
+        preds[i] = pred;
+        succs[i] = curr;
+    }
+    return succs[0] != nullptr && succs[0]->get_key() == key;
+}
+
+// 插入元素
+// return 1 means element exists
+// return 0 means insert successfully
+template<typename K, typename V>
+int SkipListLockFree<K, V>::insert_element(const K& key, const V& value) {
+    auto guard = _epoch_manager.pin();
+    std::vector<NodeType*> preds(_max_level + 1, nullptr);
+    std::vector<NodeType*> succs(_max_level + 1, nullptr);
+    int random_level = get_random_level();
+    NodeType* inserted_node = nullptr;
+
+    // 第 0 层链接成功即视为插入生效
+    while (true) {
+        if (find(key, preds.data(), succs.data())) {
+            delete inserted_node;
+            return 1;
+        }
+
+        if (inserted_node == nullptr) {
+            inserted_node = create_node(key, value, random_level);
+        }
+        for (int i = 0; i <= random_level; i++) {
+            inserted_node->forward[i].store(NodeType::pack(succs[i], false), std::memory_order_relaxed);
+        }
+
+        uintptr_t expected = NodeType::pack(succs[0], false);
+        if (preds[0]->forward[0].compare_exchange_strong(expected, NodeType::pack(inserted_node, false),
+                                                         std::memory_order_acq_rel)) {
+            break;
+        }
+    }
+
+    // 自底向上链接其余层，若节点已被并发删除则停止
+    for (int i = 1; i <= random_level; i++) {
+        while (true) {
+            uintptr_t own = inserted_node->forward[i].load(std::memory_order_acquire);
+            if (NodeType::marked_bit(own)) {
+                break;
+            }
+            if (NodeType::unpack(own) != succs[i] &&
+                !inserted_node->forward[i].compare_exchange_strong(own, NodeType::pack(succs[i], false),
+                                                                   std::memory_order_acq_rel)) {
+                break;
+            }
+
+            uintptr_t expected = NodeType::pack(succs[i], false);
+            if (preds[i]->forward[i].compare_exchange_strong(expected, NodeType::pack(inserted_node, false),
+                                                             std::memory_order_acq_rel)) {
+                break;
+            }
+            find(key, preds.data(), succs.data());
+        }
+        if (inserted_node->is_marked(i)) {
+            break;
+        }
+    }
+
+    int level = _skip_list_level.load(std::memory_order_relaxed);
+    while (random_level > level &&
+           !_skip_list_level.compare_exchange_weak(level, random_level, std::memory_order_relaxed)) {
+    }
+
+    _element_count.increment();
+
+    // 链接期间被并发删除时，帮助摘除可能残留在高层的节点
+    if (inserted_node->is_marked(0)) {
+        find(key, preds.data(), succs.data());
+    }
+    if (inserted_node->retire_votes.fetch_add(1, std::memory_order_acq_rel) == 1) {
+        retire_node(inserted_node);
+    }
+    return 0;
+}
+
+// 删除元素：先自顶向下标记各层，第 0 层标记成功者拥有此次删除
+template<typename K, typename V>
+void SkipListLockFree<K, V>::delete_element(const K& key) {
+    auto guard = _epoch_manager.pin();
+    std::vector<NodeType*> preds(_max_level + 1, nullptr);
+    std::vector<NodeType*> succs(_max_level + 1, nullptr);
+
+    if (!find(key, preds.data(), succs.data())) {
+        return;
+    }
+
+    NodeType* victim = succs[0];
+    for (int i = victim->node_level; i >= 1; i--) {
+        uintptr_t raw = victim->forward[i].load(std::memory_order_acquire);
+        while (!NodeType::marked_bit(raw)) {
+            victim->forward[i].compare_exchange_weak(raw, raw | 1, std::memory_order_acq_rel);
+        }
+    }
+
+    uintptr_t raw = victim->forward[0].load(std::memory_order_acquire);
+    while (true) {
+        if (NodeType::marked_bit(raw)) {
+            return;  // 其他线程已完成删除
+        }
+        if (victim->forward[0].compare_exchange_weak(raw, raw | 1, std::memory_order_acq_rel)) {
+            break;
+        }
+    }
+
+    // 物理摘除
+    find(key, preds.data(), succs.data());
+    _element_count.decrement();
+
+    if (victim->retire_votes.fetch_add(1, std::memory_order_acq_rel) == 1) {
+        retire_node(victim);
+    }
+}
+
+// 只读定位 - 不加锁、不帮助摘除，只跳过已标记节点
+template<typename K, typename V>
+NodeLockFree<K, V>* SkipListLockFree<K, V>::locate(const K& key) {
+    auto guard = _epoch_manager.pin();
+    NodeType* pred = _header;
+    NodeType* curr = nullptr;
+
+    for (int i = _skip_list_level.load(std::memory_order_relaxed); i >= 0; i--) {
+        curr = pred->next(i);
+        while (curr != nullptr) {
+            uintptr_t raw = curr->forward[i].load(std::memory_order_acquire);
+            if (NodeType::marked_bit(raw)) {
+                curr = NodeType::unpack(raw);
+                continue;
+            }
+            if (curr->get_key() < key) {
+                pred = curr;
+                curr = NodeType::unpack(raw);
+            } else {
+                break;
+            }
+        }
+    }
+
+    if (curr != nullptr && curr->get_key() == key && !curr->is_marked(0)) {
+        return curr;
+    }
+    return nullptr;
+}
+
+template<typename K, typename V>
+bool SkipListLockFree<K, V>::search_element_silent(const K& key) {
+    return locate(key) != nullptr;
+}
+
+template<typename K, typename V>
+bool SkipListLockFree<K, V>::search_element(const K& key) {
+    auto guard = _epoch_manager.pin();
+    std::cout << "search_element-----------------" << std::endl;
+    NodeType* node = locate(key);
+    if (node != nullptr) {
+        std::cout << "Found key: " << key << ", value: " << node->get_value() << std::endl;
+        return true;
+    }
+    std::cout << "Not Found Key:" << key << std::endl;
+    return false;
+}
+
+// 范围查询
+template<typename K, typename V>
+std::vector<std::pair<K, V>> SkipListLockFree<K, V>::range_query(const K& start_key, const K& end_key) {
+    auto guard = _epoch_manager.pin();
+    std::vector<std::pair<K, V>> result;
+    if (start_key > end_key) {
+        return result;
+    }
+
+    NodeType* pred = _header;
+    for (int i = _skip_list_level.load(std::memory_order_relaxed); i >= 0; i--) {
+        NodeType* curr = pred->next(i);
+        while (curr != nullptr && curr->get_key() < start_key) {
+            pred = curr;
+            curr = curr->next(i);
+        }
+    }
+
+    NodeType* current = pred->next(0);
+    while (current != nullptr && current->get_key() <= end_key) {
+        if (!current->is_marked(0) && current->get_key() >= start_key) {
+            result.push_back(std::make_pair(current->get_key(), current->get_value()));
+        }
+        current = current->next(0);
+    }
+    return result;
+}
+
+template<typename K, typename V>
+typename SkipListLockFree<K, V>::Cursor SkipListLockFree<K, V>::cursor() {
+    return Cursor(this);
+}
+
+template<typename K, typename V>
+void SkipListLockFree<K, V>::Cursor::seek(const K& key) {
+    NodeType* pred = _list->_header;
+    for (int i = _list->_skip_list_level.load(std::memory_order_relaxed); i >= 0; i--) {
+        NodeType* curr = pred->next(i);
+        while (curr != nullptr && curr->get_key_ref() < key) {
+            pred = curr;
+            curr = pred->next(i);
+        }
+    }
+    _node = pred->next(0);
+    skip_invisible();
+}
+
+template<typename K, typename V>
+void SkipListLockFree<K, V>::Cursor::seek_to_first() {
+    _node = _list->_header->next(0);
+    skip_invisible();
+}
+
+template<typename K, typename V>
+bool SkipListLockFree<K, V>::Cursor::valid() const {
+    return _node != nullptr;
+}
+
+template<typename K, typename V>
+void SkipListLockFree<K, V>::Cursor::next() {
+    _node = _node->next(0);
+    skip_invisible();
+}
+
+template<typename K, typename V>
+void SkipListLockFree<K, V>::Cursor::skip_invisible() {
+    while (_node != nullptr && _node->is_marked(0)) {
+        _node = _node->next(0);
+    }
+}
+
+template<typename K, typename V>
+const K& SkipListLockFree<K, V>::Cursor::key() const {
+    return _node->get_key_ref();
+}
+
+template<typename K, typename V>
+const V& SkipListLockFree<K, V>::Cursor::value() const {
+    return _node->get_value_ref();
+}
+
+// 显示跳表（快照视图，并发修改下仅供调试）
+template<typename K, typename V>
+void SkipListLockFree<K, V>::display_list() {
+    auto guard = _epoch_manager.pin();
+    std::cout << "\n*****Skip List (Lock-Free)*****" << "\n";
+    for (int i = 0; i <= _skip_list_level.load(std::memory_order_relaxed); i++) {
+        NodeType* node = _header->next(i);
+        std::cout << "Level " << i << ": ";
+        while (node != nullptr) {
+            if (!node->is_marked(i)) {
+                std::cout << node->get_key() << ":" << node->get_value() << ";";
+            }
+            node = node->next(i);
+        }
+        std::cout << std::endl;
+    }
+}
+
+template<typename K, typename V>
+int SkipListLockFree<K, V>::size() {
+    return (int)_element_count.load();
+}
+
+template<typename K, typename V>
+void SkipListLockFree<K, V>::retire_node(NodeType* node) {
+    _epoch_manager.retire(node);
+}
+
+#endif // SKIPLIST_LOCKFREE_H
@@ -21,6 +21,10 @@
 #include <unordered_map>
 #include <memory>
 #include <chrono>
+#include <new>
+#include "batch_search.h"
+#include "log_policy.h"
+#include "random_level.h"
 
 #define STORE_FILE_MVCC "store/dumpFile_mvcc"
 
@@ -55,15 +59,25 @@ struct Version {
 };
 
 // MVCC节点结构
+// 单次分配布局：[key | node_level | forward[0..level] | 版本链]
+// key 与 forward[0] 位于首个 cache line，版本链头和锁放在 forward 塔之后
 template<typename K, typename V>
 class NodeMVCC {
 public:
-    NodeMVCC() {}
-    NodeMVCC(K k, int level);
-    ~NodeMVCC();
+    // 单次分配创建节点
+    static NodeMVCC<K, V>* create(K k, int level);
+    
+    // 析构版本链并释放整块内存
+    static void destroy(NodeMVCC<K, V>* node);
+    
+    // 指定层级节点所需的字节数
+    static size_t allocation_size(int level);
     
     K get_key() const;
     
+    // 引用访问，供游标直接读取节点内的 key
+    const K& get_key_ref() const;
+    
     // 版本链管理
     void add_version(V value, uint64_t txn_id);
     std::shared_ptr<Version<K, V>> get_visible_version(uint64_t txn_id);
@@ -73,27 +87,81 @@ public:
     // 垃圾回收：清理对所有活跃事务都不可见的旧版本
     void gc_versions(uint64_t min_active_txn_id);
     
-    NodeMVCC<K, V> **forward;
+private:
+    K key;
+    
+public:
     int node_level;
     
+    // 内联的 forward 塔，实际长度为 node_level + 1，必须是最后一个成员
+    // 写者在 _global_mutex 下构造完节点后以 release 链接，不加锁的读者经 next() 以 acquire 读取，
+    // 读到指针即能看到节点的 key 和塔
+    std::atomic<NodeMVCC<K, V>*> forward[1];
+
+    NodeMVCC<K, V>* next(int i) const;
+    
 private:
-    K key;
-    std::shared_ptr<Version<K, V>> version_head;  // 版本链头（最新版本）
-    std::mutex version_mutex;  // 保护版本链的互斥锁
+    // 版本链（值句柄），位于 forward 塔之后
+    struct VersionChain {
+        std::shared_ptr<Version<K, V>> version_head;  // 版本链头（最新版本）
+        std::mutex version_mutex;  // 保护版本链的互斥锁
+    };
+    
+    NodeMVCC(K k, int level);
+    ~NodeMVCC() {}
+    
+    static size_t chain_offset(int level);
+    VersionChain* chain() const;
 };
 
 template<typename K, typename V>
-NodeMVCC<K, V>::NodeMVCC(K k, int level) {
-    this->key = k;
-    this->node_level = level;
-    this->forward = new NodeMVCC<K, V>*[level + 1];
-    memset(this->forward, 0, sizeof(NodeMVCC<K, V>*) * (level + 1));
-    this->version_head = nullptr;
+NodeMVCC<K, V>::NodeMVCC(K k, int level) : key(k), node_level(level) {
+    for (int i = 0; i <= level; i++) {
+        this->forward[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+template<typename K, typename V>
+size_t NodeMVCC<K, V>::chain_offset(int level) {
+    size_t offset = sizeof(NodeMVCC<K, V>) + sizeof(std::atomic<NodeMVCC<K, V>*>) * level;
+    return (offset + alignof(VersionChain) - 1) / alignof(VersionChain) * alignof(VersionChain);
+}
+
+template<typename K, typename V>
+size_t NodeMVCC<K, V>::allocation_size(int level) {
+    return chain_offset(level) + sizeof(VersionChain);
+}
+
+template<typename K, typename V>
+typename NodeMVCC<K, V>::VersionChain* NodeMVCC<K, V>::chain() const {
+    return reinterpret_cast<VersionChain*>(const_cast<char*>(reinterpret_cast<const char*>(this)) + chain_offset(node_level));
+}
+
+template<typename K, typename V>
+NodeMVCC<K, V>* NodeMVCC<K, V>::create(K k, int level) {
+    void* memory = ::operator new(allocation_size(level));
+    NodeMVCC<K, V>* node = new (memory) NodeMVCC<K, V>(k, level);
+    new (node->chain()) VersionChain();
+    return node;
 }
 
 template<typename K, typename V>
-NodeMVCC<K, V>::~NodeMVCC() {
-    delete[] forward;
+void NodeMVCC<K, V>::destroy(NodeMVCC<K, V>* node) {
+    // 版本链由 shared_ptr 串联，直接析构链头会逐层递归；先逐个断开只被链表持有的版本
+    std::shared_ptr<Version<K, V>> version = std::move(node->chain()->version_head);
+    while (version != nullptr && version.use_count() == 1) {
+        std::shared_ptr<Version<K, V>> next = std::move(version->next);
+        version = std::move(next);
+    }
+    version.reset();
+    node->chain()->~VersionChain();
+    node->~NodeMVCC<K, V>();
+    ::operator delete(static_cast<void*>(node));
+}
+
+template<typename K, typename V>
+NodeMVCC<K, V>* NodeMVCC<K, V>::next(int i) const {
+    return forward[i].load(std::memory_order_acquire);
 }
 
 template<typename K, typename V>
@@ -101,18 +169,25 @@ K NodeMVCC<K, V>::get_key() const {
     return key;
 }
 
+template<typename K, typename V>
+const K& NodeMVCC<K, V>::get_key_ref() const {
+    return key;
+}
+
 template<typename K, typename V>
 void NodeMVCC<K, V>::add_version(V value, uint64_t txn_id) {
-    std::lock_guard<std::mutex> lock(version_mutex);
+    VersionChain* versions = chain();
+    std::lock_guard<std::mutex> lock(versions->version_mutex);
     auto new_version = std::make_shared<Version<K, V>>(value, txn_id);
-    new_version->next = version_head;
-    version_head = new_version;
+    new_version->next = versions->version_head;
+    versions->version_head = new_version;
 }
 
 template<typename K, typename V>
 std::shared_ptr<Version<K, V>> NodeMVCC<K, V>::get_visible_version(uint64_t txn_id) {
-    std::lock_guard<std::mutex> lock(version_mutex);
-    auto current = version_head;
+    VersionChain* versions = chain();
+    std::lock_guard<std::mutex> lock(versions->version_mutex);
+    auto current = versions->version_head;
     while (current != nullptr) {
         if (current->is_visible(txn_id)) {
             return current;
@@ -124,16 +199,18 @@ std::shared_ptr<Version<K, V>> NodeMVCC<K, V>::get_visible_version(uint64_t txn_
 
 template<typename K, typename V>
 void NodeMVCC<K, V>::mark_deleted(uint64_t txn_id) {
-    std::lock_guard<std::mutex> lock(version_mutex);
-    if (version_head != nullptr) {
-        version_head->delete_ts = txn_id;
+    VersionChain* versions = chain();
+    std::lock_guard<std::mutex> lock(versions->version_mutex);
+    if (versions->version_head != nullptr) {
+        versions->version_head->delete_ts = txn_id;
     }
 }
 
 template<typename K, typename V>
 void NodeMVCC<K, V>::commit_version(uint64_t txn_id) {
-    std::lock_guard<std::mutex> lock(version_mutex);
-    auto current = version_head;
+    VersionChain* versions = chain();
+    std::lock_guard<std::mutex> lock(versions->version_mutex);
+    auto current = versions->version_head;
     while (current != nullptr) {
         if (current->create_ts == txn_id) {
             current->is_committed = true;
@@ -144,13 +221,14 @@ void NodeMVCC<K, V>::commit_version(uint64_t txn_id) {
 
 template<typename K, typename V>
 void NodeMVCC<K, V>::gc_versions(uint64_t min_active_txn_id) {
-    std::lock_guard<std::mutex> lock(version_mutex);
+    VersionChain* versions = chain();
+    std::lock_guard<std::mutex> lock(versions->version_mutex);
     
-    if (version_head == nullptr) return;
+    if (versions->version_head == nullptr) return;
     
     // 保留第一个版本（最新版本）
-    auto current = version_head->next;
-    auto prev = version_head;
+    auto current = versions->version_head->next;
+    auto prev = versions->version_head;
     
     while (current != nullptr) {
         // 如果版本对所有活跃事务都不可见，则可以回收
@@ -196,13 +274,19 @@ public:
 };
 
 // 支持MVCC的跳表
-template<typename K, typename V>
+// LogPolicy 见 log_policy.h，取代原先运行时的 silent 开关
+template<typename K, typename V, typename LogPolicy = StdoutLogger>
 class SkipListMVCC {
 public:
-    SkipListMVCC(int max_level, bool silent = false);
+    SkipListMVCC(int max_level);
     ~SkipListMVCC();
+
+    // 设置分支因子（默认 1/2），只影响之后插入的节点
+    void set_level_probability(LevelProbability probability);
+    LevelProbability get_level_probability() const;
     
-    void set_silent(bool silent) { _silent = silent; }
+    // 日志策略对象，用于 flush 或读取策略自身的统计
+    LogPolicy& logger() { return _logger; }
     
     // 事务管理
     std::shared_ptr<Transaction<K, V>> begin_transaction();
@@ -212,11 +296,47 @@ public:
     // 事务操作（需要传入事务对象）
     int insert_element(std::shared_ptr<Transaction<K, V>> txn, K key, V value);
     bool search_element(std::shared_ptr<Transaction<K, V>> txn, K key, V* value);
+    // 批量快照读：found[i] 表示 keys[i] 对该事务是否可见，可见时写入 values[i]，返回命中个数
+    int multi_get(std::shared_ptr<Transaction<K, V>> txn, const K* keys, size_t count, V* values, bool* found);
     void delete_element(std::shared_ptr<Transaction<K, V>> txn, K key);
     
     // 范围查询
     std::vector<std::pair<K, V>> range_query(std::shared_ptr<Transaction<K, V>> txn, K start_key, K end_key);
     
+    /**
+     * @brief 流式游标 - 按事务快照沿第 0 层逐个访问可见元素，不复制 value
+     *
+     * 只停留在对该事务可见的节点上；游标持有当前版本的 shared_ptr，
+     * 即使该版本随后被 gc 从版本链摘除，value() 返回的引用在 next() 之前仍然有效。
+     * 节点在跳表析构前不会释放；forward 指针以 release 发布、acquire 读取，
+     * 游标读到的节点总是构造完整的，可与写事务并发使用。
+     */
+    class Cursor {
+    public:
+        void seek(const K& key);        // 定位到第一个 >= key 的可见元素
+        void seek_to_first();
+        bool valid() const;
+        void next();
+        const K& key() const;
+        const V& value() const;
+        
+    private:
+        friend class SkipListMVCC<K, V, LogPolicy>;
+        Cursor(SkipListMVCC<K, V, LogPolicy>* list, std::shared_ptr<Transaction<K, V>> txn)
+            : _list(list), _txn(txn), _node(nullptr) {}
+        
+        // 前进到第一个对事务可见的节点并持有其版本
+        void skip_invisible();
+        
+        SkipListMVCC<K, V, LogPolicy>* _list;
+        std::shared_ptr<Transaction<K, V>> _txn;
+        NodeMVCC<K, V>* _node;
+        std::shared_ptr<Version<K, V>> _version;
+    };
+    
+    // 创建游标，初始状态无效，需先 seek
+    Cursor cursor(std::shared_ptr<Transaction<K, V>> txn);
+    
     // 显示和持久化
     void display_list();
     void dump_file();
@@ -237,7 +357,8 @@ private:
     
 private:
     int _max_level;
-    int _skip_list_level;
+    LevelGenerator _level_generator;  // 随机层级生成器（在 _global_mutex 下使用）
+    std::atomic<int> _skip_list_level;  // 当前跳表层级（在 _global_mutex 下修改，读路径原子读取）
     NodeMVCC<K, V>* _header;
     
     // 事务管理
@@ -254,24 +375,24 @@ private:
     std::ofstream _file_writer;
     std::ifstream _file_reader;
     
-    bool _silent;  // 静默模式
+    LogPolicy _logger;  // 编译期选择的日志策略，静默运行使用 NullLogger
 };
 
-template<typename K, typename V>
-SkipListMVCC<K, V>::SkipListMVCC(int max_level, bool silent) 
+template<typename K, typename V, typename LogPolicy>
+SkipListMVCC<K, V, LogPolicy>::SkipListMVCC(int max_level) 
     : _max_level(max_level),
+      _level_generator(max_level),
       _skip_list_level(0),
       _next_txn_id(1),
       _total_commits(0),
       _total_aborts(0),
-      _total_versions(0),
-      _silent(silent) {
-    K k;
-    this->_header = new NodeMVCC<K, V>(k, _max_level);
+      _total_versions(0) {
+    K k{};
+    this->_header = NodeMVCC<K, V>::create(k, _max_level);
 }
 
-template<typename K, typename V>
-SkipListMVCC<K, V>::~SkipListMVCC() {
+template<typename K, typename V, typename LogPolicy>
+SkipListMVCC<K, V, LogPolicy>::~SkipListMVCC() {
     if (_file_writer.is_open()) {
         _file_writer.close();
     }
@@ -279,53 +400,57 @@ SkipListMVCC<K, V>::~SkipListMVCC() {
         _file_reader.close();
     }
     
-    if (_header->forward[0] != nullptr) {
-        clear(_header->forward[0]);
-    }
-    delete _header;
+    clear(_header->next(0));
+    NodeMVCC<K, V>::destroy(_header);
 }
 
-template<typename K, typename V>
-void SkipListMVCC<K, V>::clear(NodeMVCC<K, V>* node) {
-    if (node->forward[0] != nullptr) {
-        clear(node->forward[0]);
+template<typename K, typename V, typename LogPolicy>
+void SkipListMVCC<K, V, LogPolicy>::clear(NodeMVCC<K, V>* node) {
+    // 迭代释放 node 及其后的所有节点，栈深度与元素个数无关
+    while (node != nullptr) {
+        NodeMVCC<K, V>* next = node->next(0);
+        NodeMVCC<K, V>::destroy(node);
+        node = next;
     }
-    delete node;
 }
 
-template<typename K, typename V>
-int SkipListMVCC<K, V>::get_random_level() {
-    int k = 1;
-    while (rand() % 2) {
-        k++;
-    }
-    k = (k < _max_level) ? k : _max_level;
-    return k;
+template<typename K, typename V, typename LogPolicy>
+int SkipListMVCC<K, V, LogPolicy>::get_random_level() {
+    return _level_generator.next();
 }
 
-template<typename K, typename V>
-NodeMVCC<K, V>* SkipListMVCC<K, V>::create_node(K key, int level) {
-    return new NodeMVCC<K, V>(key, level);
+template<typename K, typename V, typename LogPolicy>
+void SkipListMVCC<K, V, LogPolicy>::set_level_probability(LevelProbability probability) {
+    std::lock_guard<std::mutex> lock(_global_mutex);
+    _level_generator = LevelGenerator(_max_level, probability);
+}
+
+template<typename K, typename V, typename LogPolicy>
+LevelProbability SkipListMVCC<K, V, LogPolicy>::get_level_probability() const {
+    return _level_generator.probability();
+}
+
+template<typename K, typename V, typename LogPolicy>
+NodeMVCC<K, V>* SkipListMVCC<K, V, LogPolicy>::create_node(K key, int level) {
+    return NodeMVCC<K, V>::create(key, level);
 }
 
 // 开始事务
-template<typename K, typename V>
-std::shared_ptr<Transaction<K, V>> SkipListMVCC<K, V>::begin_transaction() {
+template<typename K, typename V, typename LogPolicy>
+std::shared_ptr<Transaction<K, V>> SkipListMVCC<K, V, LogPolicy>::begin_transaction() {
     uint64_t txn_id = _next_txn_id.fetch_add(1);
     auto txn = std::make_shared<Transaction<K, V>>(txn_id);
     
     std::lock_guard<std::mutex> lock(_txn_mutex);
     _active_transactions[txn_id] = txn;
     
-    if (!_silent) {
-        std::cout << "[TXN " << txn_id << "] BEGIN" << std::endl;
-    }
+    _logger.log("[TXN ", txn_id, "] BEGIN");
     return txn;
 }
 
 // 提交事务
-template<typename K, typename V>
-bool SkipListMVCC<K, V>::commit_transaction(std::shared_ptr<Transaction<K, V>> txn) {
+template<typename K, typename V, typename LogPolicy>
+bool SkipListMVCC<K, V, LogPolicy>::commit_transaction(std::shared_ptr<Transaction<K, V>> txn) {
     if (!txn || !txn->is_active()) {
         return false;
     }
@@ -343,15 +468,13 @@ bool SkipListMVCC<K, V>::commit_transaction(std::shared_ptr<Transaction<K, V>> t
     }
     
     _total_commits.fetch_add(1);
-    if (!_silent) {
-        std::cout << "[TXN " << txn->txn_id << "] COMMIT" << std::endl;
-    }
+    _logger.log("[TXN ", txn->txn_id, "] COMMIT");
     return true;
 }
 
 // 回滚事务
-template<typename K, typename V>
-void SkipListMVCC<K, V>::abort_transaction(std::shared_ptr<Transaction<K, V>> txn) {
+template<typename K, typename V, typename LogPolicy>
+void SkipListMVCC<K, V, LogPolicy>::abort_transaction(std::shared_ptr<Transaction<K, V>> txn) {
     if (!txn || !txn->is_active()) {
         return;
     }
@@ -364,16 +487,14 @@ void SkipListMVCC<K, V>::abort_transaction(std::shared_ptr<Transaction<K, V>> tx
     }
     
     _total_aborts.fetch_add(1);
-    if (!_silent) {
-        std::cout << "[TXN " << txn->txn_id << "] ABORT" << std::endl;
-    }
+    _logger.log("[TXN ", txn->txn_id, "] ABORT");
 }
 
 // 插入元素
-template<typename K, typename V>
-int SkipListMVCC<K, V>::insert_element(std::shared_ptr<Transaction<K, V>> txn, K key, V value) {
+template<typename K, typename V, typename LogPolicy>
+int SkipListMVCC<K, V, LogPolicy>::insert_element(std::shared_ptr<Transaction<K, V>> txn, K key, V value) {
     if (!txn || !txn->is_active()) {
-        std::cout << "Transaction is not active!" << std::endl;
+        _logger.log("Transaction is not active!");
         return -1;
     }
     
@@ -384,22 +505,21 @@ int SkipListMVCC<K, V>::insert_element(std::shared_ptr<Transaction<K, V>> txn, K
     
     // 查找插入位置
     for (int i = _skip_list_level; i >= 0; i--) {
-        while (current->forward[i] != nullptr && current->forward[i]->get_key() < key) {
-            current = current->forward[i];
+        NodeMVCC<K, V>* succ;
+        while ((succ = current->next(i)) != nullptr && succ->get_key_ref() < key) {
+            current = succ;
         }
         update[i] = current;
     }
     
-    current = current->forward[0];
+    current = current->next(0);
     
     // 如果key已存在，添加新版本
     if (current != nullptr && current->get_key() == key) {
         current->add_version(value, txn->txn_id);
         txn->add_modified_node(current);  // 记录修改的节点
         _total_versions.fetch_add(1);
-        if (!_silent) {
-            std::cout << "[TXN " << txn->txn_id << "] UPDATE key:" << key << ", value:" << value << std::endl;
-        }
+        _logger.log("[TXN ", txn->txn_id, "] UPDATE key:", key, ", value:", value);
         return 0;
     }
     
@@ -418,59 +538,86 @@ int SkipListMVCC<K, V>::insert_element(std::shared_ptr<Transaction<K, V>> txn, K
     txn->add_modified_node(new_node);  // 记录修改的节点
     _total_versions.fetch_add(1);
     
+    // 节点构造完成后自底向上以 release 链接，不加锁的读者读到指针时节点已完整
     for (int i = 0; i <= random_level; i++) {
-        new_node->forward[i] = update[i]->forward[i];
-        update[i]->forward[i] = new_node;
+        new_node->forward[i].store(update[i]->next(i), std::memory_order_relaxed);
+        update[i]->forward[i].store(new_node, std::memory_order_release);
     }
     
-    if (!_silent) {
-        std::cout << "[TXN " << txn->txn_id << "] INSERT key:" << key << ", value:" << value << std::endl;
-    }
+    _logger.log("[TXN ", txn->txn_id, "] INSERT key:", key, ", value:", value);
     return 0;
 }
 
 // 查找元素
-template<typename K, typename V>
-bool SkipListMVCC<K, V>::search_element(std::shared_ptr<Transaction<K, V>> txn, K key, V* value) {
+template<typename K, typename V, typename LogPolicy>
+bool SkipListMVCC<K, V, LogPolicy>::search_element(std::shared_ptr<Transaction<K, V>> txn, K key, V* value) {
     if (!txn || !txn->is_active()) {
-        std::cout << "Transaction is not active!" << std::endl;
+        _logger.log("Transaction is not active!");
         return false;
     }
     
     NodeMVCC<K, V>* current = _header;
     
     // 查找key
-    for (int i = _skip_list_level; i >= 0; i--) {
-        while (current->forward[i] && current->forward[i]->get_key() < key) {
-            current = current->forward[i];
+    for (int i = _skip_list_level.load(std::memory_order_acquire); i >= 0; i--) {
+        NodeMVCC<K, V>* succ;
+        while ((succ = current->next(i)) != nullptr && succ->get_key_ref() < key) {
+            current = succ;
         }
     }
     
-    current = current->forward[0];
+    current = current->next(0);
     
     if (current && current->get_key() == key) {
         // 获取对当前事务可见的版本
         auto version = current->get_visible_version(txn->txn_id);
         if (version != nullptr) {
             *value = version->value;
-            if (!_silent) {
-                std::cout << "[TXN " << txn->txn_id << "] FOUND key:" << key << ", value:" << *value << std::endl;
-            }
+            _logger.log("[TXN ", txn->txn_id, "] FOUND key:", key, ", value:", *value);
             return true;
         }
     }
     
-    if (!_silent) {
-        std::cout << "[TXN " << txn->txn_id << "] NOT FOUND key:" << key << std::endl;
-    }
+    _logger.log("[TXN ", txn->txn_id, "] NOT FOUND key:", key);
     return false;
 }
 
+// 批量查找 - 交错遍历定位节点后逐个读取可见版本
+template<typename K, typename V, typename LogPolicy>
+int SkipListMVCC<K, V, LogPolicy>::multi_get(std::shared_ptr<Transaction<K, V>> txn, const K* keys, size_t count, V* values, bool* found) {
+    if (!txn || !txn->is_active()) {
+        _logger.log("Transaction is not active!");
+        return 0;
+    }
+
+    NodeMVCC<K, V>* nodes[BATCH_SEARCH_GROUP];
+    int hits = 0;
+
+    for (size_t base = 0; base < count; base += BATCH_SEARCH_GROUP) {
+        size_t group = (count - base < (size_t)BATCH_SEARCH_GROUP) ? count - base : BATCH_SEARCH_GROUP;
+        batch_lower_bound(_header, _skip_list_level.load(std::memory_order_acquire), keys + base, group, nodes);
+
+        for (size_t j = 0; j < group; j++) {
+            NodeMVCC<K, V>* node = nodes[j];
+            found[base + j] = false;
+            if (node != nullptr && node->get_key() == keys[base + j]) {
+                auto version = node->get_visible_version(txn->txn_id);
+                if (version != nullptr) {
+                    values[base + j] = version->value;
+                    found[base + j] = true;
+                    hits++;
+                }
+            }
+        }
+    }
+    return hits;
+}
+
 // 删除元素
-template<typename K, typename V>
-void SkipListMVCC<K, V>::delete_element(std::shared_ptr<Transaction<K, V>> txn, K key) {
+template<typename K, typename V, typename LogPolicy>
+void SkipListMVCC<K, V, LogPolicy>::delete_element(std::shared_ptr<Transaction<K, V>> txn, K key) {
     if (!txn || !txn->is_active()) {
-        std::cout << "Transaction is not active!" << std::endl;
+        _logger.log("Transaction is not active!");
         return;
     }
     
@@ -479,32 +626,31 @@ void SkipListMVCC<K, V>::delete_element(std::shared_ptr<Transaction<K, V>> txn,
     NodeMVCC<K, V>* current = _header;
     
     // 查找key
-    for (int i = _skip_list_level; i >= 0; i--) {
-        while (current->forward[i] && current->forward[i]->get_key() < key) {
-            current = current->forward[i];
+    for (int i = _skip_list_level.load(std::memory_order_acquire); i >= 0; i--) {
+        NodeMVCC<K, V>* succ;
+        while ((succ = current->next(i)) != nullptr && succ->get_key_ref() < key) {
+            current = succ;
         }
     }
     
-    current = current->forward[0];
+    current = current->next(0);
     
     if (current && current->get_key() == key) {
         // 标记删除（不是物理删除）
         current->mark_deleted(txn->txn_id);
-        if (!_silent) {
-            std::cout << "[TXN " << txn->txn_id << "] DELETE key:" << key << std::endl;
-        }
+        _logger.log("[TXN ", txn->txn_id, "] DELETE key:", key);
     }
 }
 
 // 范围查询
-template<typename K, typename V>
-std::vector<std::pair<K, V>> SkipListMVCC<K, V>::range_query(
+template<typename K, typename V, typename LogPolicy>
+std::vector<std::pair<K, V>> SkipListMVCC<K, V, LogPolicy>::range_query(
     std::shared_ptr<Transaction<K, V>> txn, K start_key, K end_key) {
     
     std::vector<std::pair<K, V>> result;
     
     if (!txn || !txn->is_active()) {
-        std::cout << "Transaction is not active!" << std::endl;
+        _logger.log("Transaction is not active!");
         return result;
     }
     
@@ -515,13 +661,14 @@ std::vector<std::pair<K, V>> SkipListMVCC<K, V>::range_query(
     NodeMVCC<K, V>* current = _header;
     
     // 找到起始位置
-    for (int i = _skip_list_level; i >= 0; i--) {
-        while (current->forward[i] != nullptr && current->forward[i]->get_key() < start_key) {
-            current = current->forward[i];
+    for (int i = _skip_list_level.load(std::memory_order_acquire); i >= 0; i--) {
+        NodeMVCC<K, V>* succ;
+        while ((succ = current->next(i)) != nullptr && succ->get_key_ref() < start_key) {
+            current = succ;
         }
     }
     
-    current = current->forward[0];
+    current = current->next(0);
     
     // 收集范围内的可见版本
     while (current != nullptr && current->get_key() <= end_key) {
@@ -529,34 +676,95 @@ std::vector<std::pair<K, V>> SkipListMVCC<K, V>::range_query(
         if (version != nullptr) {
             result.push_back(std::make_pair(current->get_key(), version->value));
         }
-        current = current->forward[0];
+        current = current->next(0);
     }
     
-    std::cout << "[TXN " << txn->txn_id << "] RANGE_QUERY [" << start_key << ", " << end_key 
-              << "] found " << result.size() << " elements" << std::endl;
+    _logger.log("[TXN ", txn->txn_id, "] RANGE_QUERY [", start_key, ", ", end_key,
+                "] found ", result.size(), " elements");
     return result;
 }
 
+template<typename K, typename V, typename LogPolicy>
+typename SkipListMVCC<K, V, LogPolicy>::Cursor SkipListMVCC<K, V, LogPolicy>::cursor(std::shared_ptr<Transaction<K, V>> txn) {
+    return Cursor(this, txn);
+}
+
+template<typename K, typename V, typename LogPolicy>
+void SkipListMVCC<K, V, LogPolicy>::Cursor::seek(const K& key) {
+    NodeMVCC<K, V>* current = _list->_header;
+    for (int i = _list->_skip_list_level.load(std::memory_order_acquire); i >= 0; i--) {
+        NodeMVCC<K, V>* succ;
+        while ((succ = current->next(i)) != nullptr && succ->get_key_ref() < key) {
+            current = succ;
+        }
+    }
+    _node = current->next(0);
+    skip_invisible();
+}
+
+template<typename K, typename V, typename LogPolicy>
+void SkipListMVCC<K, V, LogPolicy>::Cursor::seek_to_first() {
+    _node = _list->_header->next(0);
+    skip_invisible();
+}
+
+template<typename K, typename V, typename LogPolicy>
+bool SkipListMVCC<K, V, LogPolicy>::Cursor::valid() const {
+    return _node != nullptr;
+}
+
+template<typename K, typename V, typename LogPolicy>
+void SkipListMVCC<K, V, LogPolicy>::Cursor::next() {
+    _node = _node->next(0);
+    skip_invisible();
+}
+
+template<typename K, typename V, typename LogPolicy>
+void SkipListMVCC<K, V, LogPolicy>::Cursor::skip_invisible() {
+    _version.reset();
+    if (!_txn || !_txn->is_active()) {
+        _node = nullptr;
+        return;
+    }
+    while (_node != nullptr) {
+        _version = _node->get_visible_version(_txn->txn_id);
+        if (_version != nullptr) {
+            return;
+        }
+        _node = _node->next(0);
+    }
+}
+
+template<typename K, typename V, typename LogPolicy>
+const K& SkipListMVCC<K, V, LogPolicy>::Cursor::key() const {
+    return _node->get_key_ref();
+}
+
+template<typename K, typename V, typename LogPolicy>
+const V& SkipListMVCC<K, V, LogPolicy>::Cursor::value() const {
+    return _version->value;
+}
+
 // 显示跳表
-template<typename K, typename V>
-void SkipListMVCC<K, V>::display_list() {
+template<typename K, typename V, typename LogPolicy>
+void SkipListMVCC<K, V, LogPolicy>::display_list() {
     std::lock_guard<std::mutex> lock(_global_mutex);
     
     std::cout << "\n*****Skip List MVCC*****" << std::endl;
     for (int i = 0; i <= _skip_list_level; i++) {
-        NodeMVCC<K, V>* node = _header->forward[i];
+        NodeMVCC<K, V>* node = _header->next(i);
         std::cout << "Level " << i << ": ";
         while (node != nullptr) {
             std::cout << node->get_key() << ";";
-            node = node->forward[i];
+            node = node->next(i);
         }
         std::cout << std::endl;
     }
 }
 
 // 获取最小活跃事务ID
-template<typename K, typename V>
-uint64_t SkipListMVCC<K, V>::get_min_active_txn_id() {
+template<typename K, typename V, typename LogPolicy>
+uint64_t SkipListMVCC<K, V, LogPolicy>::get_min_active_txn_id() {
     std::lock_guard<std::mutex> lock(_txn_mutex);
     
     if (_active_transactions.empty()) {
@@ -571,13 +779,13 @@ uint64_t SkipListMVCC<K, V>::get_min_active_txn_id() {
 }
 
 // 垃圾回收
-template<typename K, typename V>
-void SkipListMVCC<K, V>::gc() {
+template<typename K, typename V, typename LogPolicy>
+void SkipListMVCC<K, V, LogPolicy>::gc() {
     std::lock_guard<std::mutex> lock(_global_mutex);
     
     uint64_t min_active_txn_id = get_min_active_txn_id();
     
-    NodeMVCC<K, V>* current = _header->forward[0];
+    NodeMVCC<K, V>* current = _header->next(0);
     int gc_count = 0;
     
     while (current != nullptr) {
@@ -585,33 +793,33 @@ void SkipListMVCC<K, V>::gc() {
         current->gc_versions(min_active_txn_id);
         size_t after = _total_versions.load();
         gc_count += (before - after);
-        current = current->forward[0];
+        current = current->next(0);
     }
     
-    std::cout << "[GC] Collected " << gc_count << " old versions" << std::endl;
+    _logger.log("[GC] Collected ", gc_count, " old versions");
 }
 
 // 获取元素数量
-template<typename K, typename V>
-int SkipListMVCC<K, V>::size() {
+template<typename K, typename V, typename LogPolicy>
+int SkipListMVCC<K, V, LogPolicy>::size() {
     std::lock_guard<std::mutex> lock(_global_mutex);
     
     int count = 0;
-    NodeMVCC<K, V>* current = _header->forward[0];
+    NodeMVCC<K, V>* current = _header->next(0);
     while (current != nullptr) {
         count++;
-        current = current->forward[0];
+        current = current->next(0);
     }
     return count;
 }
 
 // 持久化
-template<typename K, typename V>
-void SkipListMVCC<K, V>::dump_file() {
+template<typename K, typename V, typename LogPolicy>
+void SkipListMVCC<K, V, LogPolicy>::dump_file() {
     std::lock_guard<std::mutex> lock(_global_mutex);
     
     _file_writer.open(STORE_FILE_MVCC);
-    NodeMVCC<K, V>* node = _header->forward[0];
+    NodeMVCC<K, V>* node = _header->next(0);
     
     // 创建一个临时事务用于读取最新已提交的版本
     auto txn = std::make_shared<Transaction<K, V>>(_next_txn_id.load());
@@ -621,7 +829,7 @@ void SkipListMVCC<K, V>::dump_file() {
         if (version != nullptr) {
             _file_writer << node->get_key() << ":" << version->value << "\n";
         }
-        node = node->forward[0];
+        node = node->next(0);
     }
     
     _file_writer.flush();
@@ -630,8 +838,8 @@ void SkipListMVCC<K, V>::dump_file() {
 }
 
 // 从文件加载
-template<typename K, typename V>
-void SkipListMVCC<K, V>::load_file() {
+template<typename K, typename V, typename LogPolicy>
+void SkipListMVCC<K, V, LogPolicy>::load_file() {
     _file_reader.open(STORE_FILE_MVCC);
     std::cout << "Loading data from file..." << std::endl;
     
@@ -652,8 +860,8 @@ void SkipListMVCC<K, V>::load_file() {
 }
 
 // 打印统计信息
-template<typename K, typename V>
-void SkipListMVCC<K, V>::print_stats() {
+template<typename K, typename V, typename LogPolicy>
+void SkipListMVCC<K, V, LogPolicy>::print_stats() {
     std::cout << "\n===== MVCC Statistics =====" << std::endl;
     std::cout << "Total commits: " << _total_commits.load() << std::endl;
     std::cout << "Total aborts: " << _total_aborts.load() << std::endl;
@@ -3,6 +3,8 @@
 > Description:   优化版跳表实现
 >                1. 细粒度锁优化 - 分段锁机制
 >                2. 内存池优化 - 减少频繁new/delete
+>                3. 纪元回收 - 删除的节点延迟归还内存池，读路径无 use-after-free
+>                4. 原子 forward 指针 - 节点构造完成后以 release 链接，无锁读路径以 acquire 读取
  ************************************************************************/
 
 #ifndef SKIPLIST_OPTIMIZED_H
@@ -14,8 +16,23 @@
 #include <cstring>
 #include <fstream>
 #include <mutex>
+#include <atomic>
+#include <new>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <string>
+#include <chrono>
 #include "segment_lock.h"
 #include "memory_pool.h"
+#include "sharded_counter.h"
+#include "epoch_reclaim.h"
+#include "batch_search.h"
+#include "log_policy.h"
+#include "random_level.h"
 
 #define STORE_FILE_OPT "store/dumpFile_optimized"
 
@@ -24,53 +41,149 @@ template<typename K, typename V>
 class NodeMemoryPool;
 
 //Class template to implement optimized node
+// 单次分配布局：[key | node_level | forward[0..level] | span[0..level] | value]
+// 内存池按层级分类复用，同层级节点大小一致
 template<typename K, typename V> 
 class NodeOpt {
 public:
-    NodeOpt() {} 
+    // 单次分配创建节点
+    static NodeOpt<K, V>* create(const K& k, const V& v, int level);
 
-    NodeOpt(K k, V v, int); 
+    // 原地构造：key 按值类别转发，args 直接转发给 V 的构造函数
+    template<typename KArg, typename... Args>
+    static NodeOpt<K, V>* emplace(int level, KArg&& k, Args&&... args);
 
-    ~NodeOpt();
+    // 在调用方提供的 allocation_size(level) 字节内存上构造节点（内存池从 slab 切分内存）
+    template<typename KArg, typename... Args>
+    static NodeOpt<K, V>* construct(void* memory, int level, KArg&& k, Args&&... args);
+
+    // 析构 key/value 并释放整块内存
+    static void destroy(NodeOpt<K, V>* node);
+
+    // 只析构 key/value，不释放内存
+    static void destruct(NodeOpt<K, V>* node);
+
+    // 指定层级节点所需的字节数
+    static size_t allocation_size(int level);
 
     K get_key() const;
 
     V get_value() const;
 
+    // 引用访问，供游标直接读取节点内的 key/value
+    const K& get_key_ref() const;
+
+    const V& get_value_ref() const;
+
+    // 按值接收，传入右值时整个过程只有移动
     void set_value(V);
     
     // 为内存池提供的重新设置键值的方法
-    void set_key_value(K k, V v);
-    
-    // Linear array to hold pointers to next node of different level
-    NodeOpt<K, V> **forward;
+    // args 恰为一个 V 时直接赋值（复用旧 value 已有的缓冲区），否则先构造再移动赋值
+    template<typename KArg, typename... Args>
+    void set_key_value(KArg&& k, Args&&... args);
 
+private:
+    K key;
+
+public:
     int node_level;
 
+    // 内联的 forward 塔，实际长度为 node_level + 1，必须是最后一个成员
+    // 写者在 _level_mutex 下构造完节点后以 release 链接，无锁读者经 next() 以 acquire 读取，
+    // 读到指针即能看到节点的 key、value 和塔
+    std::atomic<NodeOpt<K, V>*> forward[1];
+
+    NodeOpt<K, V>* next(int i) const;
+
+    // 第 i 层跨度：从本节点沿第 i 层走到 forward[i] 跨过的第 0 层节点数
+    // forward[i] 为空时为本节点之后剩余的元素个数
+    int* span() const;
+
 private:
-    K key;
-    V value;
+    template<typename KArg>
+    NodeOpt(KArg&& k, int level);
+    ~NodeOpt() {}
+
+    // 跨度数组紧跟在 forward 塔之后，value 在跨度数组之后
+    static size_t span_offset(int level);
+    static size_t value_offset(int level);
+    V* value_ptr() const;
     
     // 声明内存池为友元类
     friend class NodeMemoryPool<K, V>;
 };
 
 template<typename K, typename V> 
-NodeOpt<K, V>::NodeOpt(const K k, const V v, int level) {
-    this->key = k;
-    this->value = v;
-    this->node_level = level; 
-
-    // level + 1, because array index is from 0 - level
-    this->forward = new NodeOpt<K, V>*[level+1];
-    
+template<typename KArg>
+NodeOpt<K, V>::NodeOpt(KArg&& k, int level) : key(std::forward<KArg>(k)), node_level(level) {
     // Fill forward array with 0(NULL) 
-    memset(this->forward, 0, sizeof(NodeOpt<K, V>*)*(level+1));
+    for (int i = 0; i <= level; i++) {
+        this->forward[i].store(nullptr, std::memory_order_relaxed);
+    }
+    memset(this->span(), 0, sizeof(int)*(level+1));
+}
+
+template<typename K, typename V> 
+size_t NodeOpt<K, V>::span_offset(int level) {
+    return sizeof(NodeOpt<K, V>) + sizeof(std::atomic<NodeOpt<K, V>*>) * level;
+}
+
+template<typename K, typename V> 
+size_t NodeOpt<K, V>::value_offset(int level) {
+    size_t offset = span_offset(level) + sizeof(int) * (level + 1);
+    return (offset + alignof(V) - 1) / alignof(V) * alignof(V);
+}
+
+template<typename K, typename V> 
+int* NodeOpt<K, V>::span() const {
+    return reinterpret_cast<int*>(const_cast<char*>(reinterpret_cast<const char*>(this)) + span_offset(node_level));
+}
+
+template<typename K, typename V> 
+size_t NodeOpt<K, V>::allocation_size(int level) {
+    return value_offset(level) + sizeof(V);
+}
+
+template<typename K, typename V> 
+V* NodeOpt<K, V>::value_ptr() const {
+    return reinterpret_cast<V*>(const_cast<char*>(reinterpret_cast<const char*>(this)) + value_offset(node_level));
+}
+
+template<typename K, typename V> 
+NodeOpt<K, V>* NodeOpt<K, V>::create(const K& k, const V& v, int level) {
+    return emplace(level, k, v);
+}
+
+template<typename K, typename V> 
+template<typename KArg, typename... Args>
+NodeOpt<K, V>* NodeOpt<K, V>::emplace(int level, KArg&& k, Args&&... args) {
+    return construct(::operator new(allocation_size(level)), level, std::forward<KArg>(k), std::forward<Args>(args)...);
+}
+
+template<typename K, typename V> 
+template<typename KArg, typename... Args>
+NodeOpt<K, V>* NodeOpt<K, V>::construct(void* memory, int level, KArg&& k, Args&&... args) {
+    NodeOpt<K, V>* node = new (memory) NodeOpt<K, V>(std::forward<KArg>(k), level);
+    new (node->value_ptr()) V(std::forward<Args>(args)...);
+    return node;
+}
+
+template<typename K, typename V> 
+void NodeOpt<K, V>::destroy(NodeOpt<K, V>* node) {
+    destruct(node);
+    ::operator delete(static_cast<void*>(node));
+}
+
+template<typename K, typename V> 
+void NodeOpt<K, V>::destruct(NodeOpt<K, V>* node) {
+    node->value_ptr()->~V();
+    node->~NodeOpt<K, V>();
 }
 
 template<typename K, typename V> 
-NodeOpt<K, V>::~NodeOpt() {
-    delete []forward;
+NodeOpt<K, V>* NodeOpt<K, V>::next(int i) const {
+    return forward[i].load(std::memory_order_acquire);
 }
 
 template<typename K, typename V> 
@@ -80,80 +193,338 @@ K NodeOpt<K, V>::get_key() const {
 
 template<typename K, typename V> 
 V NodeOpt<K, V>::get_value() const {
-    return value;
+    return *value_ptr();
+}
+
+template<typename K, typename V> 
+const K& NodeOpt<K, V>::get_key_ref() const {
+    return key;
+}
+
+template<typename K, typename V> 
+const V& NodeOpt<K, V>::get_value_ref() const {
+    return *value_ptr();
 }
 
 template<typename K, typename V> 
 void NodeOpt<K, V>::set_value(V value) {
-    this->value = value;
+    *value_ptr() = std::move(value);
 }
 
 template<typename K, typename V> 
-void NodeOpt<K, V>::set_key_value(K k, V v) {
-    this->key = k;
-    this->value = v;
+template<typename KArg, typename... Args>
+void NodeOpt<K, V>::set_key_value(KArg&& k, Args&&... args) {
+    this->key = std::forward<KArg>(k);
+    if constexpr (sizeof...(Args) == 1 && (std::is_same<typename std::decay<Args>::type, V>::value && ...)) {
+        *value_ptr() = (std::forward<Args>(args), ...);
+    } else {
+        *value_ptr() = V(std::forward<Args>(args)...);
+    }
+}
+
+/**
+ * @brief memory_usage() 的结果，单位为字节（element_count、pending_reclaim_count 除外）
+ *
+ * 节点、塔、key、value 四项在节点链入时计入、宽限期后回收时扣除，因此包含等待回收的节点。
+ */
+struct MemoryUsage {
+    size_t element_count;           // 元素个数
+    size_t node_bytes;              // 存活节点的固定部分（node_level、对齐填充）
+    size_t tower_bytes;             // 存活节点的 forward 塔与跨度数组
+    size_t key_bytes;               // key 对象本身及其持有的堆内存
+    size_t value_bytes;             // value 对象本身及其持有的堆内存
+    size_t free_node_bytes;         // 内存池中的空闲节点（共享空闲列表 + 线程弹匣）
+    size_t pending_reclaim_count;   // 已删除、等待纪元宽限期的节点数
+    size_t slab_reserved_bytes;     // slab 当前向系统申请的字节数
+    size_t slab_released_bytes;     // 收缩累计归还系统的字节数
+};
+
+// 对象之外持有的堆内存字节数，供 memory_usage() 统计；默认为 0
+template<typename T>
+size_t payload_heap_bytes(const T&) {
+    return 0;
+}
+
+// std::string：短字符串存放在对象内部（SSO）时不占堆内存
+inline size_t payload_heap_bytes(const std::string& str) {
+    const char* self = reinterpret_cast<const char*>(&str);
+    if (str.data() >= self && str.data() < self + sizeof(str)) {
+        return 0;
+    }
+    return str.capacity() + 1;
 }
 
 // Class template for Skip list with optimizations
-template <typename K, typename V> 
+// LogPolicy 见 log_policy.h；日志在段锁内输出，生产环境建议使用 NullLogger 或 AsyncLogger
+template <typename K, typename V, typename LogPolicy = StdoutLogger>
 class SkipListOptimized {
 public: 
-    SkipListOptimized(int max_level, int segment_count = 16);
+    // magazine_size：内存池中每个线程每个层级缓存的节点数，0 表示不使用线程弹匣
+    // huge_pages：节点 slab 是否使用透明大页
+    SkipListOptimized(int max_level, int segment_count = 16,
+                      int magazine_size = NodeMemoryPool<K, V>::DEFAULT_MAGAZINE_SIZE,
+                      bool huge_pages = false);
+    // 按预期元素个数构造：max_level 取 LevelGenerator::max_level_for(expected_capacity, probability)
+    SkipListOptimized(size_t expected_capacity, LevelProbability probability, int segment_count = 16,
+                      int magazine_size = NodeMemoryPool<K, V>::DEFAULT_MAGAZINE_SIZE,
+                      bool huge_pages = false);
     ~SkipListOptimized();
     
-    int get_random_level();
-    NodeOpt<K, V>* create_node(K, V, int);
+    int get_random_level();                                            // [0, max_level]，线程局部随机源
+    // 设置分支因子（默认 1/2），只影响之后插入的节点；p = 1/4 时塔高平均减少约 1/3
+    void set_level_probability(LevelProbability probability);
+    LevelProbability get_level_probability() const;
+    int get_max_level() const { return _max_level; }
+    NodeOpt<K, V>* create_node(const K&, const V&, int);
     int insert_element(K, V);
+
+    // 单次下降的写接口（不输出日志），加锁方式与 insert_element 相同
+    int put(const K& key, const V& value);                             // 插入或原地覆盖
+    int put(const K& key, V&& value);                                  // 同上，value 移动进节点
+    template<typename... Args>
+    int emplace(const K& key, Args&&... args);                         // 不存在时用 args 原地构造 value
+    int put_if_absent(const K& key, const V& value);                   // 仅在不存在时插入
+    bool compare_and_swap(const K& key, const V& expected, const V& desired);
+    template<typename MergeOp>
+    int merge(const K& key, const V& operand, MergeOp op);             // 读-改-写合并
+
     void display_list();
     bool search_element(K);
     bool search_element_silent(K);  // 静默查询，不输出信息
+
+    /**
+     * @brief 原地读取：在段读锁和纪元临界区内以 visitor(const V&) 访问 value，不复制
+     *
+     * 同段的写入在 visitor 返回前被阻塞，visitor 中不能再调用本跳表的写接口。
+     * 不提供返回 const V* 的 find：指针离开段锁后可能被并发 put 改写。
+     */
+    template<typename Visitor>
+    bool get(const K& key, Visitor visitor);
+    // 批量查找：found[i] 表示 keys[i] 是否存在，存在时写入 values[i]，返回命中个数
+    int multi_get(const K* keys, size_t count, V* values, bool* found);
     void delete_element(K);
+    // 删除 [lo, hi] 内的所有元素，返回删除个数；持锁期间只做 O(log n) 的整段摘除，摘下的节点整批退休
+    int delete_range(const K& lo, const K& hi);
     void dump_file();
+    // 逐行解析快照，每满 LOAD_CHUNK 个元素调用一次 bulk_load，峰值内存与快照大小无关
     void load_file();
+    static const size_t LOAD_CHUNK = 4096;
     void clear(NodeOpt<K,V>*);
     int size();
     
     // 获取内存池统计信息
     void print_memory_pool_stats();
 
+    // 内存占用：按节点、塔、key、value 分项统计，各项增量维护，O(1)、不加锁；并发写入时为近似快照
+    MemoryUsage memory_usage();
+
+    // 保留内存预算与收缩，见 NodeMemoryPool
+    void set_memory_budget(size_t bytes);                               // 空闲节点的保留上限，默认不限
+    size_t trim_memory();                                               // 立即收缩，返回归还系统的字节数
+    void start_background_trim(std::chrono::milliseconds interval);     // 后台线程定期收缩
+    void stop_background_trim();
+
+    // 日志策略对象，用于 flush 或读取策略自身的统计
+    LogPolicy& logger() { return _logger; }
+
+    // 排名查询（基于每层跨度，均为 O(log n)，与写操作一样在层级锁下进行）
+    int rank(const K& key);                              // 小于 key 的元素个数，key 存在时即其 0 基排名
+    bool select(int k, K* key, V* value);                // 第 k 个元素（0 基），越界返回 false
+    int count_range(const K& start_key, const K& end_key);   // [start_key, end_key] 内的元素个数
+    std::vector<std::pair<K, V>> page(int offset, int limit); // 按位置分页，返回第 offset 起最多 limit 个元素
+
+    // 降序范围查询：[lo, hi] 内最大的至多 limit 个元素，按 key 降序，O(log n + m)；在层级锁下读取
+    std::vector<std::pair<K, V>> range_query_desc(const K& hi, const K& lo,
+                                                  int limit = std::numeric_limits<int>::max());
+
+    // 范围查询：[start_key, end_key] 内的键值对，按 key 升序
+    // 每次在层级锁下复制至多 RANGE_CHUNK 个，块之间释放锁让写线程进入，持锁时间与区间大小无关；
+    // 每块内部是一致快照，块之间可能有并发写入，结果仍严格升序
+    std::vector<std::pair<K, V>> range_query(const K& start_key, const K& end_key);
+    static const int RANGE_CHUNK = 256;
+
+    // 批量导入：[first, last) 为按 key 升序的 (key, value) 序列，整批持有所有段写锁和 _level_mutex，不输出日志
+    // key 大于表尾时直接接到各层尾部，整体 O(n)；乱序或与已有 key 重叠的部分按普通插入处理，已存在的 key 跳过
+    // balanced 为 true 时追加节点的层级由其位置决定（LevelGenerator::balanced_level），塔完全平衡
+    // 迭代器为 std::move_iterator 时 value 移动进节点；返回插入的元素个数
+    template<typename InputIt>
+    int bulk_load(InputIt first, InputIt last, bool balanced = false);
+
+    /**
+     * @brief 流式游标 - 沿第 0 层逐个访问元素，不分配内存
+     *
+     * 游标存活期间持有纪元守卫：并发删除的节点在游标释放前不会被回收，
+     * 游标停在已删除节点上时仍可继续 next()。移动游标不持有段锁，不阻塞写线程；
+     * seek / next 每一步经 NodeOpt::next() 以 acquire 读取，与写者链接时的 release 配对，到达的节点总是构造完整的。
+     * 但会推迟节点回收，长时间扫描结束后应尽快释放游标。
+     * put / compare_and_swap / merge 在段写锁下原地修改 value，因此读取 value 要持有该 key 的段读锁：
+     * value() 在锁内复制一份返回，read_value(visitor) 在锁内以 const V& 访问、不复制。
+     */
+    class Cursor {
+    public:
+        void seek(const K& key);        // 定位到第一个 >= key 的元素
+        void seek_to_first();
+        void seek_to_rank(int k);       // 定位到第 k 个元素（0 基），O(log n)
+        bool valid() const;
+        void next();
+        const K& key() const;
+        V value() const;
+        template<typename Visitor>
+        void read_value(Visitor visitor) const;
+
+    private:
+        friend class SkipListOptimized<K, V, LogPolicy>;
+        explicit Cursor(SkipListOptimized<K, V, LogPolicy>* list)
+            : _list(list), _guard(list->_epoch_manager.pin()), _node(nullptr) {}
+
+        SkipListOptimized<K, V, LogPolicy>* _list;
+        EpochManager::Guard _guard;
+        NodeOpt<K, V>* _node;
+    };
+
+    // 创建游标，初始状态无效，需先 seek
+    Cursor cursor();
+
+    /**
+     * @brief 反向游标 - 按 key 降序逐个访问元素
+     *
+     * 节点只有前向指针：在层级锁下按跨度定位到当前块之前第 BLOCK 个节点，沿第 0 层正向读入一块节点指针后逆序返回，
+     * 每个元素摊还 O(1 + log n / BLOCK)。下一块以当前块第一个 key 重新定位，只取比它小的节点，
+     * 块之间有并发写入时仍严格降序。与 Cursor 一样持有纪元守卫，块内节点在游标释放前不会被回收；
+     * value() / read_value() 同样在该 key 的段读锁下读取。
+     */
+    class ReverseCursor {
+    public:
+        void seek(const K& key);        // 定位到最后一个 <= key 的元素
+        void seek_to_last();
+        bool valid() const;
+        void next();                    // 移到前一个（key 更小的）元素
+        const K& key() const;
+        V value() const;
+        template<typename Visitor>
+        void read_value(Visitor visitor) const;
+
+    private:
+        friend class SkipListOptimized<K, V, LogPolicy>;
+        explicit ReverseCursor(SkipListOptimized<K, V, LogPolicy>* list)
+            : _list(list), _guard(list->_epoch_manager.pin()), _pos(-1) {}
+
+        // 读入排名在 [end - BLOCK, end) 内的节点，定位到其中最后一个；调用方需持有 _level_mutex
+        void load_block(int end);
+
+        static const int BLOCK = 64;
+        SkipListOptimized<K, V, LogPolicy>* _list;
+        EpochManager::Guard _guard;
+        std::vector<NodeOpt<K, V>*> _block;
+        int _pos;                       // 当前元素在 _block 中的下标，-1 表示无效
+    };
+
+    // 创建反向游标，初始状态无效，需先 seek
+    ReverseCursor reverse_cursor();
+
 private:
     void get_key_value_from_string(const std::string& str, std::string* key, std::string* value);
     bool is_valid_string(const std::string& str);
 
+    // 纪元回收回调：宽限期结束后将节点归还内存池
+    static void reclaim_node(void* ctx, void* node);
+
+    // 范围删除摘下的一段节点：first 起沿第 0 层的 count 个节点，作为一个对象退休
+    struct DetachedRun {
+        NodeOpt<K, V>* first;
+        size_t count;
+    };
+    static void reclaim_run(void* ctx, void* run);
+
+    // 以下两个函数需在持有 _level_mutex 时调用
+    // 小于（inclusive 时为小于等于）key 的元素个数
+    int count_less(const K& key, bool inclusive);
+
+    // 第 k 个节点（0 基），越界返回 nullptr
+    NodeOpt<K, V>* select_node(int k);
+
+    // 一次下降查找或插入，调用方需持有段写锁和 _level_mutex
+    // 仅在插入时用 args 构造 value，key 已存在时 args 不被使用
+    template<typename... Args>
+    NodeOpt<K, V>* find_or_insert(const K& key, bool* inserted, Args&&... args);
+
+    // 以 finger 为起点下降到 key 在第 0 层的前驱，路径与排名写回 _finger/_finger_rank
+    // 调用方需持有 _level_mutex
+    NodeOpt<K, V>* descend(const K& key);
+
+    // 批量导入的尾部追加：find_tail 把各层最后一个节点及其排名写入 finger（+∞ 的前驱路径），
+    // 追加期间尾节点的跨度只算到新节点为止，seal_tail 补齐为“之后剩余的元素个数”
+    // 调用方需持有 _level_mutex
+    void find_tail();
+    void seal_tail();
+
+    // put 的左值/右值两个重载共用的实现
+    template<typename VArg>
+    int put_value(const K& key, VArg&& value);
+
+    // 存活节点的分项字节数（memory_usage 用）：链入时 sign 为 1，回收时为 -1
+    void account_node(const NodeOpt<K, V>* node, int sign);
+
+    // 原地替换 value 并同步 value 的堆内存统计，调用方需持有该 key 的段写锁
+    template<typename VArg>
+    void assign_value(NodeOpt<K, V>* node, VArg&& value);
+
 private:    
     int _max_level;                                      // 跳表最大层级
-    int _skip_list_level;                                // 当前跳表层级
+    LevelGenerator _level_generator;                     // 随机层级生成器（在 _level_mutex 下使用）
+    std::atomic<int> _skip_list_level;                   // 当前跳表层级（在 _level_mutex 下修改，读路径原子读取）
     NodeOpt<K, V> *_header;                              // 头节点指针
+    std::vector<NodeOpt<K, V>*> _finger;                 // 上一次写操作在各层的前驱（在 _level_mutex 下读写）
+    std::vector<int> _finger_rank;                       // _finger 中各前驱的排名
     std::ofstream _file_writer;                          // 文件写入流
     std::ifstream _file_reader;                          // 文件读取流
-    int _element_count;                                  // 元素计数
+    ShardedCounter _element_count;                       // 元素计数（在 _level_mutex 下修改，size() 不加锁）
+    ShardedCounter _node_bytes;                          // 以下四项为 memory_usage() 的分项统计，
+    ShardedCounter _tower_bytes;                         // 节点链入时累加、回收时扣除，value 替换时更新
+    ShardedCounter _key_bytes;
+    ShardedCounter _value_bytes;
     
     // 优化模块
     SegmentLockManager<K> _lock_manager;                 // 分段锁管理器
     NodeMemoryPool<K, V> _memory_pool;                   // 内存池
+    EpochManager _epoch_manager;                         // 纪元回收（须在内存池之后声明，先于内存池析构）
     
     std::mutex _global_mutex;                            // 全局操作的互斥锁（如display_list）
-    std::mutex _level_mutex;                             // 保护 _skip_list_level 的互斥锁
-    std::mutex _count_mutex;                             // 保护 _element_count 的互斥锁
+    std::mutex _level_mutex;                             // 串行化层级与跨度的修改
+    LogPolicy _logger;                                   // 编译期选择的日志策略
 };
 
 // 构造函数
-template<typename K, typename V> 
-SkipListOptimized<K, V>::SkipListOptimized(int max_level, int segment_count) 
+template<typename K, typename V, typename LogPolicy>
+SkipListOptimized<K, V, LogPolicy>::SkipListOptimized(int max_level, int segment_count, int magazine_size, bool huge_pages) 
     : _max_level(max_level),
+      _level_generator(max_level),
       _skip_list_level(0),
-      _element_count(0),
       _lock_manager(segment_count),
-      _memory_pool(100) {
+      _memory_pool(100, magazine_size, huge_pages) {
     
-    K k;
-    V v;
-    this->_header = new NodeOpt<K, V>(k, v, _max_level);
+    K k{};
+    V v{};
+    this->_header = NodeOpt<K, V>::create(k, v, _max_level);
+
+    // 空表时 finger 各层都指向头节点
+    this->_finger.assign(_max_level + 1, _header);
+    this->_finger_rank.assign(_max_level + 1, 0);
+}
+
+// 按预期元素个数推导 max_level 的构造函数
+template<typename K, typename V, typename LogPolicy>
+SkipListOptimized<K, V, LogPolicy>::SkipListOptimized(size_t expected_capacity, LevelProbability probability,
+                                                      int segment_count, int magazine_size, bool huge_pages)
+    : SkipListOptimized(LevelGenerator::max_level_for(expected_capacity, probability),
+                        segment_count, magazine_size, huge_pages) {
+    _level_generator = LevelGenerator(_max_level, probability);
 }
 
 // 析构函数
-template<typename K, typename V> 
-SkipListOptimized<K, V>::~SkipListOptimized() {
+template<typename K, typename V, typename LogPolicy>
+SkipListOptimized<K, V, LogPolicy>::~SkipListOptimized() {
+    _memory_pool.stop_background_trim();
     if (_file_writer.is_open()) {
         _file_writer.close();
     }
@@ -161,32 +532,39 @@ SkipListOptimized<K, V>::~SkipListOptimized() {
         _file_reader.close();
     }
 
-    // 递归删除跳表链条
-    if(_header->forward[0] != nullptr){
-        clear(_header->forward[0]);
-    }
-    delete(_header);
+    // 析构跳表链条上的节点，内存随内存池的 slab 整块释放
+    clear(_header->next(0));
+    NodeOpt<K, V>::destroy(_header);
+
+    // 不再有并发读者，待回收节点直接归还内存池
+    _epoch_manager.drain();
 }
 
-// 递归清理节点
-template <typename K, typename V>
-void SkipListOptimized<K, V>::clear(NodeOpt<K, V>* cur) {
-    if(cur->forward[0] != nullptr){
-        clear(cur->forward[0]);
+// 清理 cur 及其后的所有节点（迭代，不递归）
+// 节点内存属于内存池的 slab，这里只析构 key/value，slab 随内存池整块释放
+template <typename K, typename V, typename LogPolicy>
+void SkipListOptimized<K, V, LogPolicy>::clear(NodeOpt<K, V>* cur) {
+    if constexpr (std::is_trivially_destructible<K>::value && std::is_trivially_destructible<V>::value) {
+        // key/value 无需析构：不遍历链表，整块释放 slab 即可
+        (void)cur;
+    } else {
+        while (cur != nullptr) {
+            NodeOpt<K, V>* next = cur->next(0);
+            _memory_pool.destroy(cur);
+            cur = next;
+        }
     }
-    // 使用内存池回收节点（注意：这里为了彻底清理，直接delete）
-    delete(cur);
 }
 
 // 使用内存池创建节点
-template<typename K, typename V>
-NodeOpt<K, V>* SkipListOptimized<K, V>::create_node(const K k, const V v, int level) {
+template<typename K, typename V, typename LogPolicy>
+NodeOpt<K, V>* SkipListOptimized<K, V, LogPolicy>::create_node(const K& k, const V& v, int level) {
     return _memory_pool.allocate(k, v, level);
 }
 
 // 插入元素 - 使用分段锁
-template<typename K, typename V>
-int SkipListOptimized<K, V>::insert_element(const K key, const V value) {
+template<typename K, typename V, typename LogPolicy>
+int SkipListOptimized<K, V, LogPolicy>::insert_element(const K key, V value) {
     // 获取key所属的段索引
     int segment_index = _lock_manager.get_segment_index(key);
     
@@ -196,61 +574,205 @@ int SkipListOptimized<K, V>::insert_element(const K key, const V value) {
     // 同时获取层级锁，避免在遍历过程中层级被其他线程修改
     std::lock_guard<std::mutex> level_lock(_level_mutex);
     
-    NodeOpt<K, V> *current = this->_header;
-    std::vector<NodeOpt<K, V>*> update(_max_level+1, nullptr);  
+    bool inserted = false;
+    NodeOpt<K, V>* node = find_or_insert(key, &inserted, std::move(value));
 
-    // 从最高层开始查找插入位置
-    for(int i = _skip_list_level; i >= 0; i--) {
-        while(current->forward[i] != NULL && current->forward[i]->get_key() < key) {
-            current = current->forward[i]; 
-        }
-        update[i] = current;
+    // 如果key已存在
+    if (!inserted) {
+        _logger.log("key: ", key, ", exists");
+        return 1;
     }
 
-    current = current->forward[0];
+    _logger.log("Successfully inserted key:", key, ", value:", node->get_value_ref());
+    return 0;
+}
+
+// 一次下降定位 key：已存在时返回该节点；不存在时以 V(args...) 插入并返回新节点
+// 调用方需持有 key 所在段的写锁和 _level_mutex
+template<typename K, typename V, typename LogPolicy>
+template<typename... Args>
+NodeOpt<K, V>* SkipListOptimized<K, V, LogPolicy>::find_or_insert(const K& key, bool* inserted, Args&&... args) {
+    // update 与 rank 就是 finger：本次下降的路径留给下一次写操作作为起点，也省去每次分配两个数组
+    // rank[i] 为 update[i] 之前的元素个数，用于计算新节点各层的跨度
+    NodeOpt<K, V> **update = _finger.data();
+    int *rank = _finger_rank.data();
+
+    // 从 finger 开始下降，key 紧随上次写入的 key 时只需检查最低的几层
+    NodeOpt<K, V> *current = descend(key)->next(0);
 
     // 如果key已存在
-    if (current != NULL && current->get_key() == key) {
-        std::cout << "key: " << key << ", exists" << std::endl;
-        return 1;
+    if (current != NULL && current->get_key_ref() == key) {
+        *inserted = false;
+        return current;
     }
 
     // 插入新节点
-    if (current == NULL || current->get_key() != key) {
-        int random_level = get_random_level();
+    int random_level = get_random_level();
 
-        // 更新跳表层级
-        if (random_level > _skip_list_level) {
-            for (int i = _skip_list_level+1; i < random_level+1; i++) {
-                update[i] = _header;
-            }
-            _skip_list_level = random_level;
+    // 更新跳表层级
+    if (random_level > _skip_list_level) {
+        for (int i = _skip_list_level+1; i < random_level+1; i++) {
+            rank[i] = 0;
+            update[i] = _header;
+            update[i]->span()[i] = (int)_element_count.load();
         }
+        _skip_list_level = random_level;
+    }
 
-        // 使用内存池创建节点
-        NodeOpt<K, V>* inserted_node = create_node(key, value, random_level);
-        
-        for (int i = 0; i <= random_level; i++) {
-            inserted_node->forward[i] = update[i]->forward[i];
-            update[i]->forward[i] = inserted_node;
+    // 使用内存池创建节点，value 的构造参数一路转发，不产生中间副本
+    NodeOpt<K, V>* inserted_node = _memory_pool.emplace(random_level, key, std::forward<Args>(args)...);
+    account_node(inserted_node, 1);
+    
+    // 新节点拆分前驱原有的跨度
+    for (int i = 0; i <= random_level; i++) {
+        inserted_node->forward[i].store(update[i]->next(i), std::memory_order_relaxed);
+        update[i]->forward[i].store(inserted_node, std::memory_order_release);
+
+        inserted_node->span()[i] = update[i]->span()[i] - (rank[0] - rank[i]);
+        update[i]->span()[i] = (rank[0] - rank[i]) + 1;
+    }
+
+    // 新节点没有到达的层，前驱跨度加一
+    for (int i = random_level + 1; i <= _skip_list_level; i++) {
+        update[i]->span()[i]++;
+    }
+    
+    // 更新元素计数：写入本线程的计数槽
+    _element_count.increment();
+    *inserted = true;
+    return inserted_node;
+}
+
+// finger 查找：从上一次写操作的路径出发，而不是每次从 _header 的最高层出发
+// 所有结构修改都在 _level_mutex 下经过这里，finger 在两次写操作之间始终是上次 key 的前驱路径。
+// 新 key 比上次大时自底向上找到第一层 top，使 finger[top] 在该层的后继不小于 key，
+// finger[top..] 即为 key 的前驱，只需从 top 层向下查找；顺序递增写入时每次摊还 O(1)。
+// 新 key 不大于上次写入的 key 时退回从 _header 下降。
+template<typename K, typename V, typename LogPolicy>
+NodeOpt<K, V>* SkipListOptimized<K, V, LogPolicy>::descend(const K& key) {
+    int level = _skip_list_level;
+    bool from_finger = _finger[0] == _header || _finger[0]->get_key_ref() < key;
+
+    int top = level;
+    if (from_finger) {
+        top = 0;
+        NodeOpt<K, V>* succ;
+        while (top < level && (succ = _finger[top]->next(top)) != nullptr && succ->get_key_ref() < key) {
+            top++;
         }
-        
-        std::cout << "Successfully inserted key:" << key << ", value:" << value << std::endl;
-        
-        // 更新元素计数（需要加锁保护）
-        {
-            std::lock_guard<std::mutex> count_lock(_count_mutex);
-            _element_count++;
+    }
+
+    NodeOpt<K, V>* current = from_finger ? _finger[top] : _header;
+    int traversed = from_finger ? _finger_rank[top] : 0;
+    for (int i = top; i >= 0; i--) {
+        // 更低层 finger 中的前驱更靠后时直接跳过去
+        if (from_finger && _finger_rank[i] > traversed) {
+            current = _finger[i];
+            traversed = _finger_rank[i];
+        }
+        NodeOpt<K, V>* succ;
+        while ((succ = current->next(i)) != nullptr && succ->get_key_ref() < key) {
+            traversed += current->span()[i];
+            current = succ;
         }
+        _finger[i] = current;
+        _finger_rank[i] = traversed;
     }
-    
-    return 0;
+    return current;
+}
+
+// 写入并覆盖：key 不存在时插入，存在时原地更新 value
+// 与 insert_element 相同的加锁方式，一次下降完成
+// return 0 means inserted, return 1 means overwritten
+template<typename K, typename V, typename LogPolicy>
+int SkipListOptimized<K, V, LogPolicy>::put(const K& key, const V& value) {
+    return put_value(key, value);
+}
+
+template<typename K, typename V, typename LogPolicy>
+int SkipListOptimized<K, V, LogPolicy>::put(const K& key, V&& value) {
+    return put_value(key, std::move(value));
+}
+
+template<typename K, typename V, typename LogPolicy>
+template<typename VArg>
+int SkipListOptimized<K, V, LogPolicy>::put_value(const K& key, VArg&& value) {
+    auto lock = _lock_manager.get_write_lock(_lock_manager.get_segment_index(key));
+    std::lock_guard<std::mutex> level_lock(_level_mutex);
+    bool inserted = false;
+    // 插入时 value 被转发进新节点，此后不再使用
+    NodeOpt<K, V>* node = find_or_insert(key, &inserted, std::forward<VArg>(value));
+    if (!inserted) {
+        assign_value(node, std::forward<VArg>(value));
+    }
+    return inserted ? 0 : 1;
+}
+
+// 原地构造：key 不存在时以 V(args...) 插入，存在时不构造 value
+// return 0 means inserted, return 1 means element exists
+template<typename K, typename V, typename LogPolicy>
+template<typename... Args>
+int SkipListOptimized<K, V, LogPolicy>::emplace(const K& key, Args&&... args) {
+    auto lock = _lock_manager.get_write_lock(_lock_manager.get_segment_index(key));
+    std::lock_guard<std::mutex> level_lock(_level_mutex);
+    bool inserted = false;
+    find_or_insert(key, &inserted, std::forward<Args>(args)...);
+    return inserted ? 0 : 1;
+}
+
+// 仅在 key 不存在时插入，不输出日志
+// return 0 means inserted, return 1 means element exists
+template<typename K, typename V, typename LogPolicy>
+int SkipListOptimized<K, V, LogPolicy>::put_if_absent(const K& key, const V& value) {
+    auto lock = _lock_manager.get_write_lock(_lock_manager.get_segment_index(key));
+    std::lock_guard<std::mutex> level_lock(_level_mutex);
+    bool inserted = false;
+    find_or_insert(key, &inserted, value);
+    return inserted ? 0 : 1;
+}
+
+// 比较并交换：key 存在且当前 value 等于 expected 时替换为 desired
+// 与 put 相同持有层级锁，select / page 等在层级锁下读取 value 的路径不会读到写了一半的值
+template<typename K, typename V, typename LogPolicy>
+bool SkipListOptimized<K, V, LogPolicy>::compare_and_swap(const K& key, const V& expected, const V& desired) {
+    auto lock = _lock_manager.get_write_lock(_lock_manager.get_segment_index(key));
+    std::lock_guard<std::mutex> level_lock(_level_mutex);
+
+    NodeOpt<K, V>* current = _header;
+    for (int i = _skip_list_level; i >= 0; i--) {
+        NodeOpt<K, V>* succ;
+        while ((succ = current->next(i)) != nullptr && succ->get_key_ref() < key) {
+            current = succ;
+        }
+    }
+    current = current->next(0);
+    if (current == NULL || !(current->get_key_ref() == key) || !(current->get_value_ref() == expected)) {
+        return false;
+    }
+    assign_value(current, desired);
+    return true;
+}
+
+// 合并写入：key 不存在时插入 operand，存在时 value = op(value, operand)
+// op 需满足结合律（如计数器累加），一次下降完成读-改-写
+// return 0 means inserted, return 1 means merged
+template<typename K, typename V, typename LogPolicy>
+template<typename MergeOp>
+int SkipListOptimized<K, V, LogPolicy>::merge(const K& key, const V& operand, MergeOp op) {
+    auto lock = _lock_manager.get_write_lock(_lock_manager.get_segment_index(key));
+    std::lock_guard<std::mutex> level_lock(_level_mutex);
+    bool inserted = false;
+    NodeOpt<K, V>* node = find_or_insert(key, &inserted, operand);
+    if (!inserted) {
+        assign_value(node, op(node->get_value_ref(), operand));
+    }
+    return inserted ? 0 : 1;
 }
 
 // 查找元素 - 使用分段读锁
-template<typename K, typename V> 
-bool SkipListOptimized<K, V>::search_element(K key) {
-    std::cout << "search_element-----------------" << std::endl;
+template<typename K, typename V, typename LogPolicy>
+bool SkipListOptimized<K, V, LogPolicy>::search_element(K key) {
+    _logger.log("search_element-----------------");
     
     // 获取key所属的段索引
     int segment_index = _lock_manager.get_segment_index(key);
@@ -258,68 +780,410 @@ bool SkipListOptimized<K, V>::search_element(K key) {
     // 获取该段的读锁（共享锁）
     auto lock = _lock_manager.get_read_lock(segment_index);
     
-    // 读取当前层级（快速读取后立即释放锁）
-    int current_level;
-    {
-        std::lock_guard<std::mutex> level_lock(_level_mutex);
-        current_level = _skip_list_level;
-    }
+    // 进入纪元临界区：段锁只保护本段，其他段的删除可能摘除遍历路径上的节点
+    auto guard = _epoch_manager.pin();
+    
+    // 读取当前层级：原子读，不经过层级锁
+    int current_level = _skip_list_level.load(std::memory_order_acquire);
     
     NodeOpt<K, V> *current = _header;
 
     for (int i = current_level; i >= 0; i--) {
-        while (current->forward[i] && current->forward[i]->get_key() < key) {
-            current = current->forward[i];
+        NodeOpt<K, V>* succ;
+        while ((succ = current->next(i)) != nullptr && succ->get_key_ref() < key) {
+            current = succ;
         }
     }
 
-    current = current->forward[0];
+    current = current->next(0);
 
-    if (current and current->get_key() == key) {
-        std::cout << "Found key: " << key << ", value: " << current->get_value() << std::endl;
+    if (current and current->get_key_ref() == key) {
+        _logger.log("Found key: ", key, ", value: ", current->get_value_ref());
         return true;
     }
 
-    std::cout << "Not Found Key:" << key << std::endl;
+    _logger.log("Not Found Key:", key);
     return false;
 }
 
 // 静默查找元素 - 不输出信息，用于性能测试
-template<typename K, typename V> 
-bool SkipListOptimized<K, V>::search_element_silent(K key) {
+template<typename K, typename V, typename LogPolicy>
+bool SkipListOptimized<K, V, LogPolicy>::search_element_silent(K key) {
     // 获取key所属的段索引
     int segment_index = _lock_manager.get_segment_index(key);
     
     // 获取该段的读锁（共享锁）
     auto lock = _lock_manager.get_read_lock(segment_index);
     
-    // 读取当前层级（快速读取后立即释放锁）
-    int current_level;
-    {
-        std::lock_guard<std::mutex> level_lock(_level_mutex);
-        current_level = _skip_list_level;
-    }
+    // 进入纪元临界区：段锁只保护本段，其他段的删除可能摘除遍历路径上的节点
+    auto guard = _epoch_manager.pin();
+    
+    // 读取当前层级：原子读，不经过层级锁
+    int current_level = _skip_list_level.load(std::memory_order_acquire);
     
     NodeOpt<K, V> *current = _header;
 
     for (int i = current_level; i >= 0; i--) {
-        while (current->forward[i] && current->forward[i]->get_key() < key) {
-            current = current->forward[i];
+        NodeOpt<K, V>* succ;
+        while ((succ = current->next(i)) != nullptr && succ->get_key_ref() < key) {
+            current = succ;
         }
     }
 
-    current = current->forward[0];
+    current = current->next(0);
 
-    if (current and current->get_key() == key) {
+    if (current and current->get_key_ref() == key) {
         return true;
     }
 
     return false;
 }
 
+// 原地读取 - 与 search_element_silent 相同的段读锁 + 纪元临界区，visitor 在锁内执行
+template<typename K, typename V, typename LogPolicy>
+template<typename Visitor>
+bool SkipListOptimized<K, V, LogPolicy>::get(const K& key, Visitor visitor) {
+    auto lock = _lock_manager.get_read_lock(_lock_manager.get_segment_index(key));
+    auto guard = _epoch_manager.pin();
+
+    // 读取当前层级：原子读，不经过层级锁
+    int current_level = _skip_list_level.load(std::memory_order_acquire);
+
+    NodeOpt<K, V>* current = _header;
+    for (int i = current_level; i >= 0; i--) {
+        NodeOpt<K, V>* succ;
+        while ((succ = current->next(i)) != nullptr && succ->get_key_ref() < key) {
+            current = succ;
+        }
+    }
+    current = current->next(0);
+
+    if (current == nullptr || !(current->get_key_ref() == key)) {
+        return false;
+    }
+    visitor(current->get_value_ref());
+    return true;
+}
+
+// 批量查找 - 按组交错遍历，每组按段号升序加读锁
+template<typename K, typename V, typename LogPolicy>
+int SkipListOptimized<K, V, LogPolicy>::multi_get(const K* keys, size_t count, V* values, bool* found) {
+    NodeOpt<K, V>* nodes[BATCH_SEARCH_GROUP];
+    int segments[BATCH_SEARCH_GROUP];
+    int hits = 0;
+
+    // 整批只进入一次纪元临界区
+    auto guard = _epoch_manager.pin();
+
+    for (size_t base = 0; base < count; base += BATCH_SEARCH_GROUP) {
+        size_t group = (count - base < (size_t)BATCH_SEARCH_GROUP) ? count - base : BATCH_SEARCH_GROUP;
+
+        // 本组涉及的段去重后按升序加锁，与 get_all_write_locks 的加锁顺序一致
+        for (size_t j = 0; j < group; j++) {
+            segments[j] = _lock_manager.get_segment_index(keys[base + j]);
+        }
+        std::sort(segments, segments + group);
+        int segment_count = std::unique(segments, segments + group) - segments;
+
+        std::vector<decltype(_lock_manager.get_read_lock(0))> locks;
+        locks.reserve(segment_count);
+        for (int s = 0; s < segment_count; s++) {
+            locks.push_back(_lock_manager.get_read_lock(segments[s]));
+        }
+
+        // 读取当前层级：原子读，不经过层级锁
+        int current_level = _skip_list_level.load(std::memory_order_acquire);
+
+        batch_lower_bound(_header, current_level, keys + base, group, nodes);
+
+        for (size_t j = 0; j < group; j++) {
+            NodeOpt<K, V>* node = nodes[j];
+            found[base + j] = (node != nullptr && node->get_key_ref() == keys[base + j]);
+            if (found[base + j]) {
+                values[base + j] = node->get_value_ref();
+                hits++;
+            }
+        }
+    }
+    return hits;
+}
+
+template<typename K, typename V, typename LogPolicy>
+int SkipListOptimized<K, V, LogPolicy>::count_less(const K& key, bool inclusive) {
+    NodeOpt<K, V>* current = _header;
+    int traversed = 0;
+    for (int i = _skip_list_level; i >= 0; i--) {
+        NodeOpt<K, V>* succ;
+        while ((succ = current->next(i)) != nullptr &&
+               (succ->get_key_ref() < key || (inclusive && succ->get_key_ref() == key))) {
+            traversed += current->span()[i];
+            current = succ;
+        }
+    }
+    return traversed;
+}
+
+template<typename K, typename V, typename LogPolicy>
+NodeOpt<K, V>* SkipListOptimized<K, V, LogPolicy>::select_node(int k) {
+    if (k < 0 || k >= (int)_element_count.load()) {
+        return nullptr;
+    }
+
+    // 第 k 个节点即从头节点起跨过 k + 1 步的节点
+    NodeOpt<K, V>* current = _header;
+    int traversed = 0;
+    for (int i = _skip_list_level; i >= 0; i--) {
+        NodeOpt<K, V>* succ;
+        while ((succ = current->next(i)) != nullptr && traversed + current->span()[i] <= k + 1) {
+            traversed += current->span()[i];
+            current = succ;
+        }
+        if (traversed == k + 1) {
+            return current;
+        }
+    }
+    return nullptr;
+}
+
+// 排名查询 - 小于 key 的元素个数
+// 跨度只在 _level_mutex 下修改，持有该锁即可得到一致的计数
+template<typename K, typename V, typename LogPolicy>
+int SkipListOptimized<K, V, LogPolicy>::rank(const K& key) {
+    std::lock_guard<std::mutex> level_lock(_level_mutex);
+    return count_less(key, false);
+}
+
+// 按位置查询第 k 个元素（0 基）
+template<typename K, typename V, typename LogPolicy>
+bool SkipListOptimized<K, V, LogPolicy>::select(int k, K* key, V* value) {
+    std::lock_guard<std::mutex> level_lock(_level_mutex);
+    NodeOpt<K, V>* node = select_node(k);
+    if (node == nullptr) {
+        return false;
+    }
+    *key = node->get_key_ref();
+    *value = node->get_value_ref();
+    return true;
+}
+
+// 区间计数 - 两次排名查询相减，不遍历区间内的节点
+template<typename K, typename V, typename LogPolicy>
+int SkipListOptimized<K, V, LogPolicy>::count_range(const K& start_key, const K& end_key) {
+    if (start_key > end_key) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> level_lock(_level_mutex);
+    return count_less(end_key, true) - count_less(start_key, false);
+}
+
+// 按位置分页 - 跨度定位起点后在第 0 层顺序读取
+template<typename K, typename V, typename LogPolicy>
+std::vector<std::pair<K, V>> SkipListOptimized<K, V, LogPolicy>::page(int offset, int limit) {
+    std::vector<std::pair<K, V>> result;
+    std::lock_guard<std::mutex> level_lock(_level_mutex);
+    NodeOpt<K, V>* current = select_node(offset);
+    while (current != nullptr && (int)result.size() < limit) {
+        result.push_back(std::make_pair(current->get_key_ref(), current->get_value_ref()));
+        current = current->next(0);
+    }
+    return result;
+}
+
+// 范围查询 - 定位 start_key 后在第 0 层顺序读取
+// 所有写操作都持有层级锁，持锁期间区间内的节点和 value 不会被修改
+template<typename K, typename V, typename LogPolicy>
+std::vector<std::pair<K, V>> SkipListOptimized<K, V, LogPolicy>::range_query(const K& start_key, const K& end_key) {
+    std::vector<std::pair<K, V>> result;
+    if (end_key < start_key) {
+        return result;
+    }
+
+    // 第一块从 >= start_key 开始，之后每块从上一块最后一个 key 之后重新下降
+    bool first_chunk = true;
+    while (true) {
+        std::lock_guard<std::mutex> level_lock(_level_mutex);
+        NodeOpt<K, V>* current = _header;
+        for (int i = _skip_list_level; i >= 0; i--) {
+            NodeOpt<K, V>* succ;
+            while ((succ = current->next(i)) != nullptr &&
+                   (first_chunk ? succ->get_key_ref() < start_key : !(result.back().first < succ->get_key_ref()))) {
+                current = succ;
+            }
+        }
+        current = current->next(0);
+        for (int copied = 0; copied < RANGE_CHUNK && current != nullptr && !(end_key < current->get_key_ref()); copied++) {
+            result.push_back(std::make_pair(current->get_key_ref(), current->get_value_ref()));
+            current = current->next(0);
+        }
+        if (current == nullptr || end_key < current->get_key_ref()) {
+            return result;
+        }
+        first_chunk = result.empty();
+    }
+}
+
+// 降序范围查询 - [lo, hi] 内元素的排名为 [count_less(lo), count_less(hi, inclusive))
+// 按排名定位到第一个要返回的节点，沿第 0 层正向读取 m 个后整体反转
+template<typename K, typename V, typename LogPolicy>
+std::vector<std::pair<K, V>> SkipListOptimized<K, V, LogPolicy>::range_query_desc(const K& hi, const K& lo, int limit) {
+    std::vector<std::pair<K, V>> result;
+    if (hi < lo || limit <= 0) {
+        return result;
+    }
+
+    std::lock_guard<std::mutex> level_lock(_level_mutex);
+    int end = count_less(hi, true);
+    int begin = std::max(count_less(lo, false), end - limit);
+    if (begin >= end) {
+        return result;
+    }
+    result.reserve(end - begin);
+    NodeOpt<K, V>* current = select_node(begin);
+    for (int i = begin; i < end; i++) {
+        result.push_back(std::make_pair(current->get_key_ref(), current->get_value_ref()));
+        current = current->next(0);
+    }
+    std::reverse(result.begin(), result.end());
+    return result;
+}
+
+template<typename K, typename V, typename LogPolicy>
+typename SkipListOptimized<K, V, LogPolicy>::Cursor SkipListOptimized<K, V, LogPolicy>::cursor() {
+    return Cursor(this);
+}
+
+template<typename K, typename V, typename LogPolicy>
+void SkipListOptimized<K, V, LogPolicy>::Cursor::seek(const K& key) {
+    // 读取当前层级：原子读，不经过层级锁
+    int current_level = _list->_skip_list_level.load(std::memory_order_acquire);
+
+    NodeOpt<K, V>* current = _list->_header;
+    for (int i = current_level; i >= 0; i--) {
+        NodeOpt<K, V>* succ;
+        while ((succ = current->next(i)) != nullptr && succ->get_key_ref() < key) {
+            current = succ;
+        }
+    }
+    _node = current->next(0);
+}
+
+template<typename K, typename V, typename LogPolicy>
+void SkipListOptimized<K, V, LogPolicy>::Cursor::seek_to_first() {
+    _node = _list->_header->next(0);
+}
+
+template<typename K, typename V, typename LogPolicy>
+void SkipListOptimized<K, V, LogPolicy>::Cursor::seek_to_rank(int k) {
+    std::lock_guard<std::mutex> level_lock(_list->_level_mutex);
+    _node = _list->select_node(k);
+}
+
+template<typename K, typename V, typename LogPolicy>
+bool SkipListOptimized<K, V, LogPolicy>::Cursor::valid() const {
+    return _node != nullptr;
+}
+
+template<typename K, typename V, typename LogPolicy>
+void SkipListOptimized<K, V, LogPolicy>::Cursor::next() {
+    _node = _node->next(0);
+}
+
+template<typename K, typename V, typename LogPolicy>
+const K& SkipListOptimized<K, V, LogPolicy>::Cursor::key() const {
+    return _node->get_key_ref();
+}
+
+// 返回值在段读锁释放前构造
+template<typename K, typename V, typename LogPolicy>
+V SkipListOptimized<K, V, LogPolicy>::Cursor::value() const {
+    const NodeOpt<K, V>* node = _node;
+    auto lock = _list->_lock_manager.get_read_lock(_list->_lock_manager.get_segment_index(node->get_key_ref()));
+    return node->get_value_ref();
+}
+
+template<typename K, typename V, typename LogPolicy>
+template<typename Visitor>
+void SkipListOptimized<K, V, LogPolicy>::Cursor::read_value(Visitor visitor) const {
+    const NodeOpt<K, V>* node = _node;
+    auto lock = _list->_lock_manager.get_read_lock(_list->_lock_manager.get_segment_index(node->get_key_ref()));
+    visitor(node->get_value_ref());
+}
+
+template<typename K, typename V, typename LogPolicy>
+typename SkipListOptimized<K, V, LogPolicy>::ReverseCursor SkipListOptimized<K, V, LogPolicy>::reverse_cursor() {
+    return ReverseCursor(this);
+}
+
+template<typename K, typename V, typename LogPolicy>
+void SkipListOptimized<K, V, LogPolicy>::ReverseCursor::load_block(int end) {
+    _block.clear();
+    int start = std::max(0, end - BLOCK);
+    NodeOpt<K, V>* current = _list->select_node(start);
+    for (int i = start; i < end && current != nullptr; i++) {
+        _block.push_back(current);
+        current = current->next(0);
+    }
+    _pos = (int)_block.size() - 1;
+}
+
+template<typename K, typename V, typename LogPolicy>
+void SkipListOptimized<K, V, LogPolicy>::ReverseCursor::seek(const K& key) {
+    std::lock_guard<std::mutex> level_lock(_list->_level_mutex);
+    load_block(_list->count_less(key, true));
+}
+
+template<typename K, typename V, typename LogPolicy>
+void SkipListOptimized<K, V, LogPolicy>::ReverseCursor::seek_to_last() {
+    std::lock_guard<std::mutex> level_lock(_list->_level_mutex);
+    load_block((int)_list->_element_count.load());
+}
+
+template<typename K, typename V, typename LogPolicy>
+bool SkipListOptimized<K, V, LogPolicy>::ReverseCursor::valid() const {
+    return _pos >= 0;
+}
+
+template<typename K, typename V, typename LogPolicy>
+void SkipListOptimized<K, V, LogPolicy>::ReverseCursor::next() {
+    if (_pos > 0) {
+        _pos--;
+        return;
+    }
+    if (_pos < 0) {
+        return;
+    }
+    // 以当前块第一个 key 重新定位，块之间的插入、删除不会导致重复或乱序
+    std::lock_guard<std::mutex> level_lock(_list->_level_mutex);
+    load_block(_list->count_less(_block[0]->get_key_ref(), false));
+}
+
+template<typename K, typename V, typename LogPolicy>
+const K& SkipListOptimized<K, V, LogPolicy>::ReverseCursor::key() const {
+    return _block[_pos]->get_key_ref();
+}
+
+// 返回值在段读锁释放前构造
+template<typename K, typename V, typename LogPolicy>
+V SkipListOptimized<K, V, LogPolicy>::ReverseCursor::value() const {
+    const NodeOpt<K, V>* node = _block[_pos];
+    auto lock = _list->_lock_manager.get_read_lock(_list->_lock_manager.get_segment_index(node->get_key_ref()));
+    return node->get_value_ref();
+}
+
+template<typename K, typename V, typename LogPolicy>
+template<typename Visitor>
+void SkipListOptimized<K, V, LogPolicy>::ReverseCursor::read_value(Visitor visitor) const {
+    const NodeOpt<K, V>* node = _block[_pos];
+    auto lock = _list->_lock_manager.get_read_lock(_list->_lock_manager.get_segment_index(node->get_key_ref()));
+    visitor(node->get_value_ref());
+}
+
 // 删除元素 - 使用分段锁
-template<typename K, typename V> 
-void SkipListOptimized<K, V>::delete_element(K key) {
+template<typename K, typename V, typename LogPolicy>
+void SkipListOptimized<K, V, LogPolicy>::delete_element(K key) {
+    // 守卫先于锁构造、后于锁析构：临界区内的 retire 只登记不回收，推进纪元和回收都在守卫离开时（锁已释放）进行
+    auto guard = _epoch_manager.pin();
+
     // 获取key所属的段索引
     int segment_index = _lock_manager.get_segment_index(key);
     
@@ -329,83 +1193,139 @@ void SkipListOptimized<K, V>::delete_element(K key) {
     // 同时获取层级锁
     std::lock_guard<std::mutex> level_lock(_level_mutex);
     
-    NodeOpt<K, V> *current = this->_header; 
-    std::vector<NodeOpt<K, V>*> update(_max_level+1, nullptr);
-
-    for (int i = _skip_list_level; i >= 0; i--) {
-        while (current->forward[i] != NULL && current->forward[i]->get_key() < key) {
-            current = current->forward[i];
-        }
-        update[i] = current;
-    }
-
-    current = current->forward[0];
+    // 删除后各层前驱及其排名不变，路径仍可作为 finger
+    NodeOpt<K, V> **update = _finger.data();
+    NodeOpt<K, V> *current = descend(key)->next(0);
     
-    if (current != NULL && current->get_key() == key) {
+    if (current != NULL && current->get_key_ref() == key) {
+        // 被删节点所在层合并跨度，其余层前驱跨度减一
         for (int i = 0; i <= _skip_list_level; i++) {
-            if (update[i]->forward[i] != current) 
-                break;
-            update[i]->forward[i] = current->forward[i];
+            if (update[i]->next(i) == current) {
+                update[i]->span()[i] += current->span()[i] - 1;
+                update[i]->forward[i].store(current->next(i), std::memory_order_release);
+            } else {
+                update[i]->span()[i]--;
+            }
         }
 
         // 更新跳表层级
-        while (_skip_list_level > 0 && _header->forward[_skip_list_level] == 0) {
+        while (_skip_list_level > 0 && _header->next(_skip_list_level) == nullptr) {
             _skip_list_level--; 
         }
 
-        std::cout << "Successfully deleted key "<< key << std::endl;
+        _logger.log("Successfully deleted key ", key);
         
-        // 将节点归还到内存池（这里为了简化，直接delete）
-        // 在实际应用中，可以归还到内存池复用
-        delete current;
+        // 其他段的读者可能仍持有该节点，延迟到宽限期结束后再归还内存池
+        _epoch_manager.retire(current, &SkipListOptimized<K, V, LogPolicy>::reclaim_node, this);
         
-        // 更新元素计数（需要加锁保护）
-        {
-            std::lock_guard<std::mutex> count_lock(_count_mutex);
-            _element_count--;
+        // 更新元素计数：写入本线程的计数槽
+        _element_count.decrement();
+    }
+}
+
+// 范围删除 - 持有全部段写锁和 _level_mutex
+// 两次下降得到 lo、hi 两侧的路径，区间在第 i 层有节点时让 lo 一侧的前驱直接指向 hi 一侧的后继，整段摘除；
+// 摘下的节点保持原有的 forward 指针，仍停在其中的读者可以继续向后走出区间。
+// 整段作为一个对象退休，段写锁和 _level_mutex 的持有时间与区间大小无关：退休只登记，宽限期结束后
+// 由某次离开临界区的线程在锁外分批归还内存池（每批短暂持有 _pool_mutex）
+template<typename K, typename V, typename LogPolicy>
+int SkipListOptimized<K, V, LogPolicy>::delete_range(const K& lo, const K& hi) {
+    if (hi < lo) {
+        return 0;
+    }
+
+    // 与 delete_element 相同，在锁外的临界区出口回收
+    auto guard = _epoch_manager.pin();
+    auto locks = _lock_manager.get_all_write_locks();
+    std::lock_guard<std::mutex> level_lock(_level_mutex);
+
+    // lo 一侧的路径写入 finger：摘除后各层前驱及其排名不变
+    NodeOpt<K, V>** update = _finger.data();
+    int* rank = _finger_rank.data();
+    descend(lo);
+
+    // hi 一侧：每层最后一个 <= hi 的节点，从 lo 的路径继续向后找
+    int level = _skip_list_level;
+    std::vector<NodeOpt<K, V>*> last(level + 1);
+    std::vector<int> last_rank(level + 1);
+    NodeOpt<K, V>* current = update[level];
+    int traversed = rank[level];
+    for (int i = level; i >= 0; i--) {
+        if (rank[i] > traversed) {
+            current = update[i];
+            traversed = rank[i];
+        }
+        NodeOpt<K, V>* succ;
+        while ((succ = current->next(i)) != nullptr && !(hi < succ->get_key_ref())) {
+            traversed += current->span()[i];
+            current = succ;
+        }
+        last[i] = current;
+        last_rank[i] = traversed;
+    }
+
+    int removed = last_rank[0] - rank[0];
+    if (removed == 0) {
+        return 0;
+    }
+    NodeOpt<K, V>* detached = update[0]->next(0);
+
+    for (int i = 0; i <= level; i++) {
+        if (last[i] != update[i]) {
+            // 新跨度 = update[i] 到 last[i] 后继的距离减去删除个数
+            update[i]->span()[i] = last_rank[i] + last[i]->span()[i] - rank[i] - removed;
+            update[i]->forward[i].store(last[i]->next(i), std::memory_order_release);
+        } else {
+            update[i]->span()[i] -= removed;
         }
     }
+
+    while (_skip_list_level > 0 && _header->next(_skip_list_level) == nullptr) {
+        _skip_list_level--;
+    }
+
+    _logger.log("Successfully deleted ", removed, " keys in [", lo, ", ", hi, "]");
+    _epoch_manager.retire(new DetachedRun{detached, (size_t)removed},
+                          &SkipListOptimized<K, V, LogPolicy>::reclaim_run, this);
+    _element_count.add(-removed);
+    return removed;
 }
 
 // 显示跳表 - 需要全局读锁
-template<typename K, typename V> 
-void SkipListOptimized<K, V>::display_list() {
+template<typename K, typename V, typename LogPolicy>
+void SkipListOptimized<K, V, LogPolicy>::display_list() {
     std::lock_guard<std::mutex> lock(_global_mutex);
     
-    // 读取当前层级（需要加锁保护）
-    int current_level;
-    {
-        std::lock_guard<std::mutex> level_lock(_level_mutex);
-        current_level = _skip_list_level;
-    }
+    // 读取当前层级：原子读，不经过层级锁
+    int current_level = _skip_list_level.load(std::memory_order_acquire);
     
     std::cout << "\n*****Skip List (Optimized)*****"<<"\n"; 
     for (int i = 0; i <= current_level; i++) {
-        NodeOpt<K, V> *node = this->_header->forward[i]; 
+        NodeOpt<K, V> *node = this->_header->next(i); 
         std::cout << "Level " << i << ": ";
         while (node != NULL) {
-            std::cout << node->get_key() << ":" << node->get_value() << ";";
-            node = node->forward[i];
+            std::cout << node->get_key_ref() << ":" << node->get_value_ref() << ";";
+            node = node->next(i);
         }
         std::cout << std::endl;
     }
 }
 
 // 持久化到文件 - 需要获取所有段的写锁
-template<typename K, typename V> 
-void SkipListOptimized<K, V>::dump_file() {
+template<typename K, typename V, typename LogPolicy>
+void SkipListOptimized<K, V, LogPolicy>::dump_file() {
     std::cout << "dump_file-----------------" << std::endl;
     
     // 获取所有段的写锁
     auto locks = _lock_manager.get_all_write_locks();
     
     _file_writer.open(STORE_FILE_OPT);
-    NodeOpt<K, V> *node = this->_header->forward[0]; 
+    NodeOpt<K, V> *node = this->_header->next(0); 
 
     while (node != NULL) {
-        _file_writer << node->get_key() << ":" << node->get_value() << "\n";
-        std::cout << node->get_key() << ":" << node->get_value() << ";\n";
-        node = node->forward[0];
+        _file_writer << node->get_key_ref() << ":" << node->get_value_ref() << "\n";
+        std::cout << node->get_key_ref() << ":" << node->get_value_ref() << ";\n";
+        node = node->next(0);
     }
 
     _file_writer.flush();
@@ -413,38 +1333,133 @@ void SkipListOptimized<K, V>::dump_file() {
 }
 
 // 从文件加载
-template<typename K, typename V> 
-void SkipListOptimized<K, V>::load_file() {
+template<typename K, typename V, typename LogPolicy>
+void SkipListOptimized<K, V, LogPolicy>::load_file() {
     _file_reader.open(STORE_FILE_OPT);
     std::cout << "load_file-----------------" << std::endl;
     std::string line;
     std::string* key = new std::string();
     std::string* value = new std::string();
     
+    // dump_file 按 key 升序写出，按块批量导入：各块依次接到表尾，整体仍为追加模式
+    std::vector<std::pair<K, V>> entries;
+    entries.reserve(LOAD_CHUNK);
     while (getline(_file_reader, line)) {
         get_key_value_from_string(line, key, value);
         if (key->empty() || value->empty()) {
             continue;
         }
-        insert_element(stoi(*key), *value);
-        std::cout << "key:" << *key << " value:" << *value << std::endl;
+        entries.emplace_back(stoi(*key), *value);
+        _logger.log("key:", *key, " value:", *value);
+        if (entries.size() == LOAD_CHUNK) {
+            bulk_load(std::make_move_iterator(entries.begin()), std::make_move_iterator(entries.end()));
+            entries.clear();
+        }
     }
     
     delete key;
     delete value;
     _file_reader.close();
+    bulk_load(std::make_move_iterator(entries.begin()), std::make_move_iterator(entries.end()));
+}
+
+// 有序批量导入，追加模式与基础版相同：finger 即各层的尾节点，新节点接到尾部并成为新的尾节点
+// 持有全部段写锁，按段加读锁的查询在导入期间等待；游标不持段锁，可能看到导入到一半的表
+template<typename K, typename V, typename LogPolicy>
+template<typename InputIt>
+int SkipListOptimized<K, V, LogPolicy>::bulk_load(InputIt first, InputIt last, bool balanced) {
+    auto locks = _lock_manager.get_all_write_locks();
+    std::lock_guard<std::mutex> level_lock(_level_mutex);
+    NodeOpt<K, V>** tail = _finger.data();
+    int* tail_rank = _finger_rank.data();
+    int count = (int)_element_count.load();
+    int loaded = 0;
+
+    find_tail();
+    bool appending = true;
+    for (; first != last; ++first) {
+        const K& key = (*first).first;
+        if (appending && tail[0] != _header && !(tail[0]->get_key_ref() < key)) {
+            seal_tail();
+            appending = false;
+        }
+
+        if (!appending) {
+            bool inserted = false;
+            NodeOpt<K, V>* node = find_or_insert(key, &inserted, (*first).second);
+            if (inserted) {
+                count++;
+                loaded++;
+            }
+            if (node->next(0) == nullptr) {
+                find_tail();
+                appending = true;
+            }
+            continue;
+        }
+
+        int position = count + 1;
+        int level = balanced ? _level_generator.balanced_level(position) : get_random_level();
+        if (level > _skip_list_level) {
+            for (int i = _skip_list_level + 1; i <= level; i++) {
+                tail[i] = _header;
+                tail_rank[i] = 0;
+            }
+            _skip_list_level = level;
+        }
+
+        NodeOpt<K, V>* node = _memory_pool.emplace(level, key, (*first).second);
+        account_node(node, 1);
+        for (int i = 0; i <= level; i++) {
+            tail[i]->forward[i].store(node, std::memory_order_release);
+            tail[i]->span()[i] = position - tail_rank[i];
+            tail[i] = node;
+            tail_rank[i] = position;
+        }
+        _element_count.increment();
+        count++;
+        loaded++;
+    }
+    if (appending) {
+        seal_tail();
+    }
+    return loaded;
+}
+
+template<typename K, typename V, typename LogPolicy>
+void SkipListOptimized<K, V, LogPolicy>::find_tail() {
+    NodeOpt<K, V>* current = _header;
+    int traversed = 0;
+    for (int i = _skip_list_level; i >= 0; i--) {
+        NodeOpt<K, V>* succ;
+        while ((succ = current->next(i)) != nullptr) {
+            traversed += current->span()[i];
+            current = succ;
+        }
+        _finger[i] = current;
+        _finger_rank[i] = traversed;
+    }
+}
+
+template<typename K, typename V, typename LogPolicy>
+void SkipListOptimized<K, V, LogPolicy>::seal_tail() {
+    // 写入都在 _level_mutex 下，此时计数是精确值
+    int count = (int)_element_count.load();
+    for (int i = 0; i <= _skip_list_level; i++) {
+        _finger[i]->span()[i] = count - _finger_rank[i];
+    }
 }
 
 // 获取元素数量
-template<typename K, typename V> 
-int SkipListOptimized<K, V>::size() { 
-    std::lock_guard<std::mutex> count_lock(_count_mutex);
-    return _element_count;
+template<typename K, typename V, typename LogPolicy>
+int SkipListOptimized<K, V, LogPolicy>::size() { 
+    // 各线程计数槽求和，不加锁；并发写入时为近似值
+    return (int)_element_count.load();
 }
 
 // 解析字符串获取key-value
-template<typename K, typename V>
-void SkipListOptimized<K, V>::get_key_value_from_string(const std::string& str, std::string* key, std::string* value) {
+template<typename K, typename V, typename LogPolicy>
+void SkipListOptimized<K, V, LogPolicy>::get_key_value_from_string(const std::string& str, std::string* key, std::string* value) {
     if(!is_valid_string(str)) {
         return;
     }
@@ -454,8 +1469,8 @@ void SkipListOptimized<K, V>::get_key_value_from_string(const std::string& str,
 }
 
 // 验证字符串格式
-template<typename K, typename V>
-bool SkipListOptimized<K, V>::is_valid_string(const std::string& str) {
+template<typename K, typename V, typename LogPolicy>
+bool SkipListOptimized<K, V, LogPolicy>::is_valid_string(const std::string& str) {
     if (str.empty()) {
         return false;
     }
@@ -466,29 +1481,132 @@ bool SkipListOptimized<K, V>::is_valid_string(const std::string& str) {
 }
 
 // 获取随机层级
-template<typename K, typename V>
-int SkipListOptimized<K, V>::get_random_level(){
-    int k = 1;
-    while (rand() % 2) {
-        k++;
+template<typename K, typename V, typename LogPolicy>
+int SkipListOptimized<K, V, LogPolicy>::get_random_level(){
+    return _level_generator.next();
+}
+
+// 设置分支因子，与插入共用 _level_mutex
+template<typename K, typename V, typename LogPolicy>
+void SkipListOptimized<K, V, LogPolicy>::set_level_probability(LevelProbability probability) {
+    std::lock_guard<std::mutex> level_lock(_level_mutex);
+    _level_generator = LevelGenerator(_max_level, probability);
+}
+
+template<typename K, typename V, typename LogPolicy>
+LevelProbability SkipListOptimized<K, V, LogPolicy>::get_level_probability() const {
+    return _level_generator.probability();
+}
+
+// 纪元回收回调
+template<typename K, typename V, typename LogPolicy>
+void SkipListOptimized<K, V, LogPolicy>::reclaim_node(void* ctx, void* node) {
+    SkipListOptimized<K, V, LogPolicy>* list = static_cast<SkipListOptimized<K, V, LogPolicy>*>(ctx);
+    list->account_node(static_cast<NodeOpt<K, V>*>(node), -1);
+    list->_memory_pool.deallocate(static_cast<NodeOpt<K, V>*>(node));
+}
+
+// 范围删除的整段回收：扣除分项统计后分批归还内存池
+template<typename K, typename V, typename LogPolicy>
+void SkipListOptimized<K, V, LogPolicy>::reclaim_run(void* ctx, void* run) {
+    SkipListOptimized<K, V, LogPolicy>* list = static_cast<SkipListOptimized<K, V, LogPolicy>*>(ctx);
+    DetachedRun* detached = static_cast<DetachedRun*>(run);
+    NodeOpt<K, V>* node = detached->first;
+    for (size_t i = 0; i < detached->count; i++) {
+        list->account_node(node, -1);
+        node = node->next(0);
     }
-    k = (k < _max_level) ? k : _max_level;
-    return k;
+    list->_memory_pool.deallocate_chain(detached->first, detached->count);
+    delete detached;
+}
+
+template<typename K, typename V, typename LogPolicy>
+void SkipListOptimized<K, V, LogPolicy>::account_node(const NodeOpt<K, V>* node, int sign) {
+    int level = node->node_level;
+    size_t tower = (level + 1) * (sizeof(std::atomic<NodeOpt<K, V>*>) + sizeof(int));
+    _tower_bytes.add(sign * (int64_t)tower);
+    _node_bytes.add(sign * (int64_t)(NodeOpt<K, V>::allocation_size(level) - tower - sizeof(K) - sizeof(V)));
+    _key_bytes.add(sign * (int64_t)(sizeof(K) + payload_heap_bytes(node->get_key_ref())));
+    _value_bytes.add(sign * (int64_t)(sizeof(V) + payload_heap_bytes(node->get_value_ref())));
+}
+
+template<typename K, typename V, typename LogPolicy>
+template<typename VArg>
+void SkipListOptimized<K, V, LogPolicy>::assign_value(NodeOpt<K, V>* node, VArg&& value) {
+    int64_t before = (int64_t)payload_heap_bytes(node->get_value_ref());
+    node->set_value(std::forward<VArg>(value));
+    _value_bytes.add((int64_t)payload_heap_bytes(node->get_value_ref()) - before);
+}
+
+// 内存占用统计
+template<typename K, typename V, typename LogPolicy>
+MemoryUsage SkipListOptimized<K, V, LogPolicy>::memory_usage() {
+    // 各项由写路径和回收回调增量维护，这里只读取计数器，不加锁、不遍历
+    MemoryUsage usage = {};
+    usage.element_count = (size_t)_element_count.load();
+    usage.node_bytes = (size_t)_node_bytes.load();
+    usage.tower_bytes = (size_t)_tower_bytes.load();
+    usage.key_bytes = (size_t)_key_bytes.load();
+    usage.value_bytes = (size_t)_value_bytes.load();
+    usage.free_node_bytes = _memory_pool.get_free_bytes();
+    usage.pending_reclaim_count = _epoch_manager.get_pending_count();
+    usage.slab_reserved_bytes = _memory_pool.get_arena().get_reserved_bytes();
+    usage.slab_released_bytes = _memory_pool.get_released_bytes();
+    return usage;
+}
+
+template<typename K, typename V, typename LogPolicy>
+void SkipListOptimized<K, V, LogPolicy>::set_memory_budget(size_t bytes) {
+    _memory_pool.set_memory_budget(bytes);
+}
+
+template<typename K, typename V, typename LogPolicy>
+size_t SkipListOptimized<K, V, LogPolicy>::trim_memory() {
+    return _memory_pool.trim();
+}
+
+template<typename K, typename V, typename LogPolicy>
+void SkipListOptimized<K, V, LogPolicy>::start_background_trim(std::chrono::milliseconds interval) {
+    _memory_pool.start_background_trim(interval);
+}
+
+template<typename K, typename V, typename LogPolicy>
+void SkipListOptimized<K, V, LogPolicy>::stop_background_trim() {
+    _memory_pool.stop_background_trim();
 }
 
 // 打印内存池统计信息
-template<typename K, typename V>
-void SkipListOptimized<K, V>::print_memory_pool_stats() {
+template<typename K, typename V, typename LogPolicy>
+void SkipListOptimized<K, V, LogPolicy>::print_memory_pool_stats() {
     std::cout << "\n===== Memory Pool Statistics =====" << std::endl;
     std::cout << "Total allocations: " << _memory_pool.get_allocated_count() << std::endl;
     std::cout << "Reused allocations: " << _memory_pool.get_reused_count() << std::endl;
     std::cout << "Free list size: " << _memory_pool.get_free_list_size() << std::endl;
+    std::cout << "Pending reclamation: " << _epoch_manager.get_pending_count() << std::endl;
+    const SlabArena& arena = _memory_pool.get_arena();
+    std::cout << "Slabs: " << arena.get_slab_count() << " x " << (arena.get_slab_size() >> 10) << " KB, used "
+              << (arena.get_used_bytes() >> 10) << " KB of " << (arena.get_reserved_bytes() >> 10) << " KB" << std::endl;
+    std::cout << "Free node bytes: " << _memory_pool.get_free_bytes() << ", released by trim: "
+              << _memory_pool.get_released_bytes() << std::endl;
     
     if (_memory_pool.get_allocated_count() > 0) {
         double reuse_rate = (double)_memory_pool.get_reused_count() / 
                            (_memory_pool.get_allocated_count() + _memory_pool.get_reused_count()) * 100;
         std::cout << "Memory reuse rate: " << reuse_rate << "%" << std::endl;
     }
+
+    // 每个线程弹匣的命中率：命中即分配时未访问共享空闲列表
+    std::vector<MagazineStats> magazines = _memory_pool.get_magazine_stats();
+    std::cout << "Thread magazines: " << magazines.size()
+              << " (size " << _memory_pool.get_magazine_size() << " per level)" << std::endl;
+    for (const MagazineStats& stats : magazines) {
+        uint64_t total = stats.hits + stats.misses;
+        std::cout << "  thread " << stats.owner << ": hits " << stats.hits << ", misses " << stats.misses;
+        if (total > 0) {
+            std::cout << ", hit rate " << (double)stats.hits / total * 100 << "%";
+        }
+        std::cout << ", cached " << stats.cached << std::endl;
+    }
     std::cout << "==================================\n" << std::endl;
 }
 
@@ -0,0 +1,265 @@
+/* ************************************************************************
+> File Name:     skiplist_sharded.h
+> Description:   按 key 范围分片的跳表
+>                1. 键空间按分割点切成 N 个有序区间，每个区间是一棵独立的优化版跳表
+>                2. 每个分片有自己的层级、层级锁、分段锁、内存池和纪元回收
+>                3. 不同分片上的写操作完全并行，范围查询按分片顺序拼接，结果仍然有序
+ ************************************************************************/
+
+#ifndef SKIPLIST_SHARDED_H
+#define SKIPLIST_SHARDED_H
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include "skiplist_optimized.h"
+
+/**
+ * @brief 范围分片跳表
+ *
+ * 单棵 SkipListOptimized 的所有写操作都要经过同一个层级锁，分段锁只能让读并行。
+ * 这里把键空间按 split_keys 切成 split_keys.size() + 1 个区间：
+ * 分片 i 存放 [split_keys[i-1], split_keys[i]) 内的 key（首尾分片向两端开放）。
+ * 落在不同分片的写操作不共享任何锁。
+ *
+ * 每个分片的内存池和纪元回收相互独立：一个分片上长时间存活的游标只推迟该分片的回收，
+ * 弹匣补充和溢出也不在分片之间争用同一把锁。两者的线程本地查找缓存按编号直接映射，
+ * 分片不超过 64 个时轮流访问各分片的线程不会挤掉自己的缓存项。
+ *
+ * 分割点应贴合实际 key 分布，否则热点区间仍会集中在同一个分片上。
+ *
+ * @tparam K 键的类型，需支持 operator<
+ * @tparam V 值的类型
+ * @tparam LogPolicy 各分片使用的日志策略，见 log_policy.h
+ */
+template<typename K, typename V, typename LogPolicy = StdoutLogger>
+class ShardedSkipList {
+public:
+    typedef SkipListOptimized<K, V, LogPolicy> Shard;
+
+    /**
+     * @brief 构造函数
+     * @param split_keys 分割点（内部排序去重），n 个分割点产生 n + 1 个分片
+     * @param max_level 每个分片的最大层级
+     * @param segment_count 每个分片内的分段锁数量
+     */
+    ShardedSkipList(std::vector<K> split_keys, int max_level, int segment_count = 16)
+        : _split_keys(normalize(std::move(split_keys))) {
+        for (size_t i = 0; i <= _split_keys.size(); i++) {
+            _shards.emplace_back(new Shard(max_level, segment_count));
+        }
+    }
+
+    /**
+     * @brief 按预期元素总数构造
+     * @param expected_capacity 所有分片合计的预期元素个数，按分片数均分后由
+     *                          LevelGenerator::max_level_for 推导每个分片的 max_level
+     * @param probability 所有分片使用的分支因子
+     */
+    ShardedSkipList(std::vector<K> split_keys, size_t expected_capacity, LevelProbability probability,
+                    int segment_count = 16)
+        : _split_keys(normalize(std::move(split_keys))) {
+        size_t shards = _split_keys.size() + 1;
+        int max_level = LevelGenerator::max_level_for((expected_capacity + shards - 1) / shards, probability);
+        for (size_t i = 0; i < shards; i++) {
+            _shards.emplace_back(new Shard(max_level, segment_count));
+            _shards.back()->set_level_probability(probability);
+        }
+    }
+
+    // key 所属的分片编号
+    int shard_index(const K& key) const {
+        return std::upper_bound(_split_keys.begin(), _split_keys.end(), key) - _split_keys.begin();
+    }
+
+    int shard_count() const {
+        return (int)_shards.size();
+    }
+
+    Shard& shard(int index) {
+        return *_shards[index];
+    }
+
+    // 所有分片使用相同的分支因子
+    void set_level_probability(LevelProbability probability) {
+        for (auto& shard : _shards) {
+            shard->set_level_probability(probability);
+        }
+    }
+
+    // 单 key 操作直接转发给所属分片，语义与 SkipListOptimized 相同
+    int insert_element(const K& key, const V& value) {
+        return shard_for(key).insert_element(key, value);
+    }
+
+    int put(const K& key, const V& value) {
+        return shard_for(key).put(key, value);
+    }
+
+    int put(const K& key, V&& value) {
+        return shard_for(key).put(key, std::move(value));
+    }
+
+    template<typename... Args>
+    int emplace(const K& key, Args&&... args) {
+        return shard_for(key).emplace(key, std::forward<Args>(args)...);
+    }
+
+    int put_if_absent(const K& key, const V& value) {
+        return shard_for(key).put_if_absent(key, value);
+    }
+
+    bool compare_and_swap(const K& key, const V& expected, const V& desired) {
+        return shard_for(key).compare_and_swap(key, expected, desired);
+    }
+
+    template<typename MergeOp>
+    int merge(const K& key, const V& operand, MergeOp op) {
+        return shard_for(key).merge(key, operand, op);
+    }
+
+    bool search_element(const K& key) {
+        return shard_for(key).search_element(key);
+    }
+
+    bool search_element_silent(const K& key) {
+        return shard_for(key).search_element_silent(key);
+    }
+
+    template<typename Visitor>
+    bool get(const K& key, Visitor visitor) {
+        return shard_for(key).get(key, visitor);
+    }
+
+    void delete_element(const K& key) {
+        shard_for(key).delete_element(key);
+    }
+
+    // 范围删除：依次在区间覆盖的分片上执行，返回删除个数
+    int delete_range(const K& lo, const K& hi) {
+        if (hi < lo) {
+            return 0;
+        }
+        int removed = 0;
+        int last = shard_index(hi);
+        for (int i = shard_index(lo); i <= last; i++) {
+            removed += _shards[i]->delete_range(lo, hi);
+        }
+        return removed;
+    }
+
+    // 有序批量导入：按分割点把输入切成连续的段，各段交给所属分片的 bulk_load
+    // 需要前向迭代器；返回插入的元素个数
+    template<typename ForwardIt>
+    int bulk_load(ForwardIt first, ForwardIt last, bool balanced = false) {
+        int loaded = 0;
+        while (first != last) {
+            int index = shard_index((*first).first);
+            ForwardIt run_end = first;
+            while (run_end != last && shard_index((*run_end).first) == index) {
+                ++run_end;
+            }
+            loaded += _shards[index]->bulk_load(first, run_end, balanced);
+            first = run_end;
+        }
+        return loaded;
+    }
+
+    /**
+     * @brief 范围查询：[start_key, end_key] 内的键值对，按 key 升序
+     *
+     * 只访问区间覆盖的分片。分片之间本身有序，依次拼接各分片的结果即为全局有序结果。
+     * 各分片按块复制（见 SkipListOptimized::range_query），整体不是同一时刻的快照。
+     */
+    std::vector<std::pair<K, V>> range_query(const K& start_key, const K& end_key) {
+        std::vector<std::pair<K, V>> result;
+        if (end_key < start_key) {
+            return result;
+        }
+        int first = shard_index(start_key);
+        int last = shard_index(end_key);
+        for (int i = first; i <= last; i++) {
+            std::vector<std::pair<K, V>> part = _shards[i]->range_query(start_key, end_key);
+            result.insert(result.end(), std::make_move_iterator(part.begin()), std::make_move_iterator(part.end()));
+        }
+        return result;
+    }
+
+    /**
+     * @brief 降序范围查询：[lo, hi] 内最大的至多 limit 个元素，按 key 降序
+     *
+     * 从 hi 所在分片向前依次查询，取满 limit 个即停止，只访问需要的分片。
+     */
+    std::vector<std::pair<K, V>> range_query_desc(const K& hi, const K& lo,
+                                                  int limit = std::numeric_limits<int>::max()) {
+        std::vector<std::pair<K, V>> result;
+        if (hi < lo) {
+            return result;
+        }
+        int first = shard_index(lo);
+        for (int i = shard_index(hi); i >= first && (int)result.size() < limit; i--) {
+            std::vector<std::pair<K, V>> part = _shards[i]->range_query_desc(hi, lo, limit - (int)result.size());
+            result.insert(result.end(), std::make_move_iterator(part.begin()), std::make_move_iterator(part.end()));
+        }
+        return result;
+    }
+
+    // [start_key, end_key] 内的元素个数，每个分片 O(log n)
+    int count_range(const K& start_key, const K& end_key) {
+        if (end_key < start_key) {
+            return 0;
+        }
+        int total = 0;
+        int last = shard_index(end_key);
+        for (int i = shard_index(start_key); i <= last; i++) {
+            total += _shards[i]->count_range(start_key, end_key);
+        }
+        return total;
+    }
+
+    int size() {
+        int total = 0;
+        for (auto& shard : _shards) {
+            total += shard->size();
+        }
+        return total;
+    }
+
+    // 保留内存预算与收缩转发给每个分片的内存池，预算按分片分别计算
+    void set_memory_budget(size_t bytes_per_shard) {
+        for (auto& shard : _shards) {
+            shard->set_memory_budget(bytes_per_shard);
+        }
+    }
+
+    size_t trim_memory() {
+        size_t released = 0;
+        for (auto& shard : _shards) {
+            released += shard->trim_memory();
+        }
+        return released;
+    }
+
+private:
+    // 分割点排序去重
+    static std::vector<K> normalize(std::vector<K> split_keys) {
+        std::sort(split_keys.begin(), split_keys.end());
+        split_keys.erase(std::unique(split_keys.begin(), split_keys.end()), split_keys.end());
+        return split_keys;
+    }
+
+    Shard& shard_for(const K& key) {
+        return *_shards[shard_index(key)];
+    }
+
+    std::vector<K> _split_keys;                     // 升序分割点
+    std::vector<std::unique_ptr<Shard>> _shards;    // 按 key 区间排列的分片
+
+    // 禁止拷贝和赋值
+    ShardedSkipList(const ShardedSkipList&) = delete;
+    ShardedSkipList& operator=(const ShardedSkipList&) = delete;
+};
+
+#endif // SKIPLIST_SHARDED_H
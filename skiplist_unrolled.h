@@ -0,0 +1,493 @@
+/* ************************************************************************
+> File Name:     skiplist_unrolled.h
+> Description:   展开跳表（Unrolled / Fat-Node Skip List）实现
+>                1. 每个节点保存一小段有序 key 数组，按 cache line 对齐
+>                2. 高层按节点最小 key 跳跃，节点内整块比较（见 simd_search.h）
+>                3. 节点写满时对半分裂，删除后过稀时与后继合并，变空时摘除
+ ************************************************************************/
+
+#ifndef SKIPLIST_UNROLLED_H
+#define SKIPLIST_UNROLLED_H
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <vector>
+#include <new>
+#include "simd_search.h"
+#include "random_level.h"
+
+// 展开跳表节点
+// 布局：[keys[0..NodeCapacity) | count | node_level | forward[0..level] | values[0..NodeCapacity)]
+// 节点按 cache line 对齐，int 键时整个 key 数组恰好占满首个 cache line
+template<typename K, typename V, int NodeCapacity>
+class alignas(64) NodeUnrolled {
+public:
+    static const size_t ALIGNMENT = 64;
+
+    // 单次分配创建节点，values 默认构造
+    static NodeUnrolled<K, V, NodeCapacity>* create(int level);
+
+    // 析构 keys/values 并释放整块内存
+    static void destroy(NodeUnrolled<K, V, NodeCapacity>* node);
+
+    // 指定层级节点所需的字节数
+    static size_t allocation_size(int level);
+
+    // 节点内第一个 >= key 的位置，不存在时返回 count（整数键走 SIMD 内核）
+    int lower_bound(const K& key) const;
+
+    // 节点内最小 key（节点非空时有效）
+    const K& min_key() const;
+
+    V* values() const;
+
+    K keys[NodeCapacity];                                // 有序 key 数组
+
+    int count;                                           // 已使用的槽位数
+
+    int node_level;
+
+    // 内联的 forward 塔，实际长度为 node_level + 1，必须是最后一个数据成员
+    NodeUnrolled<K, V, NodeCapacity>* forward[1];
+
+private:
+    NodeUnrolled(int level);
+    ~NodeUnrolled() {}
+
+    // values 数组紧跟在 forward 塔之后
+    static size_t values_offset(int level);
+};
+
+template<typename K, typename V, int NodeCapacity>
+NodeUnrolled<K, V, NodeCapacity>::NodeUnrolled(int level) : count(0), node_level(level) {
+    memset(this->forward, 0, sizeof(NodeUnrolled<K, V, NodeCapacity>*) * (level + 1));
+}
+
+template<typename K, typename V, int NodeCapacity>
+size_t NodeUnrolled<K, V, NodeCapacity>::values_offset(int level) {
+    size_t offset = sizeof(NodeUnrolled<K, V, NodeCapacity>) + sizeof(NodeUnrolled<K, V, NodeCapacity>*) * level;
+    return (offset + alignof(V) - 1) / alignof(V) * alignof(V);
+}
+
+template<typename K, typename V, int NodeCapacity>
+size_t NodeUnrolled<K, V, NodeCapacity>::allocation_size(int level) {
+    return values_offset(level) + sizeof(V) * NodeCapacity;
+}
+
+template<typename K, typename V, int NodeCapacity>
+V* NodeUnrolled<K, V, NodeCapacity>::values() const {
+    return reinterpret_cast<V*>(const_cast<char*>(reinterpret_cast<const char*>(this)) + values_offset(node_level));
+}
+
+template<typename K, typename V, int NodeCapacity>
+NodeUnrolled<K, V, NodeCapacity>* NodeUnrolled<K, V, NodeCapacity>::create(int level) {
+    void* memory = ::operator new(allocation_size(level), std::align_val_t(ALIGNMENT));
+    NodeUnrolled<K, V, NodeCapacity>* node = new (memory) NodeUnrolled<K, V, NodeCapacity>(level);
+    V* values = node->values();
+    for (int i = 0; i < NodeCapacity; i++) {
+        new (&values[i]) V();
+    }
+    return node;
+}
+
+template<typename K, typename V, int NodeCapacity>
+void NodeUnrolled<K, V, NodeCapacity>::destroy(NodeUnrolled<K, V, NodeCapacity>* node) {
+    V* values = node->values();
+    for (int i = 0; i < NodeCapacity; i++) {
+        values[i].~V();
+    }
+    node->~NodeUnrolled<K, V, NodeCapacity>();
+    ::operator delete(static_cast<void*>(node), std::align_val_t(ALIGNMENT));
+}
+
+template<typename K, typename V, int NodeCapacity>
+int NodeUnrolled<K, V, NodeCapacity>::lower_bound(const K& key) const {
+    return key_lower_bound(keys, count, key);
+}
+
+template<typename K, typename V, int NodeCapacity>
+const K& NodeUnrolled<K, V, NodeCapacity>::min_key() const {
+    return keys[0];
+}
+
+// Class template for unrolled skip list
+template<typename K, typename V, int NodeCapacity = 16>
+class SkipListUnrolled {
+public:
+    SkipListUnrolled(int max_level);
+    ~SkipListUnrolled();
+
+    int get_random_level();                              // [0, max_level]，线程局部随机源
+    // 设置分支因子（默认 1/2），只影响之后新建的节点
+    void set_level_probability(LevelProbability probability);
+    LevelProbability get_level_probability() const;
+    int insert_element(const K&, const V&);
+    void display_list();
+    bool search_element(const K&);
+    bool search_element_silent(const K&);  // 静默查询，不输出信息
+    void delete_element(const K&);
+    int size();
+
+    // 范围查询：节点内连续读取，跨节点时才跳转指针
+    std::vector<std::pair<K, V>> range_query(const K& start_key, const K& end_key);
+
+    // 节点数量（用于观察平均填充率）
+    int node_count();
+
+private:
+    typedef NodeUnrolled<K, V, NodeCapacity> NodeType;
+
+    // 记录每层最后一个最小 key < key 的节点
+    void find_predecessors(const K& key, NodeType** update);
+
+    // 定位 key 所在节点及槽位，不存在时返回 nullptr
+    NodeType* locate(const K& key, int* pos);
+
+    NodeType* create_node(int level);
+
+private:
+    int _max_level;                                      // 跳表最大层级
+    LevelGenerator _level_generator;                     // 随机层级生成器（在 _mutex 下使用）
+    int _skip_list_level;                                // 当前跳表层级
+    NodeType* _header;                                   // 头节点指针（不保存 key）
+    int _element_count;                                  // 元素计数
+    int _node_count;                                     // 数据节点计数
+    std::mutex _mutex;                                   // 实例级互斥锁
+};
+
+template<typename K, typename V, int NodeCapacity>
+SkipListUnrolled<K, V, NodeCapacity>::SkipListUnrolled(int max_level)
+    : _max_level(max_level),
+      _level_generator(max_level),
+      _skip_list_level(0),
+      _element_count(0),
+      _node_count(0) {
+    this->_header = NodeType::create(_max_level);
+}
+
+template<typename K, typename V, int NodeCapacity>
+SkipListUnrolled<K, V, NodeCapacity>::~SkipListUnrolled() {
+    NodeType* current = _header->forward[0];
+    while (current != nullptr) {
+        NodeType* next = current->forward[0];
+        NodeType::destroy(current);
+        current = next;
+    }
+    NodeType::destroy(_header);
+}
+
+template<typename K, typename V, int NodeCapacity>
+NodeUnrolled<K, V, NodeCapacity>* SkipListUnrolled<K, V, NodeCapacity>::create_node(int level) {
+    _node_count++;
+    return NodeType::create(level);
+}
+
+template<typename K, typename V, int NodeCapacity>
+int SkipListUnrolled<K, V, NodeCapacity>::get_random_level() {
+    return _level_generator.next();
+}
+
+template<typename K, typename V, int NodeCapacity>
+void SkipListUnrolled<K, V, NodeCapacity>::set_level_probability(LevelProbability probability) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _level_generator = LevelGenerator(_max_level, probability);
+}
+
+template<typename K, typename V, int NodeCapacity>
+LevelProbability SkipListUnrolled<K, V, NodeCapacity>::get_level_probability() const {
+    return _level_generator.probability();
+}
+
+template<typename K, typename V, int NodeCapacity>
+void SkipListUnrolled<K, V, NodeCapacity>::find_predecessors(const K& key, NodeType** update) {
+    NodeType* current = _header;
+    for (int i = _skip_list_level; i >= 0; i--) {
+        while (current->forward[i] != nullptr && current->forward[i]->min_key() < key) {
+            current = current->forward[i];
+        }
+        update[i] = current;
+    }
+}
+
+template<typename K, typename V, int NodeCapacity>
+NodeUnrolled<K, V, NodeCapacity>* SkipListUnrolled<K, V, NodeCapacity>::locate(const K& key, int* pos) {
+    NodeType* current = _header;
+    for (int i = _skip_list_level; i >= 0; i--) {
+        while (current->forward[i] != nullptr && current->forward[i]->min_key() < key) {
+            current = current->forward[i];
+        }
+    }
+
+    // key 恰好是后继节点的最小 key
+    NodeType* next = current->forward[0];
+    if (next != nullptr && next->min_key() == key) {
+        *pos = 0;
+        return next;
+    }
+    if (current == _header) {
+        return nullptr;
+    }
+
+    int i = current->lower_bound(key);
+    if (i < current->count && current->keys[i] == key) {
+        *pos = i;
+        return current;
+    }
+    return nullptr;
+}
+
+// 插入元素
+// return 1 means element exists
+// return 0 means insert successfully
+template<typename K, typename V, int NodeCapacity>
+int SkipListUnrolled<K, V, NodeCapacity>::insert_element(const K& key, const V& value) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    std::vector<NodeType*> update(_max_level + 1, nullptr);
+    find_predecessors(key, update.data());
+
+    NodeType* next = update[0]->forward[0];
+    if (next != nullptr && next->min_key() == key) {
+        return 1;
+    }
+
+    // 目标节点：最小 key < key 的最后一个节点；key 小于所有节点时放入第一个节点
+    NodeType* target = (update[0] != _header) ? update[0] : next;
+
+    if (target == nullptr) {
+        // 空表：新建节点
+        int random_level = get_random_level();
+        if (random_level > _skip_list_level) {
+            for (int i = _skip_list_level + 1; i <= random_level; i++) {
+                update[i] = _header;
+            }
+            _skip_list_level = random_level;
+        }
+        NodeType* inserted_node = create_node(random_level);
+        inserted_node->keys[0] = key;
+        inserted_node->values()[0] = value;
+        inserted_node->count = 1;
+        for (int i = 0; i <= random_level; i++) {
+            inserted_node->forward[i] = update[i]->forward[i];
+            update[i]->forward[i] = inserted_node;
+        }
+        _element_count++;
+        return 0;
+    }
+
+    int pos = target->lower_bound(key);
+    if (pos < target->count && target->keys[pos] == key) {
+        return 1;
+    }
+
+    if (target->count == NodeCapacity) {
+        // 节点已满：后一半移入新节点，新节点紧跟在目标节点之后
+        int random_level = get_random_level();
+        if (random_level > _skip_list_level) {
+            for (int i = _skip_list_level + 1; i <= random_level; i++) {
+                update[i] = _header;
+            }
+            _skip_list_level = random_level;
+        }
+
+        NodeType* split_node = create_node(random_level);
+        int mid = NodeCapacity / 2;
+        V* target_values = target->values();
+        V* split_values = split_node->values();
+        for (int i = mid; i < NodeCapacity; i++) {
+            split_node->keys[i - mid] = target->keys[i];
+            split_values[i - mid] = std::move(target_values[i]);
+        }
+        split_node->count = NodeCapacity - mid;
+        target->count = mid;
+
+        // 目标节点所在的层由目标节点直接指向新节点，其余层沿用查找路径上的前驱
+        for (int i = 0; i <= random_level; i++) {
+            NodeType* pred = (i <= target->node_level) ? target : update[i];
+            split_node->forward[i] = pred->forward[i];
+            pred->forward[i] = split_node;
+        }
+
+        if (pos >= mid) {
+            target = split_node;
+            pos -= mid;
+        }
+    }
+
+    // 槽位后移，插入新 key
+    V* values = target->values();
+    for (int i = target->count; i > pos; i--) {
+        target->keys[i] = target->keys[i - 1];
+        values[i] = std::move(values[i - 1]);
+    }
+    target->keys[pos] = key;
+    values[pos] = value;
+    target->count++;
+    _element_count++;
+    return 0;
+}
+
+// 删除元素：节点变空时从所有层摘除
+template<typename K, typename V, int NodeCapacity>
+void SkipListUnrolled<K, V, NodeCapacity>::delete_element(const K& key) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    std::vector<NodeType*> update(_max_level + 1, nullptr);
+    find_predecessors(key, update.data());
+
+    NodeType* target = nullptr;
+    int pos = 0;
+    NodeType* next = update[0]->forward[0];
+    if (next != nullptr && next->min_key() == key) {
+        target = next;
+    } else if (update[0] != _header) {
+        pos = update[0]->lower_bound(key);
+        if (pos < update[0]->count && update[0]->keys[pos] == key) {
+            target = update[0];
+        }
+    }
+    if (target == nullptr) {
+        return;
+    }
+
+    V* values = target->values();
+    for (int i = pos; i < target->count - 1; i++) {
+        target->keys[i] = target->keys[i + 1];
+        values[i] = std::move(values[i + 1]);
+    }
+    target->count--;
+    values[target->count] = V();
+    _element_count--;
+
+    if (target->count == 0) {
+        // 只有最小 key 等于被删 key 的节点才可能变空，此时 update[i] 均为其前驱
+        for (int i = 0; i <= target->node_level; i++) {
+            if (update[i]->forward[i] != target) {
+                break;
+            }
+            update[i]->forward[i] = target->forward[i];
+        }
+        while (_skip_list_level > 0 && _header->forward[_skip_list_level] == nullptr) {
+            _skip_list_level--;
+        }
+        NodeType::destroy(target);
+        _node_count--;
+        return;
+    }
+
+    // 填充率低于一半且能与后继合并时，把后继并入当前节点，避免删除后节点过稀
+    NodeType* successor = target->forward[0];
+    if (target->count < NodeCapacity / 2 && successor != nullptr &&
+        target->count + successor->count <= NodeCapacity) {
+        V* successor_values = successor->values();
+        for (int i = 0; i < successor->count; i++) {
+            target->keys[target->count + i] = successor->keys[i];
+            values[target->count + i] = std::move(successor_values[i]);
+        }
+        target->count += successor->count;
+
+        // 后继在目标节点所在层的前驱是目标节点，更高层的前驱沿用查找路径
+        for (int i = 0; i <= successor->node_level; i++) {
+            NodeType* pred = (i <= target->node_level) ? target : update[i];
+            pred->forward[i] = successor->forward[i];
+        }
+        while (_skip_list_level > 0 && _header->forward[_skip_list_level] == nullptr) {
+            _skip_list_level--;
+        }
+        NodeType::destroy(successor);
+        _node_count--;
+    }
+}
+
+template<typename K, typename V, int NodeCapacity>
+bool SkipListUnrolled<K, V, NodeCapacity>::search_element_silent(const K& key) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    int pos = 0;
+    return locate(key, &pos) != nullptr;
+}
+
+template<typename K, typename V, int NodeCapacity>
+bool SkipListUnrolled<K, V, NodeCapacity>::search_element(const K& key) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::cout << "search_element-----------------" << std::endl;
+    int pos = 0;
+    NodeType* node = locate(key, &pos);
+    if (node != nullptr) {
+        std::cout << "Found key: " << key << ", value: " << node->values()[pos] << std::endl;
+        return true;
+    }
+    std::cout << "Not Found Key:" << key << std::endl;
+    return false;
+}
+
+// 范围查询
+template<typename K, typename V, int NodeCapacity>
+std::vector<std::pair<K, V>> SkipListUnrolled<K, V, NodeCapacity>::range_query(const K& start_key, const K& end_key) {
+    std::vector<std::pair<K, V>> result;
+    if (start_key > end_key) {
+        return result;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    NodeType* current = _header;
+    for (int i = _skip_list_level; i >= 0; i--) {
+        while (current->forward[i] != nullptr && current->forward[i]->min_key() < start_key) {
+            current = current->forward[i];
+        }
+    }
+
+    int pos = 0;
+    if (current == _header) {
+        current = current->forward[0];
+    } else {
+        pos = current->lower_bound(start_key);
+    }
+
+    while (current != nullptr) {
+        V* values = current->values();
+        for (; pos < current->count; pos++) {
+            if (current->keys[pos] > end_key) {
+                return result;
+            }
+            result.push_back(std::make_pair(current->keys[pos], values[pos]));
+        }
+        current = current->forward[0];
+        pos = 0;
+    }
+    return result;
+}
+
+template<typename K, typename V, int NodeCapacity>
+void SkipListUnrolled<K, V, NodeCapacity>::display_list() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::cout << "\n*****Skip List (Unrolled)*****" << "\n";
+    for (int i = 0; i <= _skip_list_level; i++) {
+        NodeType* node = _header->forward[i];
+        std::cout << "Level " << i << ": ";
+        while (node != nullptr) {
+            std::cout << "[";
+            for (int j = 0; j < node->count; j++) {
+                std::cout << node->keys[j] << (j + 1 < node->count ? "," : "");
+            }
+            std::cout << "]";
+            node = node->forward[i];
+        }
+        std::cout << std::endl;
+    }
+}
+
+template<typename K, typename V, int NodeCapacity>
+int SkipListUnrolled<K, V, NodeCapacity>::size() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _element_count;
+}
+
+template<typename K, typename V, int NodeCapacity>
+int SkipListUnrolled<K, V, NodeCapacity>::node_count() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _node_count;
+}
+
+#endif // SKIPLIST_UNROLLED_H
@@ -0,0 +1,312 @@
+/* ************************************************************************
+> File Name:     slab_arena.h
+> Description:   节点内存的 slab 分配器
+>                1. 以大块连续内存（默认 2 MB）为单位向系统申请，块内按指针递增切分
+>                2. 可选用 mmap + MADV_HUGEPAGE 申请透明大页，减少 TLB 未命中
+>                3. 单个对象不单独释放（由内存池按层级复用），析构或收缩时整块归还
+>                4. 部分使用的 slab 中完全空闲的页面可单独交还系统（madvise）
+ ************************************************************************/
+
+#ifndef SLAB_ARENA_H
+#define SLAB_ARENA_H
+
+#include <mutex>
+#include <atomic>
+#include <new>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief slab 分配器
+ *
+ * 每个 slab 按 slab_size 对齐，起始处是 SlabHeader，之后的空间按 16 字节对齐依次切分。
+ * 不同大小的对象共用当前 slab，相邻分配的节点在内存中连续；
+ * 对象的复用由上层（NodeMemoryPool 按层级的空闲列表）负责，这里只管整块的申请与释放。
+ * 大于 slab 可用空间的对象单独占用一块 slab_size 整数倍的内存。
+ *
+ * 每个 slab 记录切分出的对象数，上层确认某个 slab 的对象全部空闲后可用 release_if 整块归还系统。
+ * slab 头部还为上层保留一份 FreeState（空闲对象数等），上层在自己的锁下维护，
+ * 与 object_count 比较即可 O(1) 判断 slab 是否全部空闲。
+ * 仍有对象在用的 slab 不能整块归还，release_pages 可把其中完全空闲的页面交还系统，
+ * 页面内容随之失效，上层需先析构覆盖这些页面的对象，复用前重新构造。
+ *
+ * huge_pages 为 true 时在 Linux 上用 mmap 申请对齐的匿名内存并 madvise(MADV_HUGEPAGE)，
+ * 其他平台或 mmap 失败时回退到对齐的 operator new。
+ */
+class SlabArena {
+public:
+    // 默认 slab 大小：x86-64 透明大页的大小
+    static const size_t DEFAULT_SLAB_SIZE = 2 * 1024 * 1024;
+
+    /**
+     * @brief 上层按 slab 维护的空闲状态，存放在 slab 头部，由上层自行同步
+     */
+    struct FreeState {
+        size_t free_objects;    // 已归还上层空闲列表的对象数
+        bool queued;            // 是否已登记为全部空闲的候选
+    };
+
+    /**
+     * @brief 构造函数
+     * @param slab_size 每个 slab 的字节数，须为 2 的幂且不小于 4 KB
+     * @param huge_pages 是否使用 mmap + MADV_HUGEPAGE 申请 slab
+     */
+    explicit SlabArena(size_t slab_size = DEFAULT_SLAB_SIZE, bool huge_pages = false)
+        : _slab_size(slab_size), _huge_pages(huge_pages), _slabs(nullptr), _current(nullptr),
+          _slab_count(0), _reserved_bytes(0), _used_bytes(0) {}
+
+    /**
+     * @brief 析构函数 - 整块释放所有 slab，不逐个释放对象
+     */
+    ~SlabArena() {
+        SlabHeader* slab = _slabs;
+        while (slab != nullptr) {
+            SlabHeader* next = slab->next;
+            release_slab(slab);
+            slab = next;
+        }
+    }
+
+    /**
+     * @brief 切分 size 字节的内存，16 字节对齐，线程安全
+     */
+    void* allocate(size_t size) {
+        size = align_up(size, ALIGNMENT);
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        if (size > _slab_size - header_size()) {
+            // 超大对象单独占用一块，不作为当前 slab 继续切分
+            SlabHeader* slab = acquire_slab(align_up(header_size() + size, _slab_size));
+            slab->used = header_size() + size;
+            slab->objects.store(1, std::memory_order_relaxed);
+            _used_bytes += size;
+            return reinterpret_cast<char*>(slab) + header_size();
+        }
+
+        if (_current == nullptr || _current->used + size > _current->size) {
+            _current = acquire_slab(_slab_size);
+        }
+        void* memory = reinterpret_cast<char*>(_current) + _current->used;
+        _current->used += size;
+        _current->objects.store(_current->objects.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        _used_bytes += size;
+        return memory;
+    }
+
+    /**
+     * @brief 对象所在 slab 的起始地址（slab 按 slab_size 对齐，超大对象也位于其 slab 的第一个 slab_size 内）
+     */
+    void* slab_of(const void* object) const {
+        return reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(object) & ~(uintptr_t)(_slab_size - 1));
+    }
+
+    /**
+     * @brief slab 已切分出的对象数，不加锁读取（只有当前 slab 会增长）
+     */
+    size_t object_count(const void* slab_address) const {
+        return static_cast<const SlabHeader*>(slab_address)->objects.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief slab 头部为上层保留的空闲状态
+     */
+    FreeState& free_state(void* slab_address) {
+        return static_cast<SlabHeader*>(slab_address)->free_state;
+    }
+
+    /**
+     * @brief allocate(size) 实际切分的字节数，相邻切分的对象首尾相接
+     */
+    static size_t carved_size(size_t size) {
+        return align_up(size, ALIGNMENT);
+    }
+
+    /**
+     * @brief 系统页大小，release_pages 的粒度
+     */
+    static size_t page_size() {
+#if defined(__linux__)
+        static const size_t size = (size_t)sysconf(_SC_PAGESIZE);
+        return size;
+#else
+        return 4096;
+#endif
+    }
+
+    /**
+     * @brief 把 [begin, begin + length) 内的页面交还系统，地址和长度须按页对齐
+     *
+     * Linux 上为 madvise(MADV_DONTNEED)：地址区间仍属于 slab，再次访问时得到清零的新页面。
+     * 调用方需保证区间内没有存活对象。
+     * @return 交还系统的字节数，不支持的平台为 0
+     */
+    size_t release_pages(void* begin, size_t length) {
+#if defined(__linux__) && defined(MADV_DONTNEED)
+        if (length > 0 && madvise(begin, length, MADV_DONTNEED) == 0) {
+            return length;
+        }
+#else
+        (void)begin;
+        (void)length;
+#endif
+        return 0;
+    }
+
+    /**
+     * @brief 若 slab 切分出的对象数仍为 objects，调用 before_release() 后整块归还系统
+     *
+     * 检查与释放在同一临界区内完成，期间不会有新对象从该 slab 切分出去。
+     * before_release 用于析构 slab 中的对象，在 slab 内存仍有效时调用。
+     * @return 归还系统的字节数，未释放时为 0
+     */
+    template<typename BeforeRelease>
+    size_t release_if(void* slab_address, size_t objects, BeforeRelease before_release) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        SlabHeader* slab = static_cast<SlabHeader*>(slab_address);
+        if (slab->objects.load(std::memory_order_relaxed) != objects) {
+            return 0;
+        }
+        SlabHeader** link = &_slabs;
+        while (*link != slab) {
+            link = &(*link)->next;
+        }
+        *link = slab->next;
+        if (_current == slab) {
+            _current = nullptr;
+        }
+        before_release();
+        size_t size = slab->size;
+        _slab_count--;
+        _reserved_bytes -= size;
+        _used_bytes -= slab->used - header_size();
+        release_slab(slab);
+        return size;
+    }
+
+    /**
+     * @brief 已申请的 slab 数量
+     */
+    size_t get_slab_count() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _slab_count;
+    }
+
+    /**
+     * @brief 向系统申请的总字节数
+     */
+    size_t get_reserved_bytes() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _reserved_bytes;
+    }
+
+    /**
+     * @brief 已切分给对象的字节数（含对齐填充）
+     */
+    size_t get_used_bytes() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _used_bytes;
+    }
+
+    size_t get_slab_size() const {
+        return _slab_size;
+    }
+
+private:
+    static const size_t ALIGNMENT = 16;
+
+    struct SlabHeader {
+        SlabHeader* next;
+        size_t size;        // slab 总字节数
+        size_t used;        // 已切分到的偏移（含头部）
+        std::atomic<size_t> objects;    // 切分出的对象数（在 _mutex 下修改）
+        FreeState free_state;           // 上层维护的空闲状态
+        bool mapped;        // 是否通过 mmap 申请
+    };
+
+    static size_t align_up(size_t value, size_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    static size_t header_size() {
+        return align_up(sizeof(SlabHeader), ALIGNMENT);
+    }
+
+    // 调用方需持有 _mutex
+    SlabHeader* acquire_slab(size_t size) {
+        bool mapped = false;
+        void* memory = _huge_pages ? map_aligned(size) : nullptr;
+        if (memory != nullptr) {
+            mapped = true;
+        } else {
+            memory = ::operator new(size, std::align_val_t(_slab_size));
+        }
+
+        SlabHeader* slab = new (memory) SlabHeader();
+        slab->next = _slabs;
+        slab->size = size;
+        slab->used = header_size();
+        slab->objects.store(0, std::memory_order_relaxed);
+        slab->free_state = FreeState{0, false};
+        slab->mapped = mapped;
+        _slabs = slab;
+        _slab_count++;
+        _reserved_bytes += size;
+        return slab;
+    }
+
+    void release_slab(SlabHeader* slab) {
+#if defined(__linux__)
+        if (slab->mapped) {
+            munmap(slab, slab->size);
+            return;
+        }
+#endif
+        ::operator delete(static_cast<void*>(slab), std::align_val_t(_slab_size));
+    }
+
+    // 多映射一个 slab_size 再裁掉首尾，得到按 slab_size 对齐的区域，透明大页要求 2 MB 对齐
+    void* map_aligned(size_t size) {
+#if defined(__linux__)
+        size_t length = size + _slab_size;
+        void* raw = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED) {
+            return nullptr;
+        }
+        uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+        uintptr_t aligned = align_up(start, _slab_size);
+        if (aligned > start) {
+            munmap(raw, aligned - start);
+        }
+        if (start + length > aligned + size) {
+            munmap(reinterpret_cast<void*>(aligned + size), start + length - (aligned + size));
+        }
+#ifdef MADV_HUGEPAGE
+        madvise(reinterpret_cast<void*>(aligned), size, MADV_HUGEPAGE);
+#endif
+        return reinterpret_cast<void*>(aligned);
+#else
+        (void)size;
+        return nullptr;
+#endif
+    }
+
+    size_t _slab_size;                  // slab 大小（也是对齐要求）
+    bool _huge_pages;                   // 是否申请透明大页
+    SlabHeader* _slabs;                 // 所有 slab 组成的链表
+    SlabHeader* _current;               // 当前切分中的 slab
+    size_t _slab_count;
+    size_t _reserved_bytes;
+    size_t _used_bytes;
+    mutable std::mutex _mutex;          // 保护切分和 slab 链表
+
+    // 禁止拷贝和赋值
+    SlabArena(const SlabArena&) = delete;
+    SlabArena& operator=(const SlabArena&) = delete;
+};
+
+#endif // SLAB_ARENA_H
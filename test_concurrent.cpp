@@ -0,0 +1,419 @@
+/* ************************************************************************
+> File Name:     test_concurrent.cpp
+> Description:   并发跳表引擎测试程序
+>                1. 无锁跳表功能与多线程正确性
+>                2. 惰性跳表功能与多线程正确性
+>                3. 纪元回收：读者持有期间不释放、高频增删下读者无 use-after-free
+>                4. 与分段锁优化版的多线程插入吞吐、读多写少吞吐对比
+ ************************************************************************/
+
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <sstream>
+#include <cassert>
+#include <atomic>
+#include "skiplist_optimized.h"
+#include "skiplist_lockfree.h"
+#include "skiplist_lazy.h"
+#include "epoch_reclaim.h"
+
+#define NUM_THREADS 8
+#define TEST_COUNT 100000
+
+// 用于临时禁用 cout 输出的工具类
+class CoutRedirect {
+private:
+    std::streambuf* old_buf;
+    std::ostringstream null_stream;
+public:
+    CoutRedirect() {
+        old_buf = std::cout.rdbuf();
+        std::cout.rdbuf(null_stream.rdbuf());
+    }
+    ~CoutRedirect() {
+        std::cout.rdbuf(old_buf);
+    }
+};
+
+// 并发引擎基本功能
+template<typename SkipListType>
+void test_engine_basic(const std::string& name) {
+    std::cout << "\n========== " << name << "基本功能 ==========" << std::endl;
+    SkipListType skipList(6);
+
+    assert(skipList.insert_element(1, "one") == 0);
+    assert(skipList.insert_element(3, "three") == 0);
+    assert(skipList.insert_element(7, "seven") == 0);
+    assert(skipList.insert_element(9, "nine") == 0);
+    assert(skipList.insert_element(7, "seven again") == 1);
+    assert(skipList.size() == 4);
+
+    assert(skipList.search_element(7));
+    assert(!skipList.search_element(8));
+
+    skipList.delete_element(3);
+    skipList.delete_element(4);
+    assert(skipList.size() == 3);
+    assert(!skipList.search_element_silent(3));
+
+    auto result = skipList.range_query(2, 9);
+    assert(result.size() == 2);
+    assert(result[0].first == 7 && result[1].first == 9);
+
+    auto cursor = skipList.cursor();
+    cursor.seek(2);
+    assert(cursor.valid() && cursor.key() == 7 && cursor.value() == "seven");
+    cursor.next();
+    assert(cursor.valid() && cursor.key() == 9);
+    cursor.next();
+    assert(!cursor.valid());
+    cursor.seek_to_first();
+    assert(cursor.valid() && cursor.key() == 1);
+
+    skipList.display_list();
+    std::cout << "✓ " << name << "基本功能测试通过" << std::endl;
+}
+
+// 多线程交错插入/删除后校验结果
+template<typename SkipListType>
+void test_engine_concurrent_correctness(const std::string& name) {
+    std::cout << "\n========== " << name << "并发正确性 ==========" << std::endl;
+    SkipListType skipList(18);
+
+    // 每个线程插入自己的 key，并删除其中的偶数 key；同时所有线程争抢插入公共 key
+    std::vector<std::thread> threads;
+    int count_per_thread = TEST_COUNT / NUM_THREADS;
+    for (int t = 0; t < NUM_THREADS; t++) {
+        threads.emplace_back([&skipList, t, count_per_thread]() {
+            int start = t * count_per_thread;
+            for (int i = 0; i < count_per_thread; i++) {
+                skipList.insert_element(start + i, "v");
+                skipList.insert_element(-1 - (i % 64), "shared");
+            }
+            for (int i = 0; i < count_per_thread; i += 2) {
+                skipList.delete_element(start + i);
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    int expected = NUM_THREADS * count_per_thread / 2 + 64;
+    std::cout << "实际元素数量: " << skipList.size() << ", 期望: " << expected << std::endl;
+    assert(skipList.size() == expected);
+
+    auto all = skipList.range_query(-64, TEST_COUNT);
+    assert((int)all.size() == expected);
+    for (size_t i = 1; i < all.size(); i++) {
+        assert(all[i - 1].first < all[i].first);
+    }
+    for (int i = 0; i < NUM_THREADS * count_per_thread; i++) {
+        assert(skipList.search_element_silent(i) == (i % 2 == 1));
+    }
+    std::cout << "✓ " << name << "并发正确性测试通过" << std::endl;
+}
+
+// 纪元回收：读者 pin 住期间退休的对象不会被释放
+static void count_reclaim(void* ctx, void*) {
+    static_cast<std::atomic<int>*>(ctx)->fetch_add(1);
+}
+
+void test_epoch_reclaim() {
+    std::cout << "\n========== 纪元回收 ==========" << std::endl;
+    std::atomic<int> reclaimed(0);
+    const int retire_count = EpochManager::RECLAIM_THRESHOLD * 8;
+    {
+        EpochManager manager;
+        std::atomic<bool> pinned(false);
+        std::atomic<bool> release(false);
+
+        std::thread reader([&manager, &pinned, &release]() {
+            auto guard = manager.pin();
+            pinned.store(true);
+            while (!release.load()) {
+                std::this_thread::yield();
+            }
+        });
+        while (!pinned.load()) {
+            std::this_thread::yield();
+        }
+
+        for (int i = 0; i < retire_count; i++) {
+            manager.retire(nullptr, &count_reclaim, &reclaimed);
+        }
+        std::cout << "读者持有期间已回收: " << reclaimed.load() << std::endl;
+        assert(reclaimed.load() == 0);
+
+        release.store(true);
+        reader.join();
+
+        for (int i = 0; i < retire_count; i++) {
+            manager.retire(nullptr, &count_reclaim, &reclaimed);
+        }
+        std::cout << "读者离开后已回收: " << reclaimed.load() << ", 待回收: " << manager.get_pending_count() << std::endl;
+        assert(reclaimed.load() > 0);
+    }
+    assert(reclaimed.load() == retire_count * 2);
+
+    // 退休不足 RECLAIM_THRESHOLD 个对象的线程：之后离开临界区时负责回收，不等到管理器析构
+    {
+        EpochManager manager;
+        std::atomic<int> few(0);
+        for (int i = 0; i < 10; i++) {
+            manager.retire(nullptr, &count_reclaim, &few);
+        }
+        assert(manager.get_pending_count() == 10);
+        for (int i = 0; i < EpochManager::EXIT_COLLECT_INTERVAL * 4 && manager.get_pending_count() > 0; i++) {
+            auto guard = manager.pin();
+        }
+        std::cout << "少量退休后经临界区出口回收: " << few.load() << ", 待回收: " << manager.get_pending_count() << std::endl;
+        assert(few.load() == 10 && manager.get_pending_count() == 0);
+    }
+
+    // 临界区内退休（如持有写锁时）不调用任何回收函数，回收推迟到最外层守卫离开时
+    {
+        EpochManager manager;
+        std::atomic<int> deferred(0);
+        for (int round = 0; round < 8; round++) {
+            auto guard = manager.pin();
+            int before = deferred.load();
+            for (int i = 0; i < EpochManager::RECLAIM_THRESHOLD * 4; i++) {
+                manager.retire(nullptr, &count_reclaim, &deferred);
+            }
+            assert(deferred.load() == before);
+        }
+        std::cout << "临界区内退休、出口回收: " << deferred.load() << ", 待回收: " << manager.get_pending_count() << std::endl;
+        assert(deferred.load() > 0);
+    }
+    std::cout << "✓ 纪元回收测试通过" << std::endl;
+}
+
+// 小范围 key 上高频增删，同时读者持续遍历，校验无崩溃且节点被及时回收
+template<typename SkipListType>
+void test_engine_churn(const std::string& name) {
+    std::cout << "\n========== " << name << "高频增删 ==========" << std::endl;
+    SkipListType skipList(12);
+    std::atomic<bool> stop(false);
+    std::atomic<int> hits(0);
+
+    {
+        CoutRedirect redirect;
+        std::vector<std::thread> readers;
+        for (int t = 0; t < 2; t++) {
+            readers.emplace_back([&skipList, &stop, &hits]() {
+                int local_hits = 0;
+                while (!stop.load()) {
+                    for (int key = 0; key < 256; key++) {
+                        local_hits += skipList.search_element_silent(key);
+                    }
+
+                    // 游标扫描期间节点被并发摘除，结果仍应严格递增
+                    auto cursor = skipList.cursor();
+                    int last = -1;
+                    for (cursor.seek_to_first(); cursor.valid(); cursor.next()) {
+                        assert(cursor.key() > last);
+                        last = cursor.key();
+                    }
+                }
+                hits.fetch_add(local_hits);
+            });
+        }
+
+        std::vector<std::thread> writers;
+        for (int t = 0; t < 4; t++) {
+            writers.emplace_back([&skipList, t]() {
+                for (int round = 0; round < 200; round++) {
+                    for (int key = t; key < 256; key += 4) {
+                        skipList.insert_element(key, "churn");
+                    }
+                    for (int key = t; key < 256; key += 4) {
+                        skipList.delete_element(key);
+                    }
+                }
+            });
+        }
+        for (auto& t : writers) {
+            t.join();
+        }
+        stop.store(true);
+        for (auto& t : readers) {
+            t.join();
+        }
+    }
+
+    std::cout << "剩余元素: " << skipList.size() << ", 读者命中: " << hits.load() << std::endl;
+    assert(skipList.size() == 0);
+    std::cout << "✓ " << name << "高频增删测试通过" << std::endl;
+}
+
+// 多线程插入吞吐对比
+template<typename SkipListType>
+double run_concurrent_insert(SkipListType* skipList) {
+    std::vector<std::thread> threads;
+    int count_per_thread = TEST_COUNT / NUM_THREADS;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    {
+        CoutRedirect redirect;
+        for (int t = 0; t < NUM_THREADS; t++) {
+            threads.emplace_back([skipList, t, count_per_thread]() {
+                // 交错分布 key，避免各线程只在各自区间尾部追加
+                for (int i = 0; i < count_per_thread; i++) {
+                    int key = i * NUM_THREADS + t;
+                    skipList->insert_element(key, "value_" + std::to_string(key));
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+void test_concurrent_insert_throughput() {
+    std::cout << "\n========== 多线程插入吞吐对比 ==========" << std::endl;
+
+    SkipListOptimized<int, std::string> optimized(18, 16);
+    double optimized_ms = run_concurrent_insert(&optimized);
+
+    SkipListLockFree<int, std::string> lockfree(18);
+    double lockfree_ms = run_concurrent_insert(&lockfree);
+
+    SkipListLazy<int, std::string> lazy(18);
+    double lazy_ms = run_concurrent_insert(&lazy);
+
+    assert(optimized.size() == lockfree.size());
+    assert(optimized.size() == lazy.size());
+
+    std::cout << "使用 " << NUM_THREADS << " 个线程插入 " << TEST_COUNT << " 个元素" << std::endl;
+    std::cout << "分段锁优化版: " << optimized_ms << " ms, QPS: " << (TEST_COUNT * 1000.0 / optimized_ms) << std::endl;
+    std::cout << "无锁版:       " << lockfree_ms << " ms, QPS: " << (TEST_COUNT * 1000.0 / lockfree_ms) << std::endl;
+    std::cout << "惰性版:       " << lazy_ms << " ms, QPS: " << (TEST_COUNT * 1000.0 / lazy_ms) << std::endl;
+}
+
+// 读多写少（95% 查询 / 5% 插入删除）混合负载
+template<typename SkipListType>
+double run_read_heavy(SkipListType* skipList) {
+    {
+        CoutRedirect redirect;
+        for (int i = 0; i < TEST_COUNT; i += 2) {
+            skipList->insert_element(i, "value_" + std::to_string(i));
+        }
+    }
+
+    std::vector<std::thread> threads;
+    int ops_per_thread = TEST_COUNT / NUM_THREADS * 4;
+    std::atomic<int> hits(0);  // 累计命中数，防止查询被编译器优化掉
+
+    auto start = std::chrono::high_resolution_clock::now();
+    {
+        CoutRedirect redirect;
+        for (int t = 0; t < NUM_THREADS; t++) {
+            threads.emplace_back([skipList, t, ops_per_thread, &hits]() {
+                uint32_t seed = 2654435761u * (t + 1);
+                int local_hits = 0;
+                for (int i = 0; i < ops_per_thread; i++) {
+                    seed = seed * 1664525u + 1013904223u;
+                    int key = (seed >> 8) % TEST_COUNT;
+                    int op = (seed >> 4) % 100;
+                    if (op < 95) {
+                        local_hits += skipList->search_element_silent(key);
+                    } else if (op < 98) {
+                        skipList->insert_element(key, "value");
+                    } else {
+                        skipList->delete_element(key);
+                    }
+                }
+                hits.fetch_add(local_hits);
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "命中次数: " << hits.load() << std::endl;
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+void test_read_heavy_throughput() {
+    std::cout << "\n========== 读多写少（95/5）吞吐对比 ==========" << std::endl;
+    int total_ops = TEST_COUNT / NUM_THREADS * 4 * NUM_THREADS;
+
+    SkipListOptimized<int, std::string> optimized(18, 16);
+    double optimized_ms = run_read_heavy(&optimized);
+
+    SkipListLazy<int, std::string> lazy(18);
+    double lazy_ms = run_read_heavy(&lazy);
+
+    std::cout << "使用 " << NUM_THREADS << " 个线程执行 " << total_ops << " 次操作" << std::endl;
+    std::cout << "分段锁优化版: " << optimized_ms << " ms, QPS: " << (total_ops * 1000.0 / optimized_ms) << std::endl;
+    std::cout << "惰性版:       " << lazy_ms << " ms, QPS: " << (total_ops * 1000.0 / lazy_ms) << std::endl;
+}
+
+// 游标扫描与同一批 key 上的 put 并发：value 在段读锁下读取，不会读到正在被覆盖的 std::string
+void test_cursor_value_with_put() {
+    std::cout << "\n========== 游标扫描与并发 put ==========" << std::endl;
+    SkipListOptimized<int, std::string, NullLogger> skipList(12, 16);
+    const int keys = 512;
+    for (int key = 0; key < keys; key++) {
+        skipList.put(key, std::string(64, 'a'));
+    }
+    std::atomic<bool> stop(false);
+    std::thread writer([&skipList, &stop]() {
+        for (int round = 0; !stop.load(); round++) {
+            // 长短交替，覆盖时会重新分配 string 的堆内存
+            std::string value(round % 2 ? 16 : 256, (char)('a' + round % 26));
+            for (int key = 0; key < keys; key++) {
+                skipList.put(key, value);
+            }
+        }
+    });
+
+    long long scanned = 0;
+    for (int pass = 0; pass < 50; pass++) {
+        auto cursor = skipList.cursor();
+        for (cursor.seek_to_first(); cursor.valid(); cursor.next()) {
+            std::string value = cursor.value();
+            assert(!value.empty() && value == std::string(value.size(), value[0]));
+            scanned++;
+        }
+        auto reverse = skipList.reverse_cursor();
+        for (reverse.seek_to_last(); reverse.valid(); reverse.next()) {
+            reverse.read_value([](const std::string& v) { assert(v == std::string(v.size(), v[0])); });
+            scanned++;
+        }
+    }
+    stop = true;
+    writer.join();
+    std::cout << "✓ 并发 put 期间扫描 " << scanned << " 个 value 均完整" << std::endl;
+}
+
+int main() {
+    std::cout << "======================================" << std::endl;
+    std::cout << "  并发跳表引擎测试程序" << std::endl;
+    std::cout << "======================================" << std::endl;
+
+    test_engine_basic<SkipListLockFree<int, std::string>>("无锁跳表");
+    test_engine_concurrent_correctness<SkipListLockFree<int, std::string>>("无锁跳表");
+    test_engine_basic<SkipListLazy<int, std::string>>("惰性跳表");
+    test_engine_concurrent_correctness<SkipListLazy<int, std::string>>("惰性跳表");
+    test_epoch_reclaim();
+    test_engine_churn<SkipListLockFree<int, std::string>>("无锁跳表");
+    test_engine_churn<SkipListLazy<int, std::string>>("惰性跳表");
+    test_engine_churn<SkipListOptimized<int, std::string>>("分段锁优化版");
+    test_cursor_value_with_put();
+    test_concurrent_insert_throughput();
+    test_read_heavy_throughput();
+
+    std::cout << "\n======================================" << std::endl;
+    std::cout << "  测试完成！" << std::endl;
+    std::cout << "======================================" << std::endl;
+
+    return 0;
+}
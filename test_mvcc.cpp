@@ -9,6 +9,7 @@
 #include <vector>
 #include <chrono>
 #include <cassert>
+#include <pthread.h>
 #include "skiplist_mvcc.h"
 
 using namespace std;
@@ -19,7 +20,7 @@ void test_basic_transaction() {
     cout << "\n========== Test 1: Basic Transaction ==========" << endl;
     auto start = high_resolution_clock::now();
     
-    SkipListMVCC<int, string> skiplist(6, true);  // 静默模式
+    SkipListMVCC<int, string, NullLogger> skiplist(6);  // 静默模式
     
     auto txn1 = skiplist.begin_transaction();
     skiplist.insert_element(txn1, 1, "value1");
@@ -47,7 +48,7 @@ void test_read_committed() {
     cout << "\n========== Test 2: Read Committed Isolation ==========" << endl;
     auto start = high_resolution_clock::now();
     
-    SkipListMVCC<int, string> skiplist(6, true);
+    SkipListMVCC<int, string, NullLogger> skiplist(6);
     
     auto txn1 = skiplist.begin_transaction();
     skiplist.insert_element(txn1, 10, "initial");
@@ -81,7 +82,7 @@ void test_multi_version() {
     cout << "\n========== Test 3: Multi-Version Management ==========" << endl;
     auto start = high_resolution_clock::now();
     
-    SkipListMVCC<int, string> skiplist(6, true);
+    SkipListMVCC<int, string, NullLogger> skiplist(6);
     
     for (int i = 1; i <= 3; i++) {
         auto txn = skiplist.begin_transaction();
@@ -107,7 +108,7 @@ void test_transaction_abort() {
     cout << "\n========== Test 4: Transaction Abort ==========" << endl;
     auto start = high_resolution_clock::now();
     
-    SkipListMVCC<int, string> skiplist(6, true);
+    SkipListMVCC<int, string, NullLogger> skiplist(6);
     
     auto txn1 = skiplist.begin_transaction();
     skiplist.insert_element(txn1, 50, "committed_value");
@@ -135,7 +136,7 @@ void test_concurrent_transactions() {
     cout << "\n========== Test 5: Concurrent Transactions ==========" << endl;
     auto start = high_resolution_clock::now();
     
-    SkipListMVCC<int, string> skiplist(6, true);
+    SkipListMVCC<int, string, NullLogger> skiplist(6);
     
     auto init_txn = skiplist.begin_transaction();
     for (int i = 0; i < 10; i++) {
@@ -189,7 +190,7 @@ void test_range_query() {
     cout << "\n========== Test 6: Range Query ==========" << endl;
     auto start = high_resolution_clock::now();
     
-    SkipListMVCC<int, string> skiplist(6, true);
+    SkipListMVCC<int, string, NullLogger> skiplist(6);
     
     auto txn1 = skiplist.begin_transaction();
     for (int i = 0; i < 20; i += 2) {
@@ -215,7 +216,7 @@ void test_delete_operation() {
     cout << "\n========== Test 7: Delete Operation ==========" << endl;
     auto start = high_resolution_clock::now();
     
-    SkipListMVCC<int, string> skiplist(6, true);
+    SkipListMVCC<int, string, NullLogger> skiplist(6);
     
     auto txn1 = skiplist.begin_transaction();
     skiplist.insert_element(txn1, 30, "to_be_deleted");
@@ -242,7 +243,7 @@ void test_garbage_collection() {
     cout << "\n========== Test 8: Garbage Collection ==========" << endl;
     auto start = high_resolution_clock::now();
     
-    SkipListMVCC<int, string> skiplist(6, true);
+    SkipListMVCC<int, string, NullLogger> skiplist(6);
     
     for (int i = 0; i < 10; i++) {
         auto txn = skiplist.begin_transaction();
@@ -276,7 +277,7 @@ void test_persistence() {
     auto start = high_resolution_clock::now();
     
     {
-        SkipListMVCC<int, string> skiplist(6, true);
+        SkipListMVCC<int, string, NullLogger> skiplist(6);
         
         auto txn = skiplist.begin_transaction();
         for (int i = 0; i < 10; i++) {
@@ -288,7 +289,7 @@ void test_persistence() {
     }
     
     {
-        SkipListMVCC<int, string> skiplist(6, true);
+        SkipListMVCC<int, string, NullLogger> skiplist(6);
         skiplist.load_file();
         
         auto txn = skiplist.begin_transaction();
@@ -311,7 +312,7 @@ void test_stress() {
     cout << "\n========== Test 10: Stress Test ==========" << endl;
     auto start_time = high_resolution_clock::now();
     
-    SkipListMVCC<int, string> skiplist(18, true);
+    SkipListMVCC<int, string, NullLogger> skiplist(18);
     
     vector<thread> threads;
     const int num_threads = 4;
@@ -350,7 +351,165 @@ void test_stress() {
     cout << "✓ Stress test passed! (耗时: " << duration.count() << "ms)" << endl;
 }
 
+// 测试11：批量快照读
+void test_multi_get() {
+    cout << "\n========== Test 11: Multi Get ==========" << endl;
+    auto start = high_resolution_clock::now();
+    
+    SkipListMVCC<int, string, NullLogger> skiplist(10);
+    
+    auto txn1 = skiplist.begin_transaction();
+    for (int i = 0; i < 100; i++) {
+        skiplist.insert_element(txn1, i * 2, "value_" + to_string(i * 2));
+    }
+    skiplist.commit_transaction(txn1);
+    
+    // 已提交删除 key=10，未提交写入 key=11
+    auto txn2 = skiplist.begin_transaction();
+    skiplist.delete_element(txn2, 10);
+    skiplist.commit_transaction(txn2);
+    auto writer = skiplist.begin_transaction();
+    skiplist.insert_element(writer, 11, "uncommitted");
+    
+    auto reader = skiplist.begin_transaction();
+    vector<int> keys;
+    for (int i = 0; i < 60; i++) {
+        keys.push_back(i);
+    }
+    vector<string> values(keys.size());
+    bool found[60];
+    int hits = skiplist.multi_get(reader, keys.data(), keys.size(), values.data(), found);
+    
+    for (size_t i = 0; i < keys.size(); i++) {
+        string value;
+        assert(found[i] == skiplist.search_element(reader, keys[i], &value));
+        if (found[i]) {
+            assert(values[i] == value);
+        }
+    }
+    assert(!found[10] && !found[11] && found[12]);
+    assert(hits == 29);
+    
+    skiplist.commit_transaction(reader);
+    skiplist.abort_transaction(writer);
+    
+    auto end = high_resolution_clock::now();
+    auto duration = duration_cast<milliseconds>(end - start);
+    
+    cout << "✓ Multi get test passed! (耗时: " << duration.count() << "ms)" << endl;
+}
+
+// 测试12：快照游标
+void test_cursor() {
+    cout << "\n========== Test 12: Cursor ==========" << endl;
+    auto start = high_resolution_clock::now();
+    
+    SkipListMVCC<int, string, NullLogger> skiplist(8);
+    
+    auto txn1 = skiplist.begin_transaction();
+    for (int i = 0; i < 20; i++) {
+        skiplist.insert_element(txn1, i, "value_" + to_string(i));
+    }
+    skiplist.commit_transaction(txn1);
+    
+    // 已提交删除偶数 key；未提交写入 key=100
+    auto txn2 = skiplist.begin_transaction();
+    for (int i = 0; i < 20; i += 2) {
+        skiplist.delete_element(txn2, i);
+    }
+    skiplist.commit_transaction(txn2);
+    auto writer = skiplist.begin_transaction();
+    skiplist.insert_element(writer, 100, "uncommitted");
+    
+    auto reader = skiplist.begin_transaction();
+    auto cursor = skiplist.cursor(reader);
+    int count = 0;
+    for (cursor.seek(5); cursor.valid(); cursor.next()) {
+        assert(cursor.key() % 2 == 1);
+        assert(cursor.value() == "value_" + to_string(cursor.key()));
+        count++;
+    }
+    assert(count == 8);   // 5, 7, ..., 19
+    
+    // 写事务自己能看到未提交的写入
+    auto own = skiplist.cursor(writer);
+    own.seek(100);
+    assert(own.valid() && own.value() == "uncommitted");
+
+    skiplist.commit_transaction(reader);
+    skiplist.abort_transaction(writer);
+
+    // 写事务并发插入新节点时扫描：已提交的奇数 key 一个不少，key 严格递增
+    thread inserter([&skiplist]() {
+        auto txn = skiplist.begin_transaction();
+        for (int i = 1000; i < 3000; i++) {
+            skiplist.insert_element(txn, i, "value_" + to_string(i));
+        }
+        skiplist.commit_transaction(txn);
+    });
+    for (int round = 0; round < 20; round++) {
+        auto scanner = skiplist.begin_transaction();
+        auto scan = skiplist.cursor(scanner);
+        int odd = 0, last = -1;
+        for (scan.seek_to_first(); scan.valid(); scan.next()) {
+            assert(scan.key() > last);
+            assert(scan.value() == "value_" + to_string(scan.key()));
+            last = scan.key();
+            odd += scan.key() < 20;
+        }
+        assert(odd == 10);
+        skiplist.commit_transaction(scanner);
+    }
+    inserter.join();
+
+    auto end = high_resolution_clock::now();
+    auto duration = duration_cast<milliseconds>(end - start);
+    
+    cout << "✓ Cursor test passed! (耗时: " << duration.count() << "ms)" << endl;
+}
+
 // 主函数
+// 在栈大小为 stack_bytes 的线程中运行 f，用于验证析构的栈深度与元素个数无关
+template<typename F>
+void run_with_stack(size_t stack_bytes, F f) {
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, stack_bytes);
+    pthread_t thread;
+    void* (*trampoline)(void*) = [](void* arg) -> void* {
+        (*static_cast<F*>(arg))();
+        return nullptr;
+    };
+    int rc = pthread_create(&thread, &attr, trampoline, &f);
+    assert(rc == 0);
+    pthread_join(thread, nullptr);
+    pthread_attr_destroy(&attr);
+}
+
+// 测试13：大跳表与长版本链的析构
+void test_teardown() {
+    cout << "\n========== Test 13: Teardown ==========" << endl;
+    auto start = high_resolution_clock::now();
+
+    // 10 万个 key，以及一个有 5 万个版本的 key，在 256 KB 栈上析构
+    auto* skiplist = new SkipListMVCC<int, string, NullLogger>(18);
+    auto txn = skiplist->begin_transaction();
+    for (int i = 0; i < 100000; i++) {
+        skiplist->insert_element(txn, i, "v");
+    }
+    skiplist->commit_transaction(txn);
+    auto writer = skiplist->begin_transaction();
+    for (int i = 0; i < 50000; i++) {
+        skiplist->insert_element(writer, -1, "version");
+    }
+    writer.reset();
+    run_with_stack(256 * 1024, [skiplist]() { delete skiplist; });
+
+    auto end = high_resolution_clock::now();
+    auto duration = duration_cast<milliseconds>(end - start);
+    cout << "✓ Teardown test passed! (耗时: " << duration.count() << "ms)" << endl;
+}
+
 int main() {
     cout << "\n";
     cout << "╔════════════════════════════════════════════════════════╗" << endl;
@@ -371,6 +530,9 @@ int main() {
         test_garbage_collection();
         test_persistence();
         test_stress();
+        test_multi_get();
+        test_cursor();
+        test_teardown();
         
         auto total_end = high_resolution_clock::now();
         auto total_duration = duration_cast<milliseconds>(total_end - total_start);
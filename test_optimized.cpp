@@ -6,11 +6,22 @@
 
 #include <iostream>
 #include <thread>
+#include <atomic>
 #include <vector>
 #include <chrono>
 #include <sstream>
+#include <cassert>
+#include <algorithm>
+#include <set>
+#include <map>
+#include <random>
+#include <limits>
+#include <pthread.h>
 #include "skiplist.h"
 #include "skiplist_optimized.h"
+#include "skiplist_sharded.h"
+#include "sharded_counter.h"
+#include "random_level.h"
 
 #define NUM_THREADS 8
 #define TEST_COUNT 10000
@@ -199,6 +210,1985 @@ void test_optimized_concurrent_search() {
     std::cout << "QPS: " << (TEST_COUNT * 1000.0 / duration.count()) << std::endl;
 }
 
+// 批量查找与逐个查找对比
+void test_multi_get_throughput() {
+    std::cout << "\n========== 批量查找 (multi_get) 吞吐对比 ==========" << std::endl;
+    const int element_count = 500000;
+    const int batch_size = 128;
+    const int batch_rounds = 8000;
+
+    SkipList<int, int> original(18);
+    SkipListOptimized<int, int> skipList(18, 16);
+    {
+        CoutRedirect redirect;
+        for (int i = 0; i < element_count; i++) {
+            original.insert_element(i * 2, i);
+            skipList.insert_element(i * 2, i);
+        }
+    }
+
+    // 随机 key，一半命中（偶数）一半不命中（奇数）
+    std::vector<int> keys(batch_size * batch_rounds);
+    srand(99);
+    for (size_t i = 0; i < keys.size(); i++) {
+        keys[i] = rand() % (element_count * 2);
+    }
+
+    // 正确性：批量结果与逐个查找一致
+    {
+        std::vector<int> values(batch_size);
+        bool found[batch_size];
+        int hits = skipList.multi_get(keys.data(), batch_size, values.data(), found);
+        int expected = 0;
+        for (int i = 0; i < batch_size; i++) {
+            assert(found[i] == skipList.search_element_silent(keys[i]));
+            if (found[i]) {
+                assert(values[i] == keys[i] / 2);
+                expected++;
+            }
+        }
+        assert(hits == expected);
+
+        std::fill(found, found + batch_size, false);
+        assert(original.multi_get(keys.data(), batch_size, values.data(), found) == expected);
+    }
+
+    long long single_hits = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < keys.size(); i++) {
+        single_hits += skipList.search_element_silent(keys[i]);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    auto single_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+
+    long long batch_hits = 0;
+    std::vector<int> values(batch_size);
+    bool found[batch_size];
+    start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < batch_rounds; r++) {
+        batch_hits += skipList.multi_get(keys.data() + r * batch_size, batch_size, values.data(), found);
+    }
+    end = std::chrono::high_resolution_clock::now();
+    auto batch_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    assert(batch_hits == single_hits);
+
+    std::cout << "元素数 " << element_count << ", 查询 " << keys.size() << " 次 (每批 " << batch_size << ")" << std::endl;
+    std::cout << "逐个 search_element_silent: " << single_ms << " ms" << std::endl;
+    std::cout << "批量 multi_get:            " << batch_ms << " ms" << std::endl;
+    if (batch_ms > 0) {
+        std::cout << "加速比: " << (double)single_ms / batch_ms << "x" << std::endl;
+    }
+}
+
+// 游标：与 range_query 结果一致，并发删除下仍能安全遍历
+void test_cursor() {
+    std::cout << "\n========== 游标 (Cursor) 测试 ==========" << std::endl;
+    SkipList<int, std::string> original(10);
+    SkipListOptimized<int, std::string> skipList(10, 16);
+    {
+        CoutRedirect redirect;
+        for (int i = 0; i < 1000; i += 3) {
+            original.insert_element(i, "value_" + std::to_string(i));
+            skipList.insert_element(i, "value_" + std::to_string(i));
+        }
+    }
+
+    std::vector<std::pair<int, std::string>> expected;
+    {
+        CoutRedirect redirect;
+        expected = original.range_query(100, 500);
+    }
+
+    auto check = [&expected](auto& cursor) {
+        size_t index = 0;
+        for (cursor.seek(100); cursor.valid() && cursor.key() <= 500; cursor.next()) {
+            assert(index < expected.size());
+            assert(cursor.key() == expected[index].first);
+            assert(cursor.value() == expected[index].second);
+            index++;
+        }
+        assert(index == expected.size());
+    };
+    auto original_cursor = original.cursor();
+    check(original_cursor);
+    auto optimized_cursor = skipList.cursor();
+    check(optimized_cursor);
+
+    optimized_cursor.seek(1000);
+    assert(!optimized_cursor.valid());
+    optimized_cursor.seek_to_first();
+    assert(optimized_cursor.valid() && optimized_cursor.key() == 0);
+
+    // range_query 按块复制：跨越块边界的区间与逐个读取一致；
+    // 并发插入奇数 key 时，偶数 key 一个不少且结果严格升序
+    {
+        SkipListOptimized<int, int> chunked(16, 16);
+        {
+            CoutRedirect redirect;
+            for (int i = 0; i < 8000; i += 2) {
+                chunked.insert_element(i, i);
+            }
+        }
+        int sizes[] = {0, 1, 255, 256, 257, 512, 513, 2000};
+        for (int count : sizes) {
+            std::vector<std::pair<int, int>> result = chunked.range_query(100, 100 + 2 * count - 1);
+            assert((int)result.size() == count);
+            for (int i = 0; i < count; i++) {
+                assert(result[i].first == 100 + 2 * i && result[i].second == 100 + 2 * i);
+            }
+        }
+
+        std::atomic<bool> stop{false};
+        std::thread writer([&chunked, &stop]() {
+            CoutRedirect redirect;
+            for (int i = 1; i < 8000 && !stop.load(); i += 2) {
+                chunked.put(i, i);
+            }
+        });
+        for (int round = 0; round < 20; round++) {
+            std::vector<std::pair<int, int>> result = chunked.range_query(0, 7999);
+            int evens = 0;
+            for (size_t i = 0; i < result.size(); i++) {
+                assert(i == 0 || result[i - 1].first < result[i].first);
+                assert(result[i].first == result[i].second);
+                evens += result[i].first % 2 == 0;
+            }
+            assert(evens == 4000);
+        }
+        stop = true;
+        writer.join();
+    }
+
+    // 扫描线程持有游标期间，另一线程删除全部元素：扫描结果应保持有序且不崩溃
+    {
+        CoutRedirect redirect;
+        std::thread deleter([&skipList]() {
+            for (int i = 0; i < 1000; i += 3) {
+                skipList.delete_element(i);
+            }
+        });
+        int scanned = 0;
+        for (int round = 0; round < 50; round++) {
+            auto cursor = skipList.cursor();
+            int last = -1;
+            for (cursor.seek_to_first(); cursor.valid(); cursor.next()) {
+                assert(cursor.key() > last);
+                last = cursor.key();
+                scanned++;
+            }
+        }
+        deleter.join();
+    }
+    assert(skipList.size() == 0);
+
+    std::cout << "✓ 游标测试通过" << std::endl;
+}
+
+// 排名查询：随机增删后与有序集合对照
+template<typename SkipListType>
+void check_rank_queries(SkipListType& skipList, const std::string& name) {
+    std::set<int> reference;
+    {
+        CoutRedirect redirect;
+        srand(31);
+        for (int i = 0; i < 20000; i++) {
+            int key = rand() % 5000;
+            if (rand() % 4 == 0) {
+                skipList.delete_element(key);
+                reference.erase(key);
+            } else {
+                skipList.insert_element(key, "value_" + std::to_string(key));
+                reference.insert(key);
+            }
+        }
+    }
+    std::vector<int> sorted(reference.begin(), reference.end());
+    assert(skipList.size() == (int)sorted.size());
+
+    for (int key = -1; key <= 5000; key += 7) {
+        int expected = std::lower_bound(sorted.begin(), sorted.end(), key) - sorted.begin();
+        assert(skipList.rank(key) == expected);
+    }
+    for (int k = 0; k < (int)sorted.size(); k += 13) {
+        int key;
+        std::string value;
+        assert(skipList.select(k, &key, &value));
+        assert(key == sorted[k] && value == "value_" + std::to_string(key));
+    }
+    int key;
+    std::string value;
+    assert(!skipList.select(sorted.size(), &key, &value));
+    assert(!skipList.select(-1, &key, &value));
+
+    for (int lo = 0; lo < 5000; lo += 499) {
+        int hi = lo + 1234;
+        int expected = std::upper_bound(sorted.begin(), sorted.end(), hi) -
+                       std::lower_bound(sorted.begin(), sorted.end(), lo);
+        assert(skipList.count_range(lo, hi) == expected);
+    }
+    assert(skipList.count_range(10, 5) == 0);
+
+    auto page = skipList.page(100, 20);
+    assert(page.size() == 20);
+    for (int i = 0; i < 20; i++) {
+        assert(page[i].first == sorted[100 + i]);
+    }
+    assert(skipList.page(sorted.size() - 5, 20).size() == 5);
+
+    auto cursor = skipList.cursor();
+    cursor.seek_to_rank(42);
+    assert(cursor.valid() && cursor.key() == sorted[42]);
+
+    std::cout << "✓ " << name << "排名查询测试通过 (元素数 " << sorted.size() << ")" << std::endl;
+}
+
+void test_rank_queries() {
+    std::cout << "\n========== 排名 / 区间计数 / 分页测试 ==========" << std::endl;
+    SkipList<int, std::string> original(12);
+    check_rank_queries(original, "原版跳表");
+    SkipListOptimized<int, std::string> optimized(12, 16);
+    check_rank_queries(optimized, "优化版跳表");
+
+    // 大区间计数：count_range 与 range_query().size() 对比
+    SkipListOptimized<int, int> skipList(18, 16);
+    {
+        CoutRedirect redirect;
+        for (int i = 0; i < 200000; i++) {
+            skipList.insert_element(i, i);
+        }
+    }
+    const int rounds = 20;
+    auto start = std::chrono::high_resolution_clock::now();
+    long long total = 0;
+    for (int r = 0; r < rounds; r++) {
+        total += skipList.count_range(r, 150000 + r);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    auto count_us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+    SkipList<int, int> original_large(18);
+    {
+        CoutRedirect redirect;
+        for (int i = 0; i < 200000; i++) {
+            original_large.insert_element(i, i);
+        }
+    }
+    start = std::chrono::high_resolution_clock::now();
+    long long scanned = 0;
+    {
+        CoutRedirect redirect;
+        for (int r = 0; r < rounds; r++) {
+            scanned += original_large.range_query(r, 150000 + r).size();
+        }
+    }
+    end = std::chrono::high_resolution_clock::now();
+    auto scan_us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    assert(total == scanned);
+
+    std::cout << rounds << " 次 15 万元素区间计数:" << std::endl;
+    std::cout << "  count_range:         " << count_us << " us" << std::endl;
+    std::cout << "  range_query().size(): " << scan_us << " us" << std::endl;
+}
+
+// 单次下降写接口
+template<typename SkipListType>
+void check_write_apis(SkipListType& skipList, const std::string& name) {
+    assert(skipList.put(1, "one") == 0);
+    assert(skipList.put(1, "uno") == 1);
+    assert(skipList.put_if_absent(1, "ein") == 1);
+    assert(skipList.put_if_absent(2, "two") == 0);
+    assert(skipList.size() == 2);
+
+    assert(!skipList.compare_and_swap(1, "one", "x"));
+    assert(skipList.compare_and_swap(1, "uno", "one"));
+    assert(!skipList.compare_and_swap(3, "", "three"));
+
+    auto concat = [](const std::string& a, const std::string& b) { return a + b; };
+    assert(skipList.merge(2, "+2", concat) == 1);
+    assert(skipList.merge(3, "three", concat) == 0);
+
+    auto rows = skipList.page(0, 10);
+    assert(rows.size() == 3);
+    assert(rows[0].second == "one" && rows[1].second == "two+2" && rows[2].second == "three");
+    assert(skipList.rank(3) == 2);
+    std::cout << "✓ " << name << "写接口测试通过" << std::endl;
+}
+
+void test_write_apis() {
+    std::cout << "\n========== put / put_if_absent / compare_and_swap / merge ==========" << std::endl;
+    SkipList<int, std::string> original(6);
+    check_write_apis(original, "原版跳表");
+    SkipListOptimized<int, std::string> optimized(6, 16);
+    check_write_apis(optimized, "优化版跳表");
+
+    // 多线程计数器：merge 的读-改-写在锁内完成，不丢更新
+    const int counter_keys = 64;
+    const int increments = 20000;
+    SkipListOptimized<int, long long> counters(10, 16);
+    auto plus = [](long long a, long long b) { return a + b; };
+    {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < NUM_THREADS; t++) {
+            threads.emplace_back([&counters, &plus, t, counter_keys, increments]() {
+                for (int i = 0; i < increments; i++) {
+                    counters.merge((i + t) % counter_keys, 1, plus);
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+    }
+    long long total = 0;
+    for (int k = 0; k < counter_keys; k++) {
+        long long value;
+        int key;
+        assert(counters.select(k, &key, &value));
+        total += value;
+    }
+    assert(total == (long long)NUM_THREADS * increments);
+
+    // 计数器吞吐：merge 一次下降 vs 删除后重新插入
+    const int rounds = 200000;
+    SkipListOptimized<int, long long> by_merge(12, 16);
+    SkipListOptimized<int, long long> by_reinsert(12, 16);
+    std::vector<long long> shadow(counter_keys, 0);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < rounds; i++) {
+        by_merge.merge(i % counter_keys, 1, plus);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    auto merge_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+
+    start = std::chrono::high_resolution_clock::now();
+    {
+        CoutRedirect redirect;
+        for (int i = 0; i < rounds; i++) {
+            int key = i % counter_keys;
+            shadow[key]++;
+            by_reinsert.delete_element(key);
+            by_reinsert.insert_element(key, shadow[key]);
+        }
+    }
+    end = std::chrono::high_resolution_clock::now();
+    auto reinsert_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+
+    std::cout << rounds << " 次计数器自增:" << std::endl;
+    std::cout << "  merge:                " << merge_ms << " ms" << std::endl;
+    std::cout << "  delete + insert:      " << reinsert_ms << " ms (含原接口日志输出)" << std::endl;
+}
+
+// 统计拷贝次数的 value 类型，用于验证写入/读取路径上没有多余的拷贝
+struct TrackedBlob {
+    static int copies;
+    std::string data;
+
+    TrackedBlob() {}
+    TrackedBlob(size_t size, char fill) : data(size, fill) {}
+    TrackedBlob(const TrackedBlob& other) : data(other.data) { copies++; }
+    TrackedBlob(TrackedBlob&& other) noexcept : data(std::move(other.data)) {}
+    TrackedBlob& operator=(const TrackedBlob& other) { data = other.data; copies++; return *this; }
+    TrackedBlob& operator=(TrackedBlob&& other) noexcept { data = std::move(other.data); return *this; }
+};
+int TrackedBlob::copies = 0;
+
+template<typename SkipListType>
+void check_move_aware(SkipListType& skipList, const std::string& name) {
+    TrackedBlob::copies = 0;
+    assert(skipList.emplace(1, 1024, 'a') == 0);          // 在节点内原地构造
+    assert(skipList.emplace(1, 1024, 'x') == 1);          // 已存在，不构造 value
+    TrackedBlob blob(2048, 'b');
+    assert(skipList.put(2, std::move(blob)) == 0);        // 移动进新节点
+    TrackedBlob update(4096, 'c');
+    assert(skipList.put(2, std::move(update)) == 1);      // 移动覆盖旧值
+    assert(TrackedBlob::copies == 0);
+
+    size_t seen = 0;
+    assert(skipList.get(1, [&seen](const TrackedBlob& v) { seen = v.data.size(); }));
+    assert(seen == 1024);
+    assert(skipList.get(2, [&seen](const TrackedBlob& v) { seen = v.data.size() + (v.data[0] == 'c'); }));
+    assert(seen == 4097);
+    assert(!skipList.get(3, [&seen](const TrackedBlob&) { seen = 0; }));
+    assert(TrackedBlob::copies == 0);
+
+    // 反复删除再写入，覆盖内存池复用节点的路径
+    for (int i = 0; i < 1000; i++) {
+        skipList.delete_element(10 + i % 4);
+        skipList.emplace(10 + i % 4, 64, 'e');
+    }
+    assert(TrackedBlob::copies == 0);
+
+    // 左值仍按值语义拷贝一次
+    TrackedBlob source(16, 'd');
+    assert(skipList.put(3, source) == 0);
+    assert(TrackedBlob::copies == 1);
+    std::cout << "✓ " << name << " 移动/原地读取测试通过" << std::endl;
+}
+
+void test_move_aware_values() {
+    std::cout << "\n========== 移动写入 / 原地读取 ==========" << std::endl;
+    {
+        CoutRedirect redirect;
+        SkipList<int, TrackedBlob> original(6);
+        check_move_aware(original, "原版跳表");
+
+        const TrackedBlob* found = original.find(1);
+        assert(found != nullptr && found->data.size() == 1024 && found->data[0] == 'a');
+        assert(original.find(9) == nullptr);
+        assert(TrackedBlob::copies == 1);
+
+        SkipListOptimized<int, TrackedBlob> optimized(6, 16);
+        check_move_aware(optimized, "优化版跳表");
+    }
+    std::cout << "✓ 原版跳表、优化版跳表移动/原地读取测试通过" << std::endl;
+
+    // 2 KB value：读取时拷贝出 value vs 在锁内原地访问
+    // 写入侧的收益是去掉一次 value 拷贝（见上面的拷贝计数），耗时主要在分配与缺页，这里不计时
+    const int count = 20000;
+    const size_t blob_size = 2048;
+    SkipListOptimized<int, std::string> skipList(16, 16);
+    for (int i = 0; i < count; i++) {
+        std::string value(blob_size, 'a' + i % 26);
+        skipList.put(i, std::move(value));
+    }
+
+    long long checksum = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < count; i++) {
+        std::string value;
+        bool found = false;
+        skipList.multi_get(&i, 1, &value, &found);
+        checksum += found ? value[i % blob_size] : 0;
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    auto copy_get_us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+    long long checksum_in_place = 0;
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < count; i++) {
+        skipList.get(i, [&checksum_in_place, i, blob_size](const std::string& value) {
+            checksum_in_place += value[i % blob_size];
+        });
+    }
+    end = std::chrono::high_resolution_clock::now();
+    auto visit_get_us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    assert(checksum == checksum_in_place);
+
+    std::cout << count << " 次读取 " << blob_size << " 字节 value:" << std::endl;
+    std::cout << "  读取并拷贝 value: " << copy_get_us << " us" << std::endl;
+    std::cout << "  get(visitor):    " << visit_get_us << " us" << std::endl;
+}
+
+// 日志策略：输出内容与插入吞吐对比
+template<typename SkipListType>
+long long time_logged_inserts(int count) {
+    SkipListType skipList(18, 16);
+    CoutRedirect redirect;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < count; i++) {
+        skipList.insert_element(i, "value");
+    }
+    for (int i = 0; i < count; i++) {
+        skipList.search_element(i);
+    }
+    skipList.logger().flush();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+}
+
+void test_log_policies() {
+    std::cout << "\n========== 日志策略 ==========" << std::endl;
+
+    std::ostringstream buffered_sink;
+    {
+        BufferedLogger logger(64, buffered_sink);
+        logger.log("key: ", 1, ", exists");
+        assert(buffered_sink.str().empty());            // 未满 64 字节，仍在缓冲区中
+        for (int i = 0; i < 10; i++) {
+            logger.log("Successfully inserted key:", i, ", value:", "v");
+        }
+        assert(!buffered_sink.str().empty());
+    }
+    assert(buffered_sink.str().find("key: 1, exists\n") == 0);
+    assert(buffered_sink.str().find("Successfully inserted key:9, value:v\n") != std::string::npos);
+
+    std::ostringstream async_sink;
+    {
+        AsyncLogger logger(1024, async_sink);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; t++) {
+            threads.emplace_back([&logger, t]() {
+                for (int i = 0; i < 100; i++) {
+                    logger.log("thread ", t, " line ", i);
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        logger.flush();
+        std::string output = async_sink.str();
+        size_t lines = std::count(output.begin(), output.end(), '\n');
+        assert(lines + logger.dropped() == 400);
+    }
+
+    // NullLogger 下跳表的接口行为不变
+    SkipListOptimized<int, std::string, NullLogger> quiet(6, 16);
+    assert(quiet.insert_element(1, "one") == 0);
+    assert(quiet.insert_element(1, "uno") == 1);
+    assert(quiet.search_element(1));
+    quiet.delete_element(1);
+    assert(!quiet.search_element(1));
+    std::cout << "✓ 日志策略测试通过" << std::endl;
+
+    const int count = 100000;
+    auto stdout_ms = time_logged_inserts<SkipListOptimized<int, std::string>>(count);
+    auto buffered_ms = time_logged_inserts<SkipListOptimized<int, std::string, BufferedLogger>>(count);
+    auto async_ms = time_logged_inserts<SkipListOptimized<int, std::string, AsyncLogger>>(count);
+    auto null_ms = time_logged_inserts<SkipListOptimized<int, std::string, NullLogger>>(count);
+
+    std::cout << count << " 次插入 + " << count << " 次查找:" << std::endl;
+    std::cout << "  StdoutLogger (重定向到内存): " << stdout_ms << " ms" << std::endl;
+    std::cout << "  BufferedLogger:             " << buffered_ms << " ms" << std::endl;
+    std::cout << "  AsyncLogger:                " << async_ms << " ms" << std::endl;
+    std::cout << "  NullLogger:                 " << null_ms << " ms" << std::endl;
+}
+
+// 锁策略：多线程读写正确性，以及单线程/多实例下的加锁开销
+template<typename LockPolicy>
+void check_lock_policy(const std::string& name) {
+    // 锁本身的互斥性：非原子计数器不丢更新
+    LockPolicy raw_lock;
+    long long counter = 0;
+    {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; t++) {
+            threads.emplace_back([&raw_lock, &counter]() {
+                for (int i = 0; i < 50000; i++) {
+                    std::lock_guard<LockPolicy> lock(raw_lock);
+                    counter++;
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+    }
+    assert(counter == 4 * 50000);
+
+    // 同一实例上并发写入不相交的 key，同时有读线程查询
+    const int per_thread = 5000;
+    SkipList<int, int, NullLogger, LockPolicy> skipList(16);
+    std::atomic<bool> done(false);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&skipList, t, per_thread]() {
+            for (int i = 0; i < per_thread; i++) {
+                skipList.put(t * per_thread + i, i);
+            }
+        });
+    }
+    threads.emplace_back([&skipList, &done]() {
+        while (!done.load()) {
+            int value = 0;
+            skipList.get(rand() % 20000, [&value](const int& v) { value = v; });
+            skipList.count_range(0, 10000);
+        }
+    });
+    for (int t = 0; t < 4; t++) {
+        threads[t].join();
+    }
+    done.store(true);
+    threads.back().join();
+
+    assert(skipList.size() == 4 * per_thread);
+    for (int k = 0; k < 4 * per_thread; k += 97) {
+        assert(skipList.rank(k) == k);
+    }
+    std::cout << "✓ " << name << " 测试通过" << std::endl;
+}
+
+template<typename LockPolicy>
+long long time_single_thread_puts(int count) {
+    SkipList<int, int, NullLogger, LockPolicy> skipList(18);
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < count; i++) {
+        skipList.put(i, i);
+    }
+    for (int i = 0; i < count; i++) {
+        skipList.get(i, [](const int&) {});
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+}
+
+// 读多写少：NUM_THREADS 个线程共享一个实例，每 100 次读一次写
+template<typename LockPolicy>
+long long time_shared_reads(int keys, int ops_per_thread) {
+    SkipList<int, int, NullLogger, LockPolicy> skipList(18);
+    for (int i = 0; i < keys; i++) {
+        skipList.put(i, i);
+    }
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < NUM_THREADS; t++) {
+        threads.emplace_back([&skipList, t, keys, ops_per_thread]() {
+            long long sum = 0;
+            for (int i = 0; i < ops_per_thread; i++) {
+                int key = (i * 7919 + t) % keys;
+                if (i % 100 == 0) {
+                    skipList.put(key, i);
+                } else {
+                    skipList.get(key, [&sum](const int& v) { sum += v; });
+                }
+            }
+            (void)sum;
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+}
+
+void test_lock_policies() {
+    std::cout << "\n========== 锁策略 ==========" << std::endl;
+    check_lock_policy<SpinLock>("SpinLock");
+    check_lock_policy<TicketLock>("TicketLock");
+    check_lock_policy<MutexLock>("MutexLock");
+    check_lock_policy<SharedMutexLock>("SharedMutexLock");
+
+    // 不同实例的锁互不影响：一个线程持有实例 a 的写锁时，实例 b 仍可写入
+    SkipList<int, int, NullLogger> a(6);
+    SkipList<int, int, NullLogger> b(6);
+    a.put(1, 1);
+    a.get(1, [&b](const int&) { assert(b.put(1, 1) == 0); });
+    std::cout << "✓ 实例级锁测试通过" << std::endl;
+
+    const int count = 200000;
+    std::cout << "单线程 " << count << " 次 put + " << count << " 次 get:" << std::endl;
+    std::cout << "  NullLock:        " << time_single_thread_puts<NullLock>(count) << " ms" << std::endl;
+    std::cout << "  SpinLock:        " << time_single_thread_puts<SpinLock>(count) << " ms" << std::endl;
+    std::cout << "  TicketLock:      " << time_single_thread_puts<TicketLock>(count) << " ms" << std::endl;
+    std::cout << "  MutexLock:       " << time_single_thread_puts<MutexLock>(count) << " ms" << std::endl;
+
+    const int ops = 200000;
+    std::cout << NUM_THREADS << " 线程共享实例，每线程 " << ops << " 次操作 (99% 读):" << std::endl;
+    std::cout << "  MutexLock:       " << time_shared_reads<MutexLock>(100000, ops) << " ms" << std::endl;
+    std::cout << "  SharedMutexLock: " << time_shared_reads<SharedMutexLock>(100000, ops) << " ms" << std::endl;
+}
+
+// 分段锁：读锁共享、cache line 对齐、加锁统计与读扩展性
+void test_segment_locks() {
+    std::cout << "\n========== 分段读写锁 ==========" << std::endl;
+    typedef SegmentLockManager<int>::Segment Segment;
+    assert(alignof(Segment) == 64 && sizeof(Segment) % 64 == 0);
+
+    SegmentLockManager<int> manager(4);
+    {
+        // 同段读锁可同时持有，写锁与读锁互斥
+        auto first = manager.get_read_lock(1);
+        auto second = manager.get_read_lock(1);
+        assert(first.owns_lock() && second.owns_lock());
+        std::unique_lock<Segment> writer(*first.mutex(), std::try_to_lock);
+        assert(!writer.owns_lock());
+    }
+    {
+        auto writer = manager.get_write_lock(2);
+        std::shared_lock<Segment> reader(*writer.mutex(), std::try_to_lock);
+        assert(!reader.owns_lock());
+    }
+
+    // 多个写线程递增非原子计数器、读线程检查两个计数器一致
+    long long a = 0, b = 0;
+    std::atomic<bool> stop(false);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&manager, &a, &b]() {
+            for (int i = 0; i < 20000; i++) {
+                auto lock = manager.get_write_lock(0);
+                a++;
+                b++;
+            }
+        });
+    }
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&manager, &a, &b, &stop]() {
+            while (!stop.load()) {
+                auto lock = manager.get_read_lock(0);
+                assert(a == b);
+            }
+        });
+    }
+    for (int t = 0; t < 4; t++) {
+        threads[t].join();
+    }
+    stop.store(true);
+    for (size_t t = 4; t < threads.size(); t++) {
+        threads[t].join();
+    }
+    assert(a == 4 * 20000 && b == 4 * 20000);
+
+    SegmentLockStats stats = manager.get_segment_stats(0);
+    assert(stats.write_acquisitions == 4 * 20000);
+    assert(stats.read_acquisitions > 0);
+    std::cout << "段 0: 读锁 " << stats.read_acquisitions << " 次, 写锁 " << stats.write_acquisitions
+              << " 次, 竞争 " << stats.contended << " 次" << std::endl;
+    manager.reset_stats();
+    assert(manager.get_total_stats().write_acquisitions == 0);
+    std::cout << "✓ 分段读写锁测试通过" << std::endl;
+
+    // 读扩展性：只读查询的总吞吐随线程数的变化
+    SkipListOptimized<int, int, NullLogger> skipList(18, 16);
+    const int keys = 200000;
+    for (int i = 0; i < keys; i++) {
+        skipList.put(i, i);
+    }
+    const int total_queries = 1600000;
+    std::cout << "只读查询 " << total_queries << " 次 (CPU 核数 " << std::thread::hardware_concurrency() << "):" << std::endl;
+    for (int thread_count = 1; thread_count <= NUM_THREADS; thread_count *= 2) {
+        auto start = std::chrono::high_resolution_clock::now();
+        std::vector<std::thread> readers;
+        for (int t = 0; t < thread_count; t++) {
+            readers.emplace_back([&skipList, t, thread_count, keys, total_queries]() {
+                int per_thread = total_queries / thread_count;
+                for (int i = 0; i < per_thread; i++) {
+                    skipList.search_element_silent((int)(((long long)i * 7919 + t) % keys));
+                }
+            });
+        }
+        for (auto& t : readers) {
+            t.join();
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+        std::cout << "  " << thread_count << " 线程: " << ms << " ms" << std::endl;
+    }
+}
+
+// 范围分片跳表测试
+void test_sharded_skiplist() {
+    std::cout << "\n========== 范围分片跳表 ==========" << std::endl;
+    const int keys_per_thread = 20000;
+    std::vector<int> splits;
+    for (int t = 1; t < NUM_THREADS; t++) {
+        splits.push_back(t * keys_per_thread);
+    }
+    ShardedSkipList<int, int, NullLogger> sharded(splits, 18, 16);
+    assert(sharded.shard_count() == NUM_THREADS);
+    assert(sharded.shard_index(-1) == 0 && sharded.shard_index(keys_per_thread - 1) == 0);
+    assert(sharded.shard_index(keys_per_thread) == 1);
+    assert(sharded.shard_index(NUM_THREADS * keys_per_thread) == NUM_THREADS - 1);
+
+    // 每个线程写自己的区间，再与 std::map 对照
+    std::vector<std::thread> threads;
+    for (int t = 0; t < NUM_THREADS; t++) {
+        threads.emplace_back([&sharded, t, keys_per_thread]() {
+            for (int i = 0; i < keys_per_thread; i++) {
+                int key = t * keys_per_thread + i;
+                sharded.put(key, key * 2);
+                if (i % 3 == 0) {
+                    sharded.delete_element(key);
+                }
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    std::map<int, int> expected;
+    for (int key = 0; key < NUM_THREADS * keys_per_thread; key++) {
+        if ((key % keys_per_thread) % 3 != 0) {
+            expected[key] = key * 2;
+        }
+    }
+    assert(sharded.size() == (int)expected.size());
+    for (int t = 0; t < sharded.shard_count(); t++) {
+        assert(sharded.shard(t).size() == (int)std::count_if(expected.begin(), expected.end(),
+            [&sharded, t](const std::pair<const int, int>& kv) { return sharded.shard_index(kv.first) == t; }));
+    }
+
+    // 跨分片范围查询：结果有序且与 std::map 一致
+    const int ranges[][2] = {{-100, 5}, {keys_per_thread - 10, keys_per_thread + 10},
+                             {1234, 5 * keys_per_thread + 77}, {0, NUM_THREADS * keys_per_thread + 100}, {50, 40}};
+    for (const auto& range : ranges) {
+        std::vector<std::pair<int, int>> result = sharded.range_query(range[0], range[1]);
+        std::vector<std::pair<int, int>> reference;
+        if (range[0] <= range[1]) {
+            for (auto it = expected.lower_bound(range[0]); it != expected.end() && it->first <= range[1]; ++it) {
+                reference.push_back(*it);
+            }
+        }
+        assert(result == reference);
+        assert(sharded.count_range(range[0], range[1]) == (int)reference.size());
+    }
+
+    int value = 0;
+    assert(sharded.get(keys_per_thread + 1, [&value](const int& v) { value = v; }) && value == (keys_per_thread + 1) * 2);
+    assert(sharded.put_if_absent(keys_per_thread, 7) == 0);
+    assert(sharded.compare_and_swap(keys_per_thread, 7, 8));
+    assert(!sharded.search_element_silent(keys_per_thread * 2));
+    std::cout << "✓ 范围分片跳表测试通过" << std::endl;
+
+    // 各分片的内存池和纪元回收相互独立：分片 0 上的游标不推迟分片 1 的回收；
+    // 单线程轮流访问 16 个分片时，线程本地查找缓存不会互相挤占
+    {
+        std::vector<int> many_splits;
+        for (int s = 1; s < 16; s++) {
+            many_splits.push_back(s * 1000);
+        }
+        ShardedSkipList<int, int, NullLogger> rotating(many_splits, 18, 16);
+        for (int i = 0; i < 16000; i++) {
+            rotating.put(i, i);
+        }
+        {
+            auto cursor = rotating.shard(0).cursor();
+            cursor.seek_to_first();
+            for (int i = 1000; i < 2000; i++) {
+                rotating.delete_element(i);
+            }
+            for (int i = 0; i < 1000 && rotating.shard(1).memory_usage().pending_reclaim_count > 0; i++) {
+                rotating.search_element_silent(1000);
+            }
+            assert(cursor.valid() && rotating.shard(1).memory_usage().pending_reclaim_count == 0);
+        }
+
+        auto timed_puts = [](auto& list, int spread) {
+            auto start = std::chrono::high_resolution_clock::now();
+            for (int i = 0; i < 160000; i++) {
+                list.put((i % spread) * 1000 + (i / spread) % 1000, i);
+            }
+            return std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::high_resolution_clock::now() - start).count();
+        };
+        auto single_us = timed_puts(rotating, 1);
+        auto rotating_us = timed_puts(rotating, 16);
+        std::cout << "✓ 分片独立回收; 单线程 16 万次写入: 集中于 1 个分片 " << single_us / 1000
+                  << " ms, 轮流访问 16 个分片 " << rotating_us / 1000 << " ms" << std::endl;
+    }
+
+    // 多线程写入：单棵跳表 vs 按线程区间分片
+    auto run_writers = [keys_per_thread](auto& list) {
+        auto start = std::chrono::high_resolution_clock::now();
+        std::vector<std::thread> writers;
+        for (int t = 0; t < NUM_THREADS; t++) {
+            writers.emplace_back([&list, t, keys_per_thread]() {
+                for (int i = 0; i < keys_per_thread; i++) {
+                    list.put(t * keys_per_thread + i, i);
+                }
+            });
+        }
+        for (auto& w : writers) {
+            w.join();
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    };
+    SkipListOptimized<int, int, NullLogger> single(18, 16);
+    ShardedSkipList<int, int, NullLogger> partitioned(splits, 18, 16);
+    auto single_ms = run_writers(single);
+    auto sharded_ms = run_writers(partitioned);
+    assert(single.size() == partitioned.size());
+    std::cout << NUM_THREADS << " 线程各写 " << keys_per_thread << " 个 key (CPU 核数 "
+              << std::thread::hardware_concurrency() << "):" << std::endl;
+    std::cout << "  单棵跳表: " << single_ms << " ms" << std::endl;
+    std::cout << "  " << partitioned.shard_count() << " 个分片: " << sharded_ms << " ms" << std::endl;
+}
+
+// 分片计数器测试
+void test_sharded_counter() {
+    std::cout << "\n========== 分片计数器 ==========" << std::endl;
+    ShardedCounter counter;
+    counter.add(5);
+    counter.decrement();
+    assert(counter.load() == 4);
+    counter.reset();
+    assert(counter.load() == 0);
+
+    // 多线程交替增减，结束后总和精确
+    const int ops = 200000;
+    auto time_increments = [ops](auto& target, auto increment) {
+        auto start = std::chrono::high_resolution_clock::now();
+        std::vector<std::thread> threads;
+        for (int t = 0; t < NUM_THREADS; t++) {
+            threads.emplace_back([&target, increment, ops, t]() {
+                for (int i = 0; i < ops; i++) {
+                    increment(target, (i + t) % 4 == 0 ? -1 : 1);
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    };
+    std::atomic<int64_t> shared(0);
+    auto shared_ms = time_increments(shared, [](std::atomic<int64_t>& c, int d) { c.fetch_add(d, std::memory_order_relaxed); });
+    auto sharded_ms = time_increments(counter, [](ShardedCounter& c, int d) { c.add(d); });
+    assert(counter.load() == shared.load());
+    assert(counter.load() == (int64_t)NUM_THREADS * ops / 2);
+
+    // 元素计数与内存池统计
+    SkipListOptimized<int, int, NullLogger> skipList(16, 16);
+    std::vector<std::thread> writers;
+    for (int t = 0; t < NUM_THREADS; t++) {
+        writers.emplace_back([&skipList, t]() {
+            for (int i = 0; i < 2000; i++) {
+                skipList.put(t * 2000 + i, i);
+            }
+            for (int i = 0; i < 2000; i += 2) {
+                skipList.delete_element(t * 2000 + i);
+            }
+        });
+    }
+    for (auto& t : writers) {
+        t.join();
+    }
+    assert(skipList.size() == NUM_THREADS * 1000);
+    assert(skipList.count_range(0, NUM_THREADS * 2000) == skipList.size());
+    std::cout << "✓ 分片计数器测试通过" << std::endl;
+    std::cout << NUM_THREADS << " 线程各计数 " << ops << " 次 (CPU 核数 " << std::thread::hardware_concurrency() << "):" << std::endl;
+    std::cout << "  单个 std::atomic: " << shared_ms << " ms" << std::endl;
+    std::cout << "  ShardedCounter:   " << sharded_ms << " ms" << std::endl;
+}
+
+// 内存池线程弹匣测试
+void test_memory_pool_magazines() {
+    std::cout << "\n========== 内存池线程弹匣 ==========" << std::endl;
+    {
+        NodeMemoryPool<int, int> pool(16, 4);
+        std::vector<NodeOpt<int, int>*> nodes;
+        for (int i = 0; i < 10; i++) {
+            nodes.push_back(pool.allocate(i, i, 2));
+        }
+        assert(pool.get_allocated_count() == 10);
+        // 弹匣容量 4：第 5 次归还时先把 2 个节点移到共享空闲列表
+        for (auto* node : nodes) {
+            pool.deallocate(node);
+        }
+        assert(pool.get_free_list_size() == 10);
+        std::vector<MagazineStats> stats = pool.get_magazine_stats();
+        assert(stats.size() == 1 && stats[0].owner == std::this_thread::get_id());
+        assert(stats[0].cached <= 4);
+
+        // 同层级节点全部被复用，层级不同则新建
+        for (int i = 0; i < 10; i++) {
+            NodeOpt<int, int>* node = pool.allocate(100 + i, i, 2);
+            assert(node->get_key() == 100 + i && node->get_value() == i && node->next(2) == nullptr);
+            nodes[i] = node;
+        }
+        assert(pool.get_reused_count() == 10 && pool.get_allocated_count() == 10);
+        NodeOpt<int, int>* other = pool.allocate(0, 0, 3);
+        assert(pool.get_allocated_count() == 11);
+        pool.deallocate(other);
+
+        // 另一个线程归还的节点进入它自己的弹匣
+        std::thread([&pool, &nodes]() {
+            for (auto* node : nodes) {
+                pool.deallocate(node);
+            }
+        }).join();
+        assert(pool.get_magazine_stats().size() == 2);
+        assert(pool.get_free_list_size() == 11);
+    }
+
+    // 多线程分配/归还：不使用弹匣 vs 线程弹匣
+    auto churn = [](int magazine_size) {
+        NodeMemoryPool<int, int> pool(100, magazine_size);
+        auto start = std::chrono::high_resolution_clock::now();
+        std::vector<std::thread> threads;
+        for (int t = 0; t < NUM_THREADS; t++) {
+            threads.emplace_back([&pool]() {
+                NodeOpt<int, int>* batch[16];
+                for (int round = 0; round < 20000; round++) {
+                    for (int i = 0; i < 16; i++) {
+                        batch[i] = pool.allocate(i, round, i % 4);
+                    }
+                    for (int i = 0; i < 16; i++) {
+                        pool.deallocate(batch[i]);
+                    }
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        assert(pool.get_free_list_size() == (size_t)pool.get_allocated_count());
+        return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    };
+    auto locked_ms = churn(0);
+    auto magazine_ms = churn(NodeMemoryPool<int, int>::DEFAULT_MAGAZINE_SIZE);
+
+    // 写删混合负载下的弹匣命中率
+    SkipListOptimized<int, int, NullLogger> skipList(16, 16);
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 4; t++) {
+        writers.emplace_back([&skipList, t]() {
+            for (int round = 0; round < 20; round++) {
+                for (int i = 0; i < 1000; i++) {
+                    skipList.put(t * 1000 + i, round);
+                }
+                for (int i = 0; i < 1000; i++) {
+                    skipList.delete_element(t * 1000 + i);
+                }
+            }
+        });
+    }
+    for (auto& t : writers) {
+        t.join();
+    }
+    assert(skipList.size() == 0);
+    std::cout << "✓ 内存池线程弹匣测试通过" << std::endl;
+    std::cout << NUM_THREADS << " 线程各分配/归还 " << 20000 * 16 << " 个节点 (CPU 核数 "
+              << std::thread::hardware_concurrency() << "):" << std::endl;
+    std::cout << "  共享空闲列表加锁: " << locked_ms << " ms" << std::endl;
+    std::cout << "  线程弹匣:         " << magazine_ms << " ms" << std::endl;
+    skipList.print_memory_pool_stats();
+}
+
+// slab 分配器测试
+void test_slab_arena() {
+    std::cout << "\n========== slab 分配器 ==========" << std::endl;
+    const size_t slab_size = 64 * 1024;
+    for (int huge_pages = 0; huge_pages <= 1; huge_pages++) {
+        SlabArena arena(slab_size, huge_pages == 1);
+        char* previous = nullptr;
+        size_t previous_size = 0;
+        for (int i = 0; i < 5000; i++) {
+            size_t size = 40 + (i % 7) * 8;
+            char* memory = static_cast<char*>(arena.allocate(size));
+            assert(reinterpret_cast<uintptr_t>(memory) % 16 == 0);
+            memset(memory, i & 0xff, size);
+            // 同一 slab 内按地址递增连续切分
+            if (previous != nullptr && (reinterpret_cast<uintptr_t>(memory) & ~(slab_size - 1)) ==
+                                       (reinterpret_cast<uintptr_t>(previous) & ~(slab_size - 1))) {
+                assert(memory >= previous + previous_size);
+            }
+            previous = memory;
+            previous_size = size;
+        }
+        size_t slabs = arena.get_slab_count();
+        assert(slabs > 1 && arena.get_reserved_bytes() == slabs * slab_size);
+        assert(arena.get_used_bytes() <= arena.get_reserved_bytes());
+
+        // 超过 slab 可用空间的对象单独占用一块
+        char* large = static_cast<char*>(arena.allocate(slab_size));
+        memset(large, 1, slab_size);
+        assert(arena.get_slab_count() == slabs + 1 && arena.get_reserved_bytes() == (slabs + 2) * slab_size);
+    }
+
+    // 跳表节点全部来自 slab，层级随机的节点被回收后按层级复用
+    {
+        SkipListOptimized<int, std::string, NullLogger> skipList(18, 16);
+        for (int round = 0; round < 3; round++) {
+            for (int i = 0; i < 20000; i++) {
+                skipList.put(i, std::string(32, 'a' + round));
+            }
+            for (int i = 0; i < 20000; i++) {
+                skipList.delete_element(i);
+            }
+        }
+        skipList.put(1, "one");
+        std::string value;
+        assert(skipList.get(1, [&value](const std::string& v) { value = v; }) && value == "one");
+    }
+
+    // 分配 + 释放：逐个 operator new/delete vs slab 切分、整块释放
+    const int objects = 1000000;
+    const size_t object_size = NodeOpt<int, int>::allocation_size(1);
+    std::vector<void*> pointers(objects);
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < objects; i++) {
+        pointers[i] = ::operator new(object_size);
+    }
+    for (int i = 0; i < objects; i++) {
+        ::operator delete(pointers[i]);
+    }
+    auto heap_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::high_resolution_clock::now() - start).count();
+    start = std::chrono::high_resolution_clock::now();
+    {
+        SlabArena arena;
+        for (int i = 0; i < objects; i++) {
+            pointers[i] = arena.allocate(object_size);
+        }
+    }
+    auto slab_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::high_resolution_clock::now() - start).count();
+
+    std::cout << "✓ slab 分配器测试通过" << std::endl;
+    std::cout << "分配并释放 " << objects << " 个 " << object_size << " 字节节点:" << std::endl;
+    std::cout << "  operator new/delete: " << heap_ms << " ms" << std::endl;
+    std::cout << "  slab 切分 + 整块释放: " << slab_ms << " ms" << std::endl;
+}
+
+// 内存预算、收缩与内存占用统计测试
+void test_memory_budget() {
+    std::cout << "\n========== 内存预算与收缩 ==========" << std::endl;
+    const int n = 50000;
+    const std::string blob(200, 'v');
+    {
+        // 不使用线程弹匣，空闲节点全部进入共享空闲列表
+        SkipListOptimized<int, std::string, NullLogger> skipList(18, 16, 0);
+        for (int i = 0; i < n; i++) {
+            skipList.put(i, blob);
+        }
+        MemoryUsage usage = skipList.memory_usage();
+        assert(usage.element_count == (size_t)n);
+        assert(usage.key_bytes == n * sizeof(int));
+        assert(usage.value_bytes >= n * (sizeof(std::string) + blob.size()));
+        assert(usage.tower_bytes >= n * (sizeof(void*) + sizeof(int)));
+        assert(usage.free_node_bytes == 0);
+        size_t reserved = usage.slab_reserved_bytes;
+        std::cout << n << " 个元素: 节点 " << (usage.node_bytes >> 10) << " KB, 塔 " << (usage.tower_bytes >> 10)
+                  << " KB, key " << (usage.key_bytes >> 10) << " KB, value " << (usage.value_bytes >> 10)
+                  << " KB, slab " << (reserved >> 10) << " KB" << std::endl;
+
+        // 分项统计增量维护：覆盖写（长短不同的 value）、逐个删除、范围删除后，
+        // 待回收节点全部回收时与遍历得到的结果一致
+        for (int i = 0; i < n; i += 3) {
+            skipList.put(i, std::string(i % 2 ? 8 : 500, 'w'));
+        }
+        skipList.compare_and_swap(1, blob, std::string(1000, 'c'));
+        for (int i = 5; i < n; i += 10) {
+            skipList.delete_element(i);
+        }
+        skipList.delete_range(n / 2, n / 2 + 999);
+        for (int i = 0; i < 1000 && skipList.memory_usage().pending_reclaim_count > 0; i++) {
+            skipList.get(0, [](const std::string&) {});
+        }
+        usage = skipList.memory_usage();
+        assert(usage.pending_reclaim_count == 0);
+        size_t walked_value_bytes = 0;
+        size_t walked_count = 0;
+        {
+            auto cursor = skipList.cursor();
+            for (cursor.seek_to_first(); cursor.valid(); cursor.next()) {
+                cursor.read_value([&walked_value_bytes](const std::string& v) {
+                    walked_value_bytes += sizeof(std::string) + payload_heap_bytes(v);
+                });
+                walked_count++;
+            }
+        }
+        assert(usage.element_count == walked_count && usage.key_bytes == walked_count * sizeof(int));
+        assert(usage.value_bytes == walked_value_bytes);
+        std::cout << "覆盖写与删除后: " << walked_count << " 个元素, value " << (usage.value_bytes >> 10)
+                  << " KB（增量统计与遍历一致）" << std::endl;
+
+        // 全部删除后空闲节点留在内存池；未设预算时 trim 不释放
+        for (int i = 0; i < n; i++) {
+            skipList.delete_element(i);
+        }
+        assert(skipList.trim_memory() == 0);
+        usage = skipList.memory_usage();
+        assert(usage.element_count == 0 && usage.free_node_bytes > 0);
+        assert(usage.slab_reserved_bytes == reserved);
+
+        // 预算为 0：完全空闲的 slab 全部归还系统
+        skipList.set_memory_budget(0);
+        size_t released = skipList.trim_memory();
+        usage = skipList.memory_usage();
+        // 整块归还的 slab 减少 slab_reserved_bytes，仍有待回收节点的 slab 只归还空闲页面
+        assert(released > 0 && usage.slab_reserved_bytes < reserved);
+        assert(usage.slab_reserved_bytes + released >= reserved);
+        assert(usage.slab_released_bytes == released);
+        std::cout << "删除全部元素后收缩: 归还 " << (released >> 10) << " KB, 仍保留空闲节点 "
+                  << (usage.free_node_bytes >> 10) << " KB（slab 中有待回收节点）" << std::endl;
+
+        // 收缩后仍可正常读写
+        for (int i = 0; i < 1000; i++) {
+            skipList.put(i, blob);
+        }
+        assert(skipList.size() == 1000 && skipList.count_range(0, 999) == 1000);
+    }
+    {
+        // 后台收缩：删除后无需手动 trim，后台线程在下一个间隔内归还空闲 slab
+        SkipListOptimized<int, std::string, NullLogger> skipList(18, 16, 0);
+        skipList.set_memory_budget(256 * 1024);
+        skipList.start_background_trim(std::chrono::milliseconds(5));
+        for (int i = 0; i < n; i++) {
+            skipList.put(i, blob);
+        }
+        for (int i = 0; i < n; i++) {
+            skipList.delete_element(i);
+        }
+        MemoryUsage usage = skipList.memory_usage();
+        for (int wait = 0; wait < 200 && usage.slab_released_bytes == 0; wait++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            usage = skipList.memory_usage();
+        }
+        skipList.stop_background_trim();
+        assert(usage.element_count == 0 && usage.slab_released_bytes > 0);
+        std::cout << "后台收缩归还 " << (usage.slab_released_bytes >> 10) << " KB，当前 slab "
+                  << (usage.slab_reserved_bytes >> 10) << " KB" << std::endl;
+    }
+    {
+        // 每个 slab 都留有存活节点：不能整块归还，改为归还被空闲节点完全覆盖的页面
+        SkipListOptimized<int, std::string, NullLogger> skipList(18, 16, 0);
+        for (int i = 0; i < n; i++) {
+            skipList.put(i, blob);
+        }
+        for (int i = 0; i < n; i++) {
+            if (i % 256 != 0) {
+                skipList.delete_element(i);
+            }
+        }
+        MemoryUsage before = skipList.memory_usage();
+        skipList.set_memory_budget(0);
+        size_t released = skipList.trim_memory();
+        MemoryUsage usage = skipList.memory_usage();
+        assert(released > 0 && usage.slab_reserved_bytes == before.slab_reserved_bytes);
+        assert(usage.free_node_bytes < before.free_node_bytes);
+        std::cout << "每 256 个保留一个后收缩: 归还空闲页面 " << (released >> 10) << " KB，slab 仍为 "
+                  << (usage.slab_reserved_bytes >> 10) << " KB" << std::endl;
+
+        // 存活节点不受影响；页面已归还的节点在原地址重新构造后复用
+        for (int i = 0; i < n; i += 256) {
+            assert(skipList.get(i, [&blob](const std::string& v) { assert(v == blob); }));
+        }
+        for (int i = 0; i < n; i++) {
+            if (i % 256 != 0) {
+                skipList.put(i, std::to_string(i));
+            }
+        }
+        assert(skipList.size() == n && skipList.count_range(0, n - 1) == n);
+        assert(skipList.memory_usage().slab_reserved_bytes == before.slab_reserved_bytes);
+        for (int i = 1; i < n; i += 97) {
+            std::string expected = (i % 256 == 0) ? blob : std::to_string(i);
+            assert(skipList.get(i, [&expected](const std::string& v) { assert(v == expected); }));
+        }
+    }
+    {
+        // 归还节点的线程超出预算时只登记收缩请求，自己不收缩；
+        // 后台线程启动后立即处理积压的请求，不必等满一个间隔
+        SkipListOptimized<int, std::string, NullLogger> skipList(18, 16, 0);
+        skipList.set_memory_budget(256 * 1024);
+        for (int i = 0; i < n; i++) {
+            skipList.put(i, blob);
+        }
+        for (int i = 0; i < n; i++) {
+            skipList.delete_element(i);
+        }
+        MemoryUsage usage = skipList.memory_usage();
+        assert(usage.slab_released_bytes == 0);
+        skipList.start_background_trim(std::chrono::seconds(60));
+        for (int wait = 0; wait < 400 && usage.slab_released_bytes == 0; wait++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            usage = skipList.memory_usage();
+        }
+        skipList.stop_background_trim();
+        assert(usage.slab_released_bytes > 0);
+        std::cout << "积压的收缩请求由后台线程处理: 归还 " << (usage.slab_released_bytes >> 10) << " KB，空闲节点 "
+                  << (usage.free_node_bytes >> 10) << " KB" << std::endl;
+    }
+    std::cout << "✓ 内存预算与收缩测试通过" << std::endl;
+}
+
+// 在栈大小为 stack_bytes 的线程中运行 f，用于验证析构的栈深度与元素个数无关
+template<typename F>
+void run_with_stack(size_t stack_bytes, F f) {
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, stack_bytes);
+    pthread_t thread;
+    void* (*trampoline)(void*) = [](void* arg) -> void* {
+        (*static_cast<F*>(arg))();
+        return nullptr;
+    };
+    int rc = pthread_create(&thread, &attr, trampoline, &f);
+    assert(rc == 0);
+    pthread_join(thread, nullptr);
+    pthread_attr_destroy(&attr);
+}
+
+// 大跳表析构测试
+void test_teardown() {
+    std::cout << "\n========== 大跳表析构 ==========" << std::endl;
+    const int n = 200000;
+    const size_t small_stack = 256 * 1024;
+
+    // 在 256 KB 栈上析构 20 万元素的跳表：递归实现每个元素占一层栈帧，必然溢出
+    auto* basic = new SkipList<int, std::string, NullLogger>(18);
+    auto* optimized = new SkipListOptimized<int, std::string, NullLogger>(18, 16);
+    for (int i = 0; i < n; i++) {
+        basic->insert_element(i, "value");
+        optimized->put(i, "value");
+    }
+    run_with_stack(small_stack, [basic]() { delete basic; });
+    run_with_stack(small_stack, [optimized]() { delete optimized; });
+    std::cout << "✓ 256 KB 栈上析构 " << n << " 个元素的基础版、优化版跳表" << std::endl;
+
+    // 析构耗时：逐个 delete vs slab 整块释放（key/value 无需析构时不遍历链表）
+    const int big = 500000;
+    auto time_delete = [](auto* list) {
+        auto start = std::chrono::high_resolution_clock::now();
+        delete list;
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::high_resolution_clock::now() - start).count();
+    };
+    auto* basic_ints = new SkipList<int, int, NullLogger>(18);
+    auto* slab_ints = new SkipListOptimized<int, int, NullLogger>(18, 16);
+    auto* slab_strings = new SkipListOptimized<int, std::string, NullLogger>(18, 16);
+    for (int i = 0; i < big; i++) {
+        basic_ints->insert_element(i, i);
+        slab_ints->put(i, i);
+        slab_strings->put(i, std::string(32, 's'));
+    }
+    auto basic_ms = time_delete(basic_ints);
+    auto slab_ints_ms = time_delete(slab_ints);
+    auto slab_strings_ms = time_delete(slab_strings);
+    std::cout << "析构 " << big << " 个元素:" << std::endl;
+    std::cout << "  基础版 <int, int>（逐个 delete）:     " << basic_ms << " ms" << std::endl;
+    std::cout << "  优化版 <int, int>（整块释放 slab）:   " << slab_ints_ms << " ms" << std::endl;
+    std::cout << "  优化版 <int, string>（析构 value）:   " << slab_strings_ms << " ms" << std::endl;
+}
+
+// 随机层级生成器测试
+void test_random_level() {
+    std::cout << "\n========== 随机层级生成器 ==========" << std::endl;
+    const int samples = 1000000;
+
+    // 层级分布：P(level = k) = p^k (1 - p)，层级 0 同样会被选中
+    LevelProbability probabilities[] = {LevelProbability::Half, LevelProbability::Quarter, LevelProbability::InverseE};
+    const char* names[] = {"1/2", "1/4", "1/e"};
+    for (int t = 0; t < 3; t++) {
+        LevelGenerator generator(32, probabilities[t]);
+        double p = LevelGenerator::probability_value(probabilities[t]);
+        std::vector<int> histogram(33, 0);
+        for (int i = 0; i < samples; i++) {
+            int level = generator.next();
+            assert(level >= 0 && level <= 32);
+            histogram[level]++;
+        }
+        double expected = 1.0 - p;
+        for (int k = 0; k < 4; k++) {
+            double observed = (double)histogram[k] / samples;
+            assert(std::abs(observed - expected) < 0.01);
+            expected *= p;
+        }
+        double pointers = 0;
+        for (int k = 0; k <= 32; k++) {
+            pointers += (double)histogram[k] * (k + 1);
+        }
+        std::cout << "p = " << names[t] << ": 层级 0/1/2 占比 " << (double)histogram[0] / samples << " / "
+                  << (double)histogram[1] / samples << " / " << (double)histogram[2] / samples
+                  << "，平均指针数 " << pointers / samples << std::endl;
+    }
+
+    // 上限截断
+    LevelGenerator capped(3);
+    int top = 0;
+    for (int i = 0; i < 10000; i++) {
+        int level = capped.next();
+        assert(level <= 3);
+        top = std::max(top, level);
+    }
+    assert(top == 3);
+
+    // 由预期容量推导 max_level
+    assert(LevelGenerator::max_level_for(1) == 1);
+    assert(LevelGenerator::max_level_for(1 << 20) == 20);
+    assert(LevelGenerator::max_level_for(1 << 20, LevelProbability::Quarter) == 10);
+    assert(LevelGenerator::max_level_for(1000000, LevelProbability::InverseE) == 14);
+
+    // 按预期容量构造：基础版、优化版、范围分片跳表（容量按分片均分）
+    SkipList<int, int, NullLogger> basic((size_t)(1 << 20), LevelProbability::Quarter);
+    assert(basic.get_max_level() == 10 && basic.get_level_probability() == LevelProbability::Quarter);
+    SkipListOptimized<int, int, NullLogger> optimized((size_t)1000000, LevelProbability::InverseE);
+    assert(optimized.get_max_level() == 14 && optimized.get_level_probability() == LevelProbability::InverseE);
+    ShardedSkipList<int, int, NullLogger> sharded({100, 200, 300}, (size_t)(1 << 20), LevelProbability::Half);
+    for (int s = 0; s < sharded.shard_count(); s++) {
+        assert(sharded.shard(s).get_max_level() == 18);
+        assert(sharded.shard(s).get_level_probability() == LevelProbability::Half);
+    }
+    std::cout << "✓ 层级分布、上限截断、max_level 推导正确" << std::endl;
+
+    // 各线程的随机序列互不相同
+    std::vector<uint64_t> firsts(NUM_THREADS);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < NUM_THREADS; t++) {
+        threads.emplace_back([&firsts, t]() { firsts[t] = LevelGenerator::next_random(); });
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+    std::set<uint64_t> distinct(firsts.begin(), firsts.end());
+    assert((int)distinct.size() == NUM_THREADS);
+
+    // 生成速度：rand() 按层循环 vs 线程局部随机源一次前导零计数
+    auto bench = [](auto draw) {
+        std::atomic<long long> sink(0);
+        auto start = std::chrono::high_resolution_clock::now();
+        std::vector<std::thread> workers;
+        for (int t = 0; t < NUM_THREADS; t++) {
+            workers.emplace_back([&draw, &sink]() {
+                long long local = 0;
+                for (int i = 0; i < samples / NUM_THREADS; i++) {
+                    local += draw();
+                }
+                sink += local;
+            });
+        }
+        for (auto& w : workers) {
+            w.join();
+        }
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::high_resolution_clock::now() - start).count();
+    };
+    LevelGenerator generator(18);
+    auto rand_us = bench([]() {
+        int k = 1;
+        while (rand() % 2) {
+            k++;
+        }
+        return k < 18 ? k : 18;
+    });
+    auto generator_us = bench([&generator]() { return generator.next(); });
+    std::cout << NUM_THREADS << " 线程共生成 " << samples << " 个层级:" << std::endl;
+    std::cout << "  rand() 循环:       " << rand_us << " us" << std::endl;
+    std::cout << "  LevelGenerator:    " << generator_us << " us" << std::endl;
+
+    // 分支因子对塔内存的影响，查询与排名不受影响
+    const int n = 100000;
+    size_t tower_half = 0;
+    for (int t = 0; t < 3; t++) {
+        SkipListOptimized<int, int, NullLogger> skipList((size_t)n, probabilities[t], 16);
+        assert(skipList.get_max_level() == LevelGenerator::max_level_for(n, probabilities[t]));
+        assert(skipList.get_level_probability() == probabilities[t]);
+        for (int i = 0; i < n; i++) {
+            skipList.put(i, i);
+        }
+        for (int i = 0; i < n; i += 7) {
+            int value = -1;
+            assert(skipList.get(i, [&value](const int& v) { value = v; }));
+            assert(value == i);
+            assert(skipList.rank(i) == i);
+        }
+        size_t tower = skipList.memory_usage().tower_bytes;
+        if (t == 0) {
+            tower_half = tower;
+        } else if (probabilities[t] == LevelProbability::Quarter) {
+            assert(tower < tower_half);
+        }
+        std::cout << "p = " << names[t] << ", max_level " << LevelGenerator::max_level_for(n, probabilities[t])
+                  << ": 塔内存 " << (tower >> 10) << " KB" << std::endl;
+    }
+    std::cout << "✓ 不同分支因子下查询、排名正确" << std::endl;
+}
+
+// finger 查找测试
+void test_finger_search() {
+    std::cout << "\n========== finger 查找 ==========" << std::endl;
+
+    // 正确性：递增段、随机写入、删除交替进行，与 std::map 对照 key、排名和元素个数
+    SkipList<int, int, NullLogger> basic(16);
+    SkipListOptimized<int, int, NullLogger> optimized(16, 16);
+    std::map<int, int> reference;
+    srand(22);
+    int next_key = 0;
+    for (int round = 0; round < 200; round++) {
+        int mode = rand() % 3;
+        for (int j = 0; j < 100; j++) {
+            int key = (mode == 0) ? next_key++ : rand() % 30000;
+            if (mode == 2 && j % 2 == 0) {
+                basic.delete_element(key);
+                optimized.delete_element(key);
+                reference.erase(key);
+            } else {
+                basic.put(key, round);
+                optimized.put(key, round);
+                reference[key] = round;
+            }
+        }
+        int probe = rand() % 30000;
+        int expected_rank = (int)std::distance(reference.begin(), reference.lower_bound(probe));
+        assert(basic.rank(probe) == expected_rank);
+        assert(optimized.rank(probe) == expected_rank);
+        assert(basic.search_element(probe) == (reference.count(probe) == 1));
+    }
+    assert(basic.size() == (int)reference.size());
+    assert(optimized.size() == (int)reference.size());
+    auto basic_cursor = basic.cursor();
+    auto optimized_cursor = optimized.cursor();
+    basic_cursor.seek_to_first();
+    optimized_cursor.seek_to_first();
+    for (auto& entry : reference) {
+        assert(basic_cursor.valid() && basic_cursor.key() == entry.first && basic_cursor.value() == entry.second);
+        assert(optimized_cursor.valid() && optimized_cursor.key() == entry.first);
+        basic_cursor.next();
+        optimized_cursor.next();
+    }
+    assert(!basic_cursor.valid() && !optimized_cursor.valid());
+
+    // 游标向后 seek 从当前节点出发
+    auto cursor = basic.cursor();
+    cursor.seek_to_first();
+    for (int probe = 0; probe < 30000; probe += 37) {
+        cursor.seek(probe);
+        auto it = reference.lower_bound(probe);
+        assert(cursor.valid() == (it != reference.end()));
+        if (it != reference.end()) {
+            assert(cursor.key() == it->first);
+        }
+    }
+    std::cout << "✓ 递增、随机写入与删除交替时结果与 std::map 一致" << std::endl;
+
+    // 性能：递增写入只检查 finger 的最低几层，乱序写入每次都从头节点下降
+    const int n = 500000;
+    std::vector<int> ascending(n);
+    for (int i = 0; i < n; i++) {
+        ascending[i] = i;
+    }
+    std::vector<int> shuffled = ascending;
+    std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(22));
+    auto time_puts = [](auto& list, const std::vector<int>& keys) {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int key : keys) {
+            list.put(key, key);
+        }
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::high_resolution_clock::now() - start).count();
+    };
+    SkipList<int, int, NullLogger> basic_ascending(18), basic_shuffled(18);
+    SkipListOptimized<int, int, NullLogger> optimized_ascending(18, 16), optimized_shuffled(18, 16);
+    auto basic_ascending_ms = time_puts(basic_ascending, ascending);
+    auto basic_shuffled_ms = time_puts(basic_shuffled, shuffled);
+    auto optimized_ascending_ms = time_puts(optimized_ascending, ascending);
+    auto optimized_shuffled_ms = time_puts(optimized_shuffled, shuffled);
+    assert(basic_ascending.size() == n && optimized_ascending.size() == n);
+    assert(optimized_ascending.rank(n / 2) == n / 2);
+    std::cout << "写入 " << n << " 个 key:" << std::endl;
+    std::cout << "  基础版 递增 / 乱序:   " << basic_ascending_ms << " ms / " << basic_shuffled_ms << " ms" << std::endl;
+    std::cout << "  优化版 递增 / 乱序:   " << optimized_ascending_ms << " ms / " << optimized_shuffled_ms << " ms" << std::endl;
+}
+
+// 有序批量导入测试
+void test_bulk_load() {
+    std::cout << "\n========== 有序批量导入 ==========" << std::endl;
+
+    // 平衡层级：每 2 个元素一个 1 层节点，每 4 个一个 2 层节点
+    LevelGenerator half(16), quarter(16, LevelProbability::Quarter), third(16, LevelProbability::InverseE);
+    int expected_half[] = {0, 1, 0, 2, 0, 1, 0, 3};
+    for (int i = 0; i < 8; i++) {
+        assert(half.balanced_level(i + 1) == expected_half[i]);
+    }
+    assert(quarter.balanced_level(4) == 1 && quarter.balanced_level(8) == 1 && quarter.balanced_level(16) == 2);
+    assert(third.balanced_level(9) == 2 && third.balanced_level(10) == 0);
+    assert(LevelGenerator(3).balanced_level(1 << 10) == 3);
+
+    // 与已有 key 交错：已存在的 key 跳过，乱序的部分按普通插入处理，导入后跨度仍正确
+    auto check = [](auto& list, const std::map<int, int>& reference) {
+        assert(list.size() == (int)reference.size());
+        int k = 0;
+        for (auto& entry : reference) {
+            int key = -1, value = -1;
+            assert(list.rank(entry.first) == k);
+            assert(list.select(k, &key, &value));
+            assert(key == entry.first && value == entry.second);
+            k++;
+        }
+    };
+    for (int balanced = 0; balanced <= 1; balanced++) {
+        SkipList<int, int, NullLogger> basic(16);
+        SkipListOptimized<int, int, NullLogger> optimized(16, 16);
+        std::map<int, int> reference;
+        for (int i = 0; i < 2000; i += 3) {
+            basic.put(i, -i);
+            optimized.put(i, -i);
+            reference[i] = -i;
+        }
+        std::vector<std::pair<int, int>> input;
+        for (int i = 0; i < 6000; i += 2) {
+            input.push_back(std::make_pair(i, i));
+        }
+        input.push_back(std::make_pair(7, 7));      // 乱序
+        input.push_back(std::make_pair(9000, 9000));
+        int expected_loaded = 0;
+        for (auto& entry : input) {
+            expected_loaded += reference.insert(entry).second ? 1 : 0;
+        }
+        assert(basic.bulk_load(input.begin(), input.end(), balanced) == expected_loaded);
+        assert(optimized.bulk_load(input.begin(), input.end(), balanced) == expected_loaded);
+        check(basic, reference);
+        check(optimized, reference);
+
+        // 导入后继续普通写入和删除
+        for (int i = 1; i < 10000; i += 97) {
+            basic.put(i, i);
+            optimized.put(i, i);
+            reference[i] = i;
+            basic.delete_element(i + 1);
+            optimized.delete_element(i + 1);
+            reference.erase(i + 1);
+        }
+        check(basic, reference);
+        check(optimized, reference);
+    }
+
+    // 范围分片：输入按分割点切段后交给各分片
+    ShardedSkipList<int, int, NullLogger> sharded({1000, 2000}, 16, 4);
+    std::vector<std::pair<int, int>> sorted_input;
+    for (int i = 0; i < 3000; i++) {
+        sorted_input.push_back(std::make_pair(i, i));
+    }
+    assert(sharded.bulk_load(sorted_input.begin(), sorted_input.end()) == 3000);
+    assert(sharded.size() == 3000 && sharded.shard(1).size() == 1000);
+    assert(sharded.count_range(500, 2499) == 2000);
+    std::cout << "✓ 追加、交错、乱序输入与分片导入的结果、排名均正确" << std::endl;
+
+    // 快照往返：load_file 按块导入，跨越多个块后结果与排名仍正确
+    {
+        using Snapshot = SkipListOptimized<int, std::string, NullLogger>;
+        Snapshot saved(16, 16), loaded(16, 16);
+        const int chunk = (int)Snapshot::LOAD_CHUNK;
+        const int count = 2 * chunk + 100;
+        for (int i = 0; i < count; i++) {
+            saved.put(i * 2, "value_" + std::to_string(i * 2));
+        }
+        {
+            CoutRedirect redirect;
+            saved.dump_file();
+            loaded.load_file();
+        }
+        assert(loaded.size() == count);
+        for (int k = 0; k < count; k += 97) {
+            int key = -1;
+            std::string value;
+            assert(loaded.select(k, &key, &value));
+            assert(key == k * 2 && value == "value_" + std::to_string(k * 2));
+            assert(loaded.rank(key) == k);
+        }
+        std::cout << "✓ load_file 分 " << (count + chunk - 1) / chunk << " 块导入 " << count << " 个元素" << std::endl;
+    }
+
+    // 性能：逐个 insert_element vs 批量导入（随机层级 / 平衡层级）
+    const int n = 1000000;
+    std::vector<std::pair<int, int>> entries(n);
+    for (int i = 0; i < n; i++) {
+        entries[i] = std::make_pair(i, i);
+    }
+    auto timed = [](auto&& action) {
+        auto start = std::chrono::high_resolution_clock::now();
+        action();
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::high_resolution_clock::now() - start).count();
+    };
+    {
+        SkipList<int, int, NullLogger> one_by_one(20), bulk(20), balanced(20);
+        auto insert_ms = timed([&]() {
+            for (auto& entry : entries) {
+                one_by_one.insert_element(entry.first, entry.second);
+            }
+        });
+        auto bulk_ms = timed([&]() { bulk.bulk_load(entries.begin(), entries.end()); });
+        auto balanced_ms = timed([&]() { balanced.bulk_load(entries.begin(), entries.end(), true); });
+        assert(bulk.size() == n && balanced.size() == n && balanced.rank(n - 1) == n - 1);
+        std::cout << "基础版导入 " << n << " 个有序元素:" << std::endl;
+        std::cout << "  逐个 insert_element:   " << insert_ms << " ms" << std::endl;
+        std::cout << "  bulk_load:             " << bulk_ms << " ms" << std::endl;
+        std::cout << "  bulk_load（平衡层级）: " << balanced_ms << " ms" << std::endl;
+    }
+    {
+        SkipListOptimized<int, int, NullLogger> one_by_one(20, 16), bulk(20, 16), balanced(20, 16);
+        auto insert_ms = timed([&]() {
+            for (auto& entry : entries) {
+                one_by_one.insert_element(entry.first, entry.second);
+            }
+        });
+        auto bulk_ms = timed([&]() { bulk.bulk_load(entries.begin(), entries.end()); });
+        auto balanced_ms = timed([&]() { balanced.bulk_load(entries.begin(), entries.end(), true); });
+        assert(bulk.size() == n && balanced.size() == n && balanced.rank(n - 1) == n - 1);
+        std::cout << "优化版导入 " << n << " 个有序元素:" << std::endl;
+        std::cout << "  逐个 insert_element:   " << insert_ms << " ms" << std::endl;
+        std::cout << "  bulk_load:             " << bulk_ms << " ms" << std::endl;
+        std::cout << "  bulk_load（平衡层级）: " << balanced_ms << " ms" << std::endl;
+    }
+}
+
+// 降序扫描测试
+void test_descending_scans() {
+    std::cout << "\n========== 降序扫描 ==========" << std::endl;
+    SkipList<int, int, NullLogger> basic(16);
+    SkipListOptimized<int, int, NullLogger> optimized(16, 16);
+    std::map<int, int> reference;
+    srand(24);
+    for (int i = 0; i < 5000; i++) {
+        int key = rand() % 20000;
+        basic.put(key, i);
+        optimized.put(key, i);
+        reference[key] = i;
+    }
+
+    // range_query_desc 与 std::map 的反向遍历对照
+    for (int t = 0; t < 500; t++) {
+        int hi = rand() % 21000 - 500;
+        int lo = rand() % 21000 - 500;
+        int limit = (t % 5 == 0) ? std::numeric_limits<int>::max() : rand() % 300;
+        std::vector<std::pair<int, int>> expected;
+        if (!(hi < lo)) {
+            auto it = reference.upper_bound(hi);
+            while (it != reference.begin() && (int)expected.size() < limit) {
+                --it;
+                if (it->first < lo) {
+                    break;
+                }
+                expected.push_back(*it);
+            }
+        }
+        assert(basic.range_query_desc(hi, lo, limit) == expected);
+        assert(optimized.range_query_desc(hi, lo, limit) == expected);
+    }
+
+    // 反向游标：从末尾遍历全部元素，以及定位到最后一个 <= key 的元素
+    auto basic_cursor = basic.reverse_cursor();
+    auto optimized_cursor = optimized.reverse_cursor();
+    basic_cursor.seek_to_last();
+    optimized_cursor.seek_to_last();
+    for (auto it = reference.rbegin(); it != reference.rend(); ++it) {
+        assert(basic_cursor.valid() && basic_cursor.key() == it->first && basic_cursor.value() == it->second);
+        assert(optimized_cursor.valid() && optimized_cursor.key() == it->first && optimized_cursor.value() == it->second);
+        basic_cursor.next();
+        optimized_cursor.next();
+    }
+    assert(!basic_cursor.valid() && !optimized_cursor.valid());
+    for (int t = 0; t < 200; t++) {
+        int key = rand() % 21000 - 500;
+        auto it = reference.upper_bound(key);
+        basic_cursor.seek(key);
+        optimized_cursor.seek(key);
+        assert(basic_cursor.valid() == (it != reference.begin()));
+        assert(optimized_cursor.valid() == (it != reference.begin()));
+        if (it != reference.begin()) {
+            --it;
+            assert(basic_cursor.key() == it->first && optimized_cursor.key() == it->first);
+        }
+    }
+
+    // 优化版反向游标遍历期间有写入：各块按 key 重新定位，结果仍严格降序
+    auto cursor = optimized.reverse_cursor();
+    int previous = std::numeric_limits<int>::max();
+    int visited = 0;
+    for (cursor.seek_to_last(); cursor.valid(); cursor.next()) {
+        assert(cursor.key() < previous);
+        previous = cursor.key();
+        if (++visited % 50 == 0) {
+            optimized.put(previous - 1, 0);
+            optimized.delete_element(previous - 3);
+        }
+    }
+
+    // 范围分片：从 hi 所在分片向前查询
+    ShardedSkipList<int, int, NullLogger> sharded({5000, 10000, 15000}, 16, 4);
+    for (auto& entry : reference) {
+        sharded.put(entry.first, entry.second);
+    }
+    std::vector<std::pair<int, int>> tail = sharded.range_query_desc(12000, 1000, 2000);
+    assert(tail.size() == 2000);
+    auto it = reference.upper_bound(12000);
+    for (auto& entry : tail) {
+        --it;
+        assert(entry.first == it->first && entry.second == it->second);
+    }
+    std::cout << "✓ 降序范围查询、反向游标与 std::map 一致" << std::endl;
+
+    // 性能：“key X 之前最新的 100 条”——正向范围查询整个前缀再取尾部 vs 降序查询
+    const int n = 1000000;
+    SkipListOptimized<int, int, NullLogger> series(20, 16);
+    std::vector<std::pair<int, int>> entries(n);
+    for (int i = 0; i < n; i++) {
+        entries[i] = std::make_pair(i, i);
+    }
+    series.bulk_load(entries.begin(), entries.end());
+    const int queries = 50;
+    auto start = std::chrono::high_resolution_clock::now();
+    size_t forward_total = 0;
+    for (int q = 0; q < queries; q++) {
+        int x = n - 1 - q * 3989;
+        std::vector<std::pair<int, int>> prefix = series.range_query(0, x);
+        forward_total += std::min<size_t>(100, prefix.size());
+    }
+    auto forward_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::high_resolution_clock::now() - start).count();
+    start = std::chrono::high_resolution_clock::now();
+    size_t desc_total = 0;
+    for (int q = 0; q < queries; q++) {
+        int x = n - 1 - q * 3989;
+        desc_total += series.range_query_desc(x, 0, 100).size();
+    }
+    auto desc_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::high_resolution_clock::now() - start).count();
+    assert(forward_total == desc_total);
+    std::cout << queries << " 次“key X 之前最新的 100 条”（" << n << " 个元素）:" << std::endl;
+    std::cout << "  range_query 前缀后取尾部: " << forward_ms << " ms" << std::endl;
+    std::cout << "  range_query_desc:         " << desc_us << " us" << std::endl;
+}
+
+// 范围删除测试
+void test_delete_range() {
+    std::cout << "\n========== 范围删除 ==========" << std::endl;
+
+    // 正确性：随机区间删除与 std::map 对照，删除后排名与后续写入仍正确
+    auto check = [](auto& list, const std::map<int, int>& reference) {
+        assert(list.size() == (int)reference.size());
+        auto cursor = list.cursor();
+        cursor.seek_to_first();
+        int k = 0;
+        for (auto& entry : reference) {
+            assert(cursor.valid() && cursor.key() == entry.first && cursor.value() == entry.second);
+            if (k % 17 == 0) {
+                assert(list.rank(entry.first) == k);
+            }
+            cursor.next();
+            k++;
+        }
+        assert(!cursor.valid());
+    };
+    SkipList<int, int, NullLogger> basic(16);
+    SkipListOptimized<int, int, NullLogger> optimized(16, 16);
+    std::map<int, int> reference;
+    srand(25);
+    for (int round = 0; round < 100; round++) {
+        for (int j = 0; j < 300; j++) {
+            int key = rand() % 50000;
+            basic.put(key, round);
+            optimized.put(key, round);
+            reference[key] = round;
+        }
+        int lo = rand() % 52000 - 1000;
+        int hi = lo + rand() % ((round % 10 == 0) ? 60000 : 3000) - 100;
+        int expected = 0;
+        if (!(hi < lo)) {
+            auto first = reference.lower_bound(lo);
+            auto last = reference.upper_bound(hi);
+            expected = (int)std::distance(first, last);
+            reference.erase(first, last);
+        }
+        assert(basic.delete_range(lo, hi) == expected);
+        assert(optimized.delete_range(lo, hi) == expected);
+        if (round % 10 == 0) {
+            check(basic, reference);
+            check(optimized, reference);
+        }
+    }
+    check(basic, reference);
+    check(optimized, reference);
+    assert(basic.delete_range(std::numeric_limits<int>::min(), std::numeric_limits<int>::max()) == (int)reference.size());
+    assert(basic.size() == 0);
+    basic.put(1, 1);
+    assert(basic.size() == 1 && basic.rank(1) == 0);
+
+    // 范围分片
+    ShardedSkipList<int, int, NullLogger> sharded({1000, 2000, 3000}, 16, 4);
+    for (int i = 0; i < 4000; i++) {
+        sharded.put(i, i);
+    }
+    assert(sharded.delete_range(500, 3499) == 3000);
+    assert(sharded.size() == 1000 && sharded.count_range(0, 3999) == 1000);
+    std::cout << "✓ 区间删除结果、排名与 std::map 一致" << std::endl;
+
+    // 并发：读线程持续扫描和查询，写线程反复整段删除再导入，读者看到的始终有序
+    SkipListOptimized<int, int, NullLogger> shared(16, 16);
+    std::vector<std::pair<int, int>> batch;
+    for (int i = 0; i < 20000; i++) {
+        batch.push_back(std::make_pair(i, i));
+    }
+    shared.bulk_load(batch.begin(), batch.end());
+    std::atomic<bool> stop(false);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 2; t++) {
+        readers.emplace_back([&shared, &stop, t]() {
+            int key = t;
+            while (!stop.load()) {
+                auto cursor = shared.cursor();
+                int previous = -1;
+                for (cursor.seek(key % 20000); cursor.valid() && cursor.key() < key % 20000 + 2000; cursor.next()) {
+                    assert(cursor.key() > previous);
+                    previous = cursor.key();
+                }
+                shared.search_element_silent(key % 20000);
+                key += 7919;
+            }
+        });
+    }
+    for (int round = 0; round < 200; round++) {
+        int lo = (round * 3571) % 18000;
+        shared.delete_range(lo, lo + 1999);
+        shared.bulk_load(batch.begin() + lo, batch.begin() + lo + 2000);
+    }
+    stop = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    assert(shared.size() == 20000);
+    std::cout << "✓ 并发读取下反复范围删除、导入" << std::endl;
+
+    // 性能：逐个 delete_element vs delete_range，删除 50 万个连续 key
+    const int n = 1000000;
+    std::vector<std::pair<int, int>> entries(n);
+    for (int i = 0; i < n; i++) {
+        entries[i] = std::make_pair(i, i);
+    }
+    auto timed = [](auto&& action) {
+        auto start = std::chrono::high_resolution_clock::now();
+        action();
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::high_resolution_clock::now() - start).count();
+    };
+    SkipList<int, int, NullLogger> basic_each(20), basic_range(20);
+    SkipListOptimized<int, int, NullLogger> optimized_each(20, 16), optimized_range(20, 16);
+    basic_each.bulk_load(entries.begin(), entries.end());
+    basic_range.bulk_load(entries.begin(), entries.end());
+    optimized_each.bulk_load(entries.begin(), entries.end());
+    optimized_range.bulk_load(entries.begin(), entries.end());
+    auto basic_each_us = timed([&]() {
+        for (int i = n / 4; i < n / 4 * 3; i++) {
+            basic_each.delete_element(i);
+        }
+    });
+    auto basic_range_us = timed([&]() { basic_range.delete_range(n / 4, n / 4 * 3 - 1); });
+    auto optimized_each_us = timed([&]() {
+        for (int i = n / 4; i < n / 4 * 3; i++) {
+            optimized_each.delete_element(i);
+        }
+    });
+    auto optimized_range_us = timed([&]() { optimized_range.delete_range(n / 4, n / 4 * 3 - 1); });
+    assert(basic_each.size() == n / 2 && basic_range.size() == n / 2);
+    assert(optimized_each.size() == n / 2 && optimized_range.size() == n / 2);
+    assert(optimized_range.rank(n / 4 * 3) == n / 4);
+    std::cout << "从 " << n << " 个元素中删除 " << n / 2 << " 个连续 key:" << std::endl;
+    std::cout << "  基础版 逐个 delete_element / delete_range: " << basic_each_us / 1000 << " ms / "
+              << basic_range_us / 1000 << " ms（含释放节点）" << std::endl;
+    std::cout << "  优化版 逐个 delete_element / delete_range: " << optimized_each_us / 1000 << " ms / "
+              << optimized_range_us << " us（节点整段退休）" << std::endl;
+
+    // 持锁时间：摘下的 50 万个节点在之后某次删除离开临界区时归还内存池，此时段写锁和层级锁已释放，
+    // 内存池锁也只分批短暂持有。另一个写线程持续写入并记录单次最长耗时，应远小于整段归还所花的时间
+    // （若在锁内归还，两者相当）
+    std::atomic<bool> probing(true);
+    std::atomic<long long> probe_max_us(0);
+    std::thread probe([&]() {
+        long long worst = 0;
+        for (int i = 0; probing.load(); i++) {
+            int key = n + i % 1000;
+            worst = std::max(worst, (long long)timed([&]() { optimized_range.put(key, i); }));
+        }
+        probe_max_us = worst;
+    });
+    long long delete_max_us = 0;
+    for (int i = 0; i < n / 4; i += 64) {
+        delete_max_us = std::max(delete_max_us, (long long)timed([&]() { optimized_range.delete_element(i); }));
+    }
+    probing = false;
+    probe.join();
+    std::cout << "  整段归还期间: 最慢一次 delete_element（含锁外回收）" << delete_max_us
+              << " us，并发写入最长等待 " << probe_max_us.load() << " us" << std::endl;
+    assert(probe_max_us.load() * 2 < delete_max_us);
+}
+
 // 功能测试
 void test_basic_functions() {
     std::cout << "\n========== 基本功能演示 ==========" << std::endl;
@@ -249,15 +2239,71 @@ int main() {
     test_original_insert();
     test_optimized_insert();
     
-    // 多线程插入性能对比（原版跳表可能不支持多线程，跳过）
-    std::cout << "\n========== 原版跳表多线程插入测试 ==========" << std::endl;
-    std::cout << "（原版跳表多线程支持有问题，已跳过）" << std::endl;
+    // 多线程插入性能对比（原版跳表为实例级锁，所有写入串行）
+    test_original_concurrent_insert();
     
     test_optimized_concurrent_insert();
     
     // 多线程查询性能测试
     test_optimized_concurrent_search();
     
+    // 游标测试
+    test_cursor();
+    
+    // 排名查询测试
+    test_rank_queries();
+    
+    // 单次下降写接口测试
+    test_write_apis();
+    
+    // 批量查找性能测试
+    test_multi_get_throughput();
+    
+    // 移动写入与原地读取测试
+    test_move_aware_values();
+    
+    // 日志策略测试
+    test_log_policies();
+    
+    // 锁策略测试
+    test_lock_policies();
+    
+    // 分段读写锁测试
+    test_segment_locks();
+    
+    // 范围分片跳表测试
+    test_sharded_skiplist();
+    
+    // 分片计数器测试
+    test_sharded_counter();
+    
+    // 内存池线程弹匣测试
+    test_memory_pool_magazines();
+    
+    // slab 分配器测试
+    test_slab_arena();
+    
+    // 内存预算与收缩测试
+    test_memory_budget();
+    
+    // 大跳表析构测试
+    test_teardown();
+    
+    // 随机层级生成器测试
+    test_random_level();
+    
+    // finger 查找测试
+    test_finger_search();
+    
+    // 有序批量导入测试
+    test_bulk_load();
+    
+    // 降序扫描测试
+    test_descending_scans();
+    
+    // 范围删除测试
+    test_delete_range();
+    
     std::cout << "\n======================================" << std::endl;
     std::cout << "  测试完成！" << std::endl;
     std::cout << "======================================" << std::endl;
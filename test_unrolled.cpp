@@ -0,0 +1,236 @@
+/* ************************************************************************
+> File Name:     test_unrolled.cpp
+> Description:   展开跳表测试程序
+>                1. SIMD 查找内核与 std::lower_bound 对照
+>                2. 基本功能与节点分裂/摘除
+>                3. 随机增删与 std::map 对照校验
+>                4. 与单 key 节点跳表的点查询、范围查询性能对比
+ ************************************************************************/
+
+#include <iostream>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <sstream>
+#include <cassert>
+#include <cstdlib>
+#include <algorithm>
+#include <string>
+#include "skiplist_optimized.h"
+#include "skiplist_unrolled.h"
+#include "simd_search.h"
+
+#define TEST_COUNT 500000
+#define QUERY_COUNT 1000000
+
+// 用于临时禁用 cout 输出的工具类
+class CoutRedirect {
+private:
+    std::streambuf* old_buf;
+    std::ostringstream null_stream;
+public:
+    CoutRedirect() {
+        old_buf = std::cout.rdbuf();
+        std::cout.rdbuf(null_stream.rdbuf());
+    }
+    ~CoutRedirect() {
+        std::cout.rdbuf(old_buf);
+    }
+};
+
+// 随机有序数组上对照 std::lower_bound，覆盖向量块和标量尾部
+template<typename K>
+void check_lower_bound(int max_count) {
+    for (int count = 0; count <= max_count; count++) {
+        std::vector<K> keys(count);
+        for (int i = 0; i < count; i++) {
+            keys[i] = static_cast<K>(rand() % 200 - 100);
+        }
+        std::sort(keys.begin(), keys.end());
+        for (int probe = -110; probe <= 110; probe++) {
+            K key = static_cast<K>(probe);
+            int expected = std::lower_bound(keys.begin(), keys.end(), key) - keys.begin();
+            assert(key_lower_bound(keys.data(), count, key) == expected);
+        }
+    }
+}
+
+void test_simd_kernels() {
+    std::cout << "\n========== SIMD 查找内核 ==========" << std::endl;
+    std::cout << "int32 向量化: " << (KeySearchTraits<int>::vectorized ? "是" : "否")
+              << ", int64 向量化: " << (KeySearchTraits<long long>::vectorized ? "是" : "否") << std::endl;
+
+    srand(7);
+    check_lower_bound<int>(40);
+    check_lower_bound<long long>(40);
+    check_lower_bound<long>(40);
+    check_lower_bound<short>(40);
+
+    std::vector<std::string> words = {"apple", "banana", "cherry", "grape", "melon"};
+    assert(key_lower_bound(words.data(), 5, std::string("cherry")) == 2);
+    assert(key_lower_bound(words.data(), 5, std::string("coconut")) == 3);
+    assert(key_lower_bound(words.data(), 5, std::string("zucchini")) == 5);
+
+    std::cout << "✓ SIMD 查找内核测试通过" << std::endl;
+}
+
+// 基本功能
+void test_unrolled_basic() {
+    std::cout << "\n========== 展开跳表基本功能 ==========" << std::endl;
+    SkipListUnrolled<int, std::string, 4> skipList(6);
+
+    assert(skipList.insert_element(5, "five") == 0);
+    assert(skipList.insert_element(1, "one") == 0);
+    assert(skipList.insert_element(9, "nine") == 0);
+    assert(skipList.insert_element(3, "three") == 0);
+    assert(skipList.insert_element(7, "seven") == 0);      // 触发分裂
+    assert(skipList.insert_element(0, "zero") == 0);       // 小于所有节点最小 key
+    assert(skipList.insert_element(7, "seven again") == 1);
+    assert(skipList.size() == 6);
+    assert(skipList.node_count() >= 2);
+
+    assert(skipList.search_element(7));
+    assert(!skipList.search_element(8));
+
+    skipList.delete_element(3);
+    skipList.delete_element(4);
+    assert(skipList.size() == 5);
+    assert(!skipList.search_element_silent(3));
+
+    auto result = skipList.range_query(1, 7);
+    assert(result.size() == 3);
+    assert(result[0].first == 1 && result[1].first == 5 && result[2].first == 7);
+    assert(result[2].second == "seven");
+
+    skipList.display_list();
+
+    // 全部删除后节点应被摘除
+    int keys[] = {0, 1, 5, 7, 9};
+    for (int key : keys) {
+        skipList.delete_element(key);
+    }
+    assert(skipList.size() == 0);
+    assert(skipList.node_count() == 0);
+    assert(skipList.range_query(0, 100).empty());
+    assert(skipList.insert_element(42, "answer") == 0);
+    assert(skipList.search_element_silent(42));
+
+    std::cout << "✓ 展开跳表基本功能测试通过" << std::endl;
+}
+
+// 随机增删，与 std::map 对照
+void test_unrolled_against_map() {
+    std::cout << "\n========== 展开跳表随机对照 ==========" << std::endl;
+    SkipListUnrolled<int, int, 8> skipList(12);
+    std::map<int, int> reference;
+
+    srand(12345);
+    for (int i = 0; i < 200000; i++) {
+        int key = rand() % 5000;
+        if (rand() % 3 == 0) {
+            skipList.delete_element(key);
+            reference.erase(key);
+        } else {
+            int expected = reference.count(key) ? 1 : 0;
+            assert(skipList.insert_element(key, i) == expected);
+            reference.insert(std::make_pair(key, i));
+        }
+    }
+
+    assert(skipList.size() == (int)reference.size());
+    for (int key = 0; key < 5000; key++) {
+        assert(skipList.search_element_silent(key) == (reference.count(key) == 1));
+    }
+
+    auto result = skipList.range_query(1000, 3999);
+    auto it = reference.lower_bound(1000);
+    for (auto& entry : result) {
+        assert(it != reference.end());
+        assert(entry.first == it->first && entry.second == it->second);
+        ++it;
+    }
+    assert(it == reference.upper_bound(3999));
+
+    std::cout << "元素数: " << skipList.size() << ", 节点数: " << skipList.node_count()
+              << ", 平均填充: " << (double)skipList.size() / skipList.node_count() << std::endl;
+    std::cout << "✓ 展开跳表随机对照测试通过" << std::endl;
+}
+
+// 点查询、范围查询性能对比
+void test_lookup_performance() {
+    std::cout << "\n========== 点查询/范围查询性能对比 ==========" << std::endl;
+    SkipListOptimized<int, int> optimized(18);
+    SkipListUnrolled<int, int> unrolled(18);
+
+    std::vector<int> keys(TEST_COUNT);
+    for (int i = 0; i < TEST_COUNT; i++) {
+        keys[i] = i;
+    }
+    srand(2024);
+    for (int i = TEST_COUNT - 1; i > 0; i--) {
+        std::swap(keys[i], keys[rand() % (i + 1)]);
+    }
+
+    {
+        CoutRedirect redirect;
+        for (int key : keys) {
+            optimized.insert_element(key, key);
+            unrolled.insert_element(key, key);
+        }
+    }
+    std::cout << "展开跳表节点数: " << unrolled.node_count() << " (元素数 " << unrolled.size() << ")" << std::endl;
+
+    long long hits = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < QUERY_COUNT; i++) {
+        hits += optimized.search_element_silent(keys[i % TEST_COUNT]);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    auto optimized_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < QUERY_COUNT; i++) {
+        hits += unrolled.search_element_silent(keys[i % TEST_COUNT]);
+    }
+    end = std::chrono::high_resolution_clock::now();
+    auto unrolled_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    assert(hits == 2LL * QUERY_COUNT);
+
+    std::cout << "点查询 " << QUERY_COUNT << " 次:" << std::endl;
+    std::cout << "  单 key 节点: " << optimized_ms << " ms" << std::endl;
+    std::cout << "  展开节点:   " << unrolled_ms << " ms" << std::endl;
+
+    // 范围查询：每次读取 1000 个连续 key
+    const int range_count = 1000;
+    size_t total = 0;
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < range_count; i++) {
+        int low = keys[i];
+        total += unrolled.range_query(low, low + 999).size();
+    }
+    end = std::chrono::high_resolution_clock::now();
+    auto range_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    assert(total > 0);
+    std::cout << "范围查询 " << range_count << " 次 (宽度 1000): " << range_ms << " ms" << std::endl;
+
+    if (optimized_ms > 0) {
+        std::cout << "点查询加速比: " << (double)optimized_ms / (unrolled_ms > 0 ? unrolled_ms : 1) << "x" << std::endl;
+    }
+}
+
+int main() {
+    std::cout << "========================================" << std::endl;
+    std::cout << "        展开跳表测试程序" << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    test_simd_kernels();
+    test_unrolled_basic();
+    test_unrolled_against_map();
+    test_lookup_performance();
+
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "        测试完成" << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    return 0;
+}